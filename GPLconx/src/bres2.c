@@ -22,36 +22,267 @@
 #endif
 
 #include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #include "point.h"
 #include "viewer.h"
 #include "util.h"
 #include "bresint.h"
 
-static ConxDirection conx_compass_opposite(ConxDirection d);
+/* How conx_bresenham and conx_bresenham_batch trace a branch.  Exactly one
+   of bres_trace and bbres_trace is non-NULL. */
+typedef struct BresTracer {
+  ConxBresTraceFunc *bres_trace;       /* called with func */
+  ConxBatchBresTraceFunc *bbres_trace; /* called with bfunc */
+  ConxMetric *func;
+  ConxBatchMetric *bfunc;
+  void *fArg;
+  BresMemo *memo;                      /* NULL until bresenham_branch */
+  ConxContinueFunc *keepgoing;
+  void *kArg;
+} BresTracer;
+
 static const char *conx_direction2string(ConxDirection a);
 static
 void conx_bres_tracebranch(ConxDirection last, Pt middle, double dw,
-                           double dh, ConxMetric *func, void *fArg,
-                           ConxContinueFunc *keepgoing, void *kArg,
-                           ConxBresTraceFunc *bres_trace);
+                           double dh, const BresTracer *tracer);
 static
-ConxDirection conx_startpoint(Pt LB, double dw, double dh, ConxMetric *func,
-                              void *fArg);
-static inline
-double func_in_direction(Pt current_location, ConxDirection testdir,
-                         double dw, double dh, ConxMetric *func, void *fArg);
+ConxDirection conx_startpoint(Pt LB, double dw, double dh,
+                              ConxBatchMetric *func, void *fArg);
+static
+void funcs_in_directions(Pt current_location, const ConxDirection *testdirs,
+                         size_t n, double dw, double dh,
+                         ConxBatchMetric *func, void *fArg, double *f);
+
+
+
+static void bres_table_init(BresTable *t)
+{
+  t->size = BRES_TABLE_INITIAL;
+  t->n = 0;
+  t->tab = (BresEntry *) calloc(t->size, sizeof(BresEntry));
+  CHECK_OOM(t->tab, "bres_table_init");
+}
+
+static BresEntry *bres_table_slot(const BresTable *t, long i, long j)
+/* Returns the entry for (i, j), which is unused if (i, j) is not in t. */
+{
+  size_t k = ((size_t) i * 73856093UL ^ (size_t) j * 19349663UL)
+    & (t->size - 1);
 
+  while (t->tab[k].used && (t->tab[k].i != i || t->tab[k].j != j))
+    k = (k + 1) & (t->size - 1);
+  return &t->tab[k];
+}
 
+static BresEntry *bres_table_insert(BresTable *t, long i, long j)
+/* Returns the entry for (i, j), adding it to t if need be.  The entry is
+   good until the next insertion. */
+{
+  BresEntry *e, *old;
+  size_t k, oldsize;
+
+  if (2 * (t->n + 1) > t->size) {
+    old = t->tab;
+    oldsize = t->size;
+    t->size *= 2;
+    t->tab = (BresEntry *) calloc(t->size, sizeof(BresEntry));
+    CHECK_OOM(t->tab, "bres_table_insert");
+    for (k = 0; k < oldsize; k++) {
+      if (old[k].used) *bres_table_slot(t, old[k].i, old[k].j) = old[k];
+    }
+    free(old);
+  }
+  e = bres_table_slot(t, i, j);
+  if (!e->used) {
+    e->used = 1;
+    e->i = i;
+    e->j = j;
+    ++t->n;
+  }
+  return e;
+}
 
-double func_in_direction(Pt current_location, ConxDirection testdir,
-                         double dw, double dh, ConxMetric *func, void *fArg)
-/* Returns the value of the metric for the point adjacent to current_location
-   in the testdir direction.
+void conx_bres_memo_init(BresMemo *m, ConxBatchMetric *func, void *fArg,
+                         Pt origin, double dw, double dh)
+/* Makes *m an empty memo of *func for the branch through origin. */
+{
+  m->func = func;
+  m->fArg = fArg;
+  m->origin = origin;
+  m->dw = dw;
+  m->dh = dh;
+  bres_table_init(&m->values);
+  bres_table_init(&m->visits);
+  m->direction = -1;
+  m->hits = m->emitted = 0;
+}
+
+void conx_bres_memo_free(BresMemo *m)
+{
+  free(m->values.tab);
+  free(m->visits.tab);
+}
+
+static void bres_memo_key(const BresMemo *m, double x, double y,
+                          long *i, long *j)
+{
+  *i = (long) floor((x - m->origin.x) / m->dw + 0.5);
+  *j = (long) floor((y - m->origin.y) / m->dh + 0.5);
+}
+
+void conx_bres_memo_emit(BresMemo *m, Pt middle)
+/* Records that the current direction drew middle. */
+{
+  long i, j;
+  BresEntry *e;
+
+  bres_memo_key(m, middle.x, middle.y, &i, &j);
+  e = bres_table_insert(&m->visits, i, j);
+  if (e->owner == 0) {
+    e->owner = 1 + m->direction;
+    e->step = m->emitted;
+  }
+  ++m->emitted;
+}
+
+static int bres_near(const BresMemo *m, long i, long j, int except)
+/* Returns nonzero if (i, j) or a neighbor was drawn by a direction other
+   than direction except - 1. */
+{
+  long di, dj;
+  const BresEntry *e;
+
+  for (di = -1; di <= 1; di++) {
+    for (dj = -1; dj <= 1; dj++) {
+      e = bres_table_slot(&m->visits, i + di, j + dj);
+      if (e->used && e->owner != except) return 1;
+    }
+  }
+  return 0;
+}
+
+int conx_bres_memo_closes(const BresMemo *m, Pt middle, int *left)
+/* Returns nonzero if the current direction, having moved to middle, should
+   stop because the curve has closed up: either middle is next to the start
+   point and we have been farther away (*left is nonzero), or middle is at
+   or next to a point that the other direction drew, or we drew middle
+   already.  The last catches a direction that goes around a small closed
+   curve without passing next to the start point. */
+{
+  long i, j;
+
+  bres_memo_key(m, middle.x, middle.y, &i, &j);
+  if (i >= -1 && i <= 1 && j >= -1 && j <= 1) {
+    if (*left) return 1;
+  } else {
+    *left = 1;
+    if (bres_near(m, i, j, 1 + m->direction)) return 1;
+  }
+  return bres_table_slot(&m->visits, i, j)->used;
+}
+
+int conx_bres_memo_drawn(const BresMemo *m, Pt P)
+/* Returns nonzero if P or a neighbor has been drawn. */
+{
+  long i, j;
+
+  bres_memo_key(m, P.x, P.y, &i, &j);
+  return bres_near(m, i, j, 0);
+}
+
+void conx_bres_memo_stats(const BresMemo *m, ConxBresStats *stats)
+/* Adds what m saw to *stats. */
+{
+  stats->hits += m->hits;
+  stats->emitted += m->emitted;
+  stats->unique += m->visits.n;
+}
+
+int conx_bres_memo_lookup(BresMemo *m, double x, double y, double *f,
+                          long *i, long *j)
+/* Returns nonzero, having set *f to the metric at (x, y), if it is in the
+   memo.  Otherwise sets (*i, *j) to the key for conx_bres_memo_store. */
+{
+  const BresEntry *e;
+
+  bres_memo_key(m, x, y, i, j);
+  e = bres_table_slot(&m->values, *i, *j);
+  if (!e->used) return 0;
+  *f = e->f;
+  ++m->hits;
+  return 1;
+}
+
+void conx_bres_memo_store(BresMemo *m, long i, long j, double f)
+{
+  bres_table_insert(&m->values, i, j)->f = f;
+}
+
+static void bres_memo_metric(const double *x, const double *y, double *f,
+                             size_t n, void *t)
+/* A ConxBatchMetric that evaluates the memo's metric, in one call, at only
+   those points not already in the memo. */
+{
+  BresMemo *m = (BresMemo *) t;
+  double mx[NUM_DIRECS], my[NUM_DIRECS], mf[NUM_DIRECS];
+  long mi[NUM_DIRECS], mj[NUM_DIRECS];
+  size_t which[NUM_DIRECS], k, c, misses;
+
+  for (c = 0; c < n; c += NUM_DIRECS) {
+    misses = 0;
+    for (k = c; k < n && k < c + NUM_DIRECS; k++) {
+      if (!conx_bres_memo_lookup(m, x[k], y[k], &f[k],
+                                 &mi[misses], &mj[misses])) {
+        mx[misses] = x[k];
+        my[misses] = y[k];
+        which[misses++] = k;
+      }
+    }
+    if (misses == 0) continue;
+    (*m->func)(mx, my, mf, misses, m->fArg);
+    for (k = 0; k < misses; k++) {
+      f[which[k]] = mf[k];
+      conx_bres_memo_store(m, mi[k], mj[k], mf[k]);
+    }
+  }
+}
+
+static double bres_memo_point_metric(Pt p, void *t)
+/* bres_memo_metric as a ConxMetric */
+{
+  double f;
+
+  bres_memo_metric(&p.x, &p.y, &f, 1, t);
+  return f;
+}
+
+void funcs_in_directions(Pt current_location, const ConxDirection *testdirs,
+                         size_t n, double dw, double dh,
+                         ConxBatchMetric *func, void *fArg, double *f)
+/* Sets f[i] to the absolute value of the metric for the point adjacent to
+   current_location in the testdirs[i] direction, 0 <= i < n <= NUM_DIRECS.
+   The metric is called once for all n points.
 */
 {
-  MOVE_POINT(&current_location, testdir, dw, dh);
-  return func(current_location, fArg);
+  double x[NUM_DIRECS], y[NUM_DIRECS];
+  Pt adjacent;
+  size_t i;
+
+  assert(n <= NUM_DIRECS);
+  for (i = 0; i < n; i++) {
+    adjacent = current_location;
+    MOVE_POINT(&adjacent, testdirs[i], dw, dh);
+    x[i] = adjacent.x;
+    y[i] = adjacent.y;
+  }
+  (*func)(x, y, f, n, fArg);
+  for (i = 0; i < n; i++)
+    f[i] = myabs(f[i]);
 }
 
 const char *conx_direction2string(ConxDirection a)
@@ -86,8 +317,8 @@ ConxDirection conx_compass_opposite(ConxDirection d)
   }
 }
 
-ConxDirection conx_startpoint(Pt LB, double dw, double dh, ConxMetric *func,
-                              void *fArg)
+ConxDirection conx_startpoint(Pt LB, double dw, double dh,
+                              ConxBatchMetric *func, void *fArg)
 /* Here we find the best direction to travel from LB so that we minimize
    the absolute value of
    func(the point adjacent to LB in the direction returned).
@@ -106,42 +337,120 @@ ConxDirection conx_startpoint(Pt LB, double dw, double dh, ConxMetric *func,
   }
 
 
-  double leastdistance;
-  ConxDirection dir, bestdir;
+  double leastdistance, f[NUM_DIRECS];
+  ConxDirection dir, bestdir, dirs[NUM_DIRECS];
 
   assert(func != NULL);
 
+  /* Evaluate all eight neighbors at once. */
+  for (dir = (ConxDirection) 0;
+       dir <= (ConxDirection) 7;
+       dir = (ConxDirection)(1 + (int) dir))
+    dirs[dir] = dir;
+  funcs_in_directions(LB, dirs, NUM_DIRECS, dw, dh, func, fArg, f);
+
   /* We have to have a king to dethrone.  We will arbitrarily choose
      0 (CXD_NW, but that's unimportant) to begin.
   */
   dir = (ConxDirection) 0;
-  leastdistance = myabs(func_in_direction(LB, dir, dw, dh, func, fArg));
+  leastdistance = f[dir];
   bestdir = dir;
 
 #ifdef DLC
   /* DLC debug only */
   printf("func==%p;\nfunc(" DOF ", " DOF ")=" DOF "\n", (void *)func, LB.x,
-         LB.y, myabs(func_in_direction(LB, dir, dw, dh, func, fArg)));
+         LB.y, f[dir]);
 
   for (dir = 0; dir <= 7; dir++) {
-    printf("func(LB+%s)=" DOF "\n", conx_direction2string(dir),
-           myabs(func_in_direction(LB, dir, dw, dh, func, fArg)));
+    printf("func(LB+%s)=" DOF "\n", conx_direction2string(dir), f[dir]);
   }
 #endif
 
   for (dir = (ConxDirection) 1;
        dir <= (ConxDirection) 7;
        dir = (ConxDirection)(1 + (int) dir)) {
-    HOLD_MINIMUM(&leastdistance,
-                 myabs(func_in_direction(LB, dir, dw, dh, func, fArg)),
-                 &bestdir, dir);
+    HOLD_MINIMUM(&leastdistance, f[dir], &bestdir, dir);
   }
   return bestdir;
 }
 
 void conx_bres_trace(Pt middle, ConxDirection last, double dw, double dh,
-                     ConxMetric *func, void *fArg, ConxContinueFunc *keepgoing,
-                     void *kArg, ConxPointFunc *pfunc, void *pArg)
+                     ConxMetric *func, void *fArg, ConxBresMemo *memo,
+                     ConxContinueFunc *keepgoing, void *kArg,
+                     ConxPointFunc *pfunc, void *pArg)
+/* Like conx_bres_trace_batch, but *func is given one point at a time. */
+{
+  ConxMetricAdapter a;
+
+  a.func = func;
+  a.fArg = fArg;
+  conx_bres_trace_batch(middle, last, dw, dh, conx_batch_of_metric, &a,
+                        memo, keepgoing, kArg, pfunc, pArg);
+}
+
+void conx_bres_trace_batch(Pt middle, ConxDirection last,
+                           double dw, double dh,
+                           ConxBatchMetric *func, void *fArg,
+                           ConxBresMemo *memo,
+                           ConxContinueFunc *keepgoing, void *kArg,
+                           ConxPointFunc *pfunc, void *pArg)
+/* Like conx_bres_trace_sink, but (*pfunc)(x, y, pArg) is called for each
+   point. */
+{
+  Pt pts[CONX_SINK_SIZE];
+  ConxPointFuncAdapter a;
+  ConxVertexSink sink;
+
+  a.pfunc = pfunc;
+  a.pArg = pArg;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_points_of_batch, &a);
+  conx_bres_trace_sink(middle, last, dw, dh, func, fArg, memo, keepgoing, kArg,
+                       &sink);
+}
+
+static void bres_move(Pt *middle, ConxDirection *last, double dw, double dh,
+                      ConxBatchMetric *func, void *fArg)
+/* Moves *middle to whichever of its neighbors in the direction of *last,
+   or in a direction either side of it, is nearest the curve, and sets
+   *last to the direction moved.  *func is called once for all three
+   candidates. */
+{
+#define NUM_ADJ_POINTS 3
+  double next[NUM_DIRECS], f[NUM_ADJ_POINTS];
+  ConxDirection directions[NUM_ADJ_POINTS];
+  int i;
+
+  /* We are at middle.x; see where we should go next.
+     For example, if we just went north (i.e., *last==CXD_N), then
+     see if we should next go CXD_N, CXD_NW, or CXD_NE.
+  */
+  FILL_DIRECTIONS3(*last, directions);
+
+  funcs_in_directions(*middle, directions, NUM_ADJ_POINTS, dw, dh,
+                      func, fArg, f);
+  for (i = 0; i < NUM_ADJ_POINTS; i++)
+    next[directions[i]] = f[i];
+
+  ALT_GET_MINDIR3(last, next, directions);
+
+  LOGGG5(LOGG_BRES2, "\nMoving from (" DOF ", " DOF ") in direction %s "
+         "since F(%s)\n    = " DOF ", ", middle->x, middle->y,
+         conx_direction2string(*last),
+         conx_direction2string(directions[0]), next[directions[0]]);
+  LOGGG5(LOGG_BRES2, "F(%s)= " DOF ", and F(%s)= " DOF " (min " DOF ")",
+         conx_direction2string(directions[1]), next[directions[1]],
+         conx_direction2string(directions[2]), next[directions[2]],
+         next[*last]);
+
+  MOVE_POINT(middle, *last, dw, dh);
+}
+
+void conx_bres_trace_sink(Pt middle, ConxDirection last,
+                          double dw, double dh,
+                          ConxBatchMetric *func, void *fArg,
+                          ConxBresMemo *memo,
+                          ConxContinueFunc *keepgoing, void *kArg,
+                          ConxVertexSink *sink)
 /* We trace a curve from a point going in one direction until we fall off
    the edge of the visualized world.  We are following local minima rather
    than finding zeroes by scan lines because we have well-behaved curves.
@@ -149,96 +458,58 @@ void conx_bres_trace(Pt middle, ConxDirection last, double dw, double dh,
    northwest, or northeast.  (We definitely do not want to retrace our last
    move, but checking five points rather than three might be prudent. -- DLC)
 
-   When a point on the curve is found, (*pfunc)(x, y) is called.
+   When a point on the curve is found, it goes into *sink, which we flush
+   before returning.
+
+   If memo is not NULL, it is the memo that conx_bresenham gave its tracer
+   along with func and fArg.  We record in it what we draw, and we stop
+   where the curve closes up, before drawing any point twice.
 */
 {
-/* Set *mindirptr to x, if array[x] is the minimum among
-    { array[dir1], array[dir2], array[dir3] }
-*/
-#define GET_MINDIR3(mdp, array, dir1, dir2, dir3) \
-   if ((array)[dir1] < (array)[dir2]) { \
-     /* not dir2 */ \
-     if ((array)[dir1] < (array)[dir3]) *(mdp)=dir1; else *(mdp)=dir3; \
-   } else { \
-     /* not dir1 */ \
-     if ((array)[dir3] < (array)[dir2]) *(mdp)=dir3; else *(mdp)=dir2; \
-   }
-
-/* Set *mindirptr to x, if array[x] is the minimum among
-   { array[direcarray[0]], array[direcarray[1]], array[direcarray[2]] }
-*/
-#define ALT_GET_MINDIR3(mindirptr, array, direcarray) \
-  GET_MINDIR3(mindirptr, array, \
-              (direcarray)[0], (direcarray)[1], (direcarray)[2])
-
-#define FILL_DIRECTIONS3(lastdir, direcarray) \
-  { \
-    (direcarray)[0] = (lastdir); \
-    switch ((lastdir)) { \
-    case CXD_SE: (direcarray)[1] = CXD_S;  (direcarray)[2] = CXD_E; break; \
-    case CXD_S:  (direcarray)[1] = CXD_SE; (direcarray)[2] = CXD_SW; break; \
-    case CXD_NW: (direcarray)[1] = CXD_N;  (direcarray)[2] = CXD_W; break; \
-    case CXD_N:  (direcarray)[1] = CXD_NW; (direcarray)[2] = CXD_NE; break; \
-    case CXD_SW: (direcarray)[1] = CXD_S;  (direcarray)[2] = CXD_W; break; \
-    case CXD_W:  (direcarray)[1] = CXD_NW; (direcarray)[2] = CXD_SW; break; \
-    case CXD_NE: (direcarray)[1] = CXD_E;  (direcarray)[2] = CXD_N; break; \
-    default: assert((lastdir) == CXD_E); \
-                 (direcarray)[1] = CXD_NE; (direcarray)[2] = CXD_SE; break; \
-    } \
-  }
-
-
-  double next[NUM_DIRECS];
   Pt oldmiddle;
-  int count=0, i;
-
-#define NUM_ADJ_POINTS 3
-  ConxDirection directions[NUM_ADJ_POINTS];
-    /* We check three adjacent points currently. */
+  int count=0, left=0;
 
   oldmiddle=middle;
 
-  (*pfunc)(middle.x, middle.y, pArg);
+  if (memo != NULL) {
+    ++memo->direction;
+    conx_bres_memo_emit(memo, middle);
+  }
+  CONX_SINK_VERTEX(sink, middle.x, middle.y);
 
   do {
-    /* We are at middle.x; see where we should go next.
-       For example, if we just went north (i.e., last==CXD_N), then
-       see if we should next go CXD_N, CXD_NW, or CXD_NE.
-    */
-    FILL_DIRECTIONS3(last, directions);
-
-    for (i = 0; i < NUM_ADJ_POINTS; i++) {
-      next[directions[i]]
-        = myabs(func_in_direction(middle, directions[i], dw, dh, func, fArg));
+    bres_move(&middle, &last, dw, dh, func, fArg);
+
+    if (memo != NULL) {
+      if (conx_bres_memo_closes(memo, middle, &left)) {
+        LOGGG2(LOGG_BRES2, "\nThe curve closes up at (" DOF ", " DOF ")\n",
+               middle.x, middle.y);
+        break;
+      }
+      conx_bres_memo_emit(memo, middle);
     }
-
-    ALT_GET_MINDIR3(&last, next, directions);
-
-    LOGGG5(LOGG_BRES2, "\nMoving from (" DOF ", " DOF ") in direction %s "
-           "since F(%s)\n    = " DOF ", ", middle.x, middle.y,
-           conx_direction2string(last),
-           conx_direction2string(directions[0]), next[directions[0]]);
-    LOGGG5(LOGG_BRES2, "F(%s)= " DOF ", and F(%s)= " DOF " (min " DOF ")",
-           conx_direction2string(directions[1]), next[directions[1]],
-           conx_direction2string(directions[2]), next[directions[2]],
-           next[last]);
-
-    MOVE_POINT(&middle, last, dw, dh);
-
-    (*pfunc)(middle.x, middle.y, pArg);
- } while ((*keepgoing)(middle, oldmiddle, kArg) && (++count<=15000));
+    CONX_SINK_VERTEX(sink, middle.x, middle.y);
+ } while ((*keepgoing)(middle, oldmiddle, kArg)
+          && (++count<=CONX_BRES_MAX_MOVES));
+  conx_sink_flush(sink);
 }
 
 void conx_bres_tracebranch(ConxDirection last, Pt middle, double dw,
-                           double dh, ConxMetric *func, void *fArg,
-                           ConxContinueFunc *keepgoing, void *kArg,
-                           ConxBresTraceFunc *bres_trace)
+                           double dh, const BresTracer *tracer)
 {
+#define TRACE_ONE(tr, middle, last, dw, dh) \
+  if ((tr)->bres_trace != NULL) \
+    (*(tr)->bres_trace)(middle, last, dw, dh, (tr)->func, (tr)->fArg, \
+                        (tr)->memo, (tr)->keepgoing, (tr)->kArg); \
+  else \
+    (*(tr)->bbres_trace)(middle, last, dw, dh, (tr)->bfunc, (tr)->fArg, \
+                         (tr)->memo, (tr)->keepgoing, (tr)->kArg)
+
   LOGGG0(LOGG_BRES2, "\nAbout to trace one branch of a conic section using "
          "the Bresenham method.\n");
 
   MOVE_POINT(&middle, last, dw, dh);
-  (*bres_trace)(middle, last, dw, dh, func, fArg, keepgoing, kArg);
+  TRACE_ONE(tracer, middle, last, dw, dh);
 
   last = conx_compass_opposite(last);
 
@@ -252,47 +523,389 @@ void conx_bres_tracebranch(ConxDirection last, Pt middle, double dw,
          "using the Bresenham method.\n");
 
   MOVE_POINT(&middle, last, dw, dh);
-  (*bres_trace)(middle, last, dw, dh, func, fArg, keepgoing, kArg);
+  TRACE_ONE(tracer, middle, last, dw, dh);
   /* now the other direction around, (DLC but from what point??) */
 
   LOGGG0(LOGG_BRES2, "\nDone tracing both branches of the conic section "
          "using the Bresenham method.\n");
 }
 
-void conx_bresenham(Pt LB, Pt RB, ConxMetric *func,
-                    void *fArg, double delta_x, double delta_y,
-                    ConxContinueFunc *keepgoing, void *kArg,
-                    ConxBresTraceFunc *bres_trace)
+static
+void bresenham_branch(BresMemo *memo, const BresTracer *tracer)
+/* Traces the branch through memo->origin with memo, a fresh memo of the
+   metric, standing in for the tracer's, and gives the tracer memo so that
+   it can see where the branch closes up. */
+{
+  ConxDirection last;
+  BresTracer t = *tracer;
+  Pt B = memo->origin;
+  double delta_x = memo->dw, delta_y = memo->dh;
+
+  t.fArg = t.memo = memo;
+  if (t.bfunc != NULL)
+    t.bfunc = bres_memo_metric;
+  else
+    t.func = bres_memo_point_metric;
+
+  /* Find an initial direction; trace the branch in one direction. */
+  last = conx_startpoint(B, delta_x, delta_y, bres_memo_metric, memo);
+  LOGGG3(LOGG_BRES2, "Start point: (" DOF ", " DOF ") will move in %s "
+         "direction", B.x, B.y, conx_direction2string(last));
+  conx_bres_tracebranch(last, B, delta_x, delta_y, &t);
+}
+
+static
+void bresenham(Pt LB, Pt RB, double delta_x, double delta_y,
+               const BresTracer *tracer, ConxBresStats *stats)
   /* LB and RB are points on the left and right branches, the same
      point iff the conic section has only one branch.
   */
 {
-  ConxDirection last;
+  ConxBresStats ignored;
+  ConxMetricAdapter a;
+  BresMemo left, right;
+  ConxBatchMetric *bfunc = tracer->bfunc;
+  void *bArg = tracer->fArg;
 
   assert(delta_x != 0.0); assert(delta_y != 0.0);
-  assert(keepgoing != NULL); assert(func != NULL);
+  assert(tracer->keepgoing != NULL);
+  assert(tracer->func != NULL || tracer->bfunc != NULL);
   LOGGG0(LOGG_TEXINFO, "\n@conx_bresenham\n");
 
   LOGGG4(LOGG_BRES2, "The two points are: (" DOF ", " DOF ") and (" DOF ", "
          DOF ")\n", LB.x, LB.y, RB.x, RB.y);
 
-  /* Find an initial direction; trace the branch in one direction. */
-  last = conx_startpoint(LB, delta_x, delta_y, func, fArg);
-  LOGGG3(LOGG_BRES2, "Start point: (" DOF ", " DOF ") will move in %s "
-         "direction", LB.x, LB.y, conx_direction2string(last));
-  conx_bres_tracebranch(last, LB, delta_x, delta_y, func, fArg, keepgoing,
-                        kArg, bres_trace);
+  if (bfunc == NULL) {
+    a.func = tracer->func;
+    a.fArg = tracer->fArg;
+    bfunc = conx_batch_of_metric;
+    bArg = &a;
+  }
 
-  /* If we have two distinct branches, then trace the other also. */
-  if ((RB.x != LB.x) || (RB.y != LB.y)) {
+  if (stats == NULL) stats = &ignored;
+  stats->hits = stats->emitted = stats->unique = 0;
+  conx_bres_memo_init(&left, bfunc, bArg, LB, delta_x, delta_y);
+  bresenham_branch(&left, tracer);
+  conx_bres_memo_stats(&left, stats);
+
+  /* If we have two distinct branches, then trace the other also.  An
+     ellipse has but one, though we are given a point on each side of it,
+     so we skip the second if we drew it with the first. */
+  if (((RB.x != LB.x) || (RB.y != LB.y)) && !conx_bres_memo_drawn(&left, RB)) {
     LOGGG0(LOGG_BRES2, "\nTracing distinct second branch of the conic; still "
            "in Bresenham.\n");
-    last = conx_startpoint(RB, delta_x, delta_y, func, fArg);
-    LOGGG3(LOGG_BRES2, "Start point: (" DOF ", " DOF ") will move in %s "
-           "direction", RB.x, RB.y, conx_direction2string(last));
-    conx_bres_tracebranch(last, RB, delta_x, delta_y, func, fArg, keepgoing,
-                          kArg, bres_trace);
+    conx_bres_memo_init(&right, bfunc, bArg, RB, delta_x, delta_y);
+    bresenham_branch(&right, tracer);
+    conx_bres_memo_stats(&right, stats);
+    conx_bres_memo_free(&right);
   }
+  conx_bres_memo_free(&left);
   LOGGG0(LOGG_TEXINFO, "\n@end conx_bresenham\n");
 }
 
+void conx_bresenham(Pt LB, Pt RB, ConxMetric *func,
+                    void *fArg, double delta_x, double delta_y,
+                    ConxContinueFunc *keepgoing, void *kArg,
+                    ConxBresTraceFunc *bres_trace, ConxBresStats *stats)
+  /* LB and RB are points on the left and right branches, the same
+     point iff the conic section has only one branch.
+
+     *bres_trace is not given func and fArg but a memo of them, so each
+     lattice point of a branch costs at most one evaluation.  It is also
+     given the memo itself, and if it passes that on to conx_bres_trace
+     then a closed branch is drawn once around rather than once per
+     direction.  If stats is not NULL, we set
+     *stats to say how many evaluations the memo saved and how many points
+     were drawn.
+  */
+{
+  BresTracer t;
+
+  assert(func != NULL); assert(bres_trace != NULL);
+  t.bres_trace = bres_trace;
+  t.bbres_trace = NULL;
+  t.func = func;
+  t.bfunc = NULL;
+  t.fArg = fArg;
+  t.memo = NULL;
+  t.keepgoing = keepgoing;
+  t.kArg = kArg;
+  bresenham(LB, RB, delta_x, delta_y, &t, stats);
+}
+
+void conx_bresenham_batch(Pt LB, Pt RB, ConxBatchMetric *func,
+                          void *fArg, double delta_x, double delta_y,
+                          ConxContinueFunc *keepgoing, void *kArg,
+                          ConxBatchBresTraceFunc *bres_trace,
+                          ConxBresStats *stats)
+/* Like conx_bresenham, but *func is given several points at a time. */
+{
+  BresTracer t;
+
+  assert(func != NULL); assert(bres_trace != NULL);
+  t.bres_trace = NULL;
+  t.bbres_trace = bres_trace;
+  t.func = NULL;
+  t.bfunc = func;
+  t.fArg = fArg;
+  t.memo = NULL;
+  t.keepgoing = keepgoing;
+  t.kArg = kArg;
+  bresenham(LB, RB, delta_x, delta_y, &t, stats);
+}
+
+/* One direction of one branch for conx_bresenham_threaded to trace */
+typedef struct BresHalf {
+  Pt start;                  /* the first point it draws */
+  Pt middle;
+  ConxDirection last;
+  int count, left;           /* as in conx_bres_trace_sink */
+  int done;                  /* nonzero once it has stopped */
+  BresMemo memo;             /* its metric and the points it has drawn */
+  ConxPtBuffer pts;
+} BresHalf;
+
+typedef struct BresHalves {
+  BresHalf half[4];
+  size_t nhalves;
+  size_t nworkers;
+  int go;                    /* nonzero once nworkers is settled */
+  ConxBatchMetric *func;
+  double dw, dh;
+  ConxContinueFunc *keepgoing;
+  void *kArg;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_t lock;      /* guards go and each half's done and memo */
+  pthread_cond_t moved;      /* a half drew a point or stopped */
+#endif
+} BresHalves;
+
+typedef struct BresWorker {
+  BresHalves *h;
+  void *fArg;
+  size_t index;              /* the first of the halves it traces */
+} BresWorker;
+
+#ifdef HAVE_PTHREAD_H
+#define BRES_LOCK(h) pthread_mutex_lock(&(h)->lock)
+#define BRES_UNLOCK(h) pthread_mutex_unlock(&(h)->lock)
+#define BRES_WAIT(h) pthread_cond_wait(&(h)->moved, &(h)->lock)
+#define BRES_BROADCAST(h) pthread_cond_broadcast(&(h)->moved)
+#else
+/* One worker traces every half, so nobody ever waits. */
+#define BRES_LOCK(h)
+#define BRES_UNLOCK(h)
+#define BRES_WAIT(h) FATAL("bres_meets")
+#define BRES_BROADCAST(h)
+#endif
+
+static int bres_meets(BresHalves *h, size_t k, Pt P)
+/* Returns nonzero if half k, having moved to P, meets a point drawn by the
+   other half of its branch or by a half of an earlier branch, and so
+   should stop.  So that where the halves meet does not depend on how the
+   threads are scheduled, its sth point meets only the first s+1 points of
+   the halves before it and the first s points of the halves after it,
+   and we wait for them to draw those.  The caller holds the lock. */
+{
+  const BresHalf *r;
+  const BresEntry *e;
+  size_t q, s = h->half[k].memo.emitted, need;
+  long i, j, di, dj, reach;
+
+  for (q = 0; q < h->nhalves; q++) {
+    if (q == k || q / 2 > k / 2) continue;
+    r = &h->half[q];
+    need = (q < k) ? s + 1 : s;
+    while (!r->done && r->memo.emitted < need)
+      BRES_WAIT(h);
+    bres_memo_key(&r->memo, P.x, P.y, &i, &j);
+    /* Next to the start point, as in conx_bres_memo_closes, we stop only
+       where the other half of the branch drew P itself. */
+    reach = (q / 2 == k / 2 && i >= -1 && i <= 1 && j >= -1 && j <= 1)
+      ? 0 : 1;
+    for (di = -reach; di <= reach; di++) {
+      for (dj = -reach; dj <= reach; dj++) {
+        e = bres_table_slot(&r->memo.visits, i + di, j + dj);
+        if (e->used && e->step < need) return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int bres_half_step(BresHalves *h, size_t k)
+/* Draws the next point of half k, as conx_bres_trace_sink would, and
+   returns nonzero, or returns zero if half k stops here. */
+{
+  BresHalf *half = &h->half[k];
+  BresMemo *m = &half->memo;
+  int meets;
+
+  if (m->emitted > 1
+      && !((*h->keepgoing)(half->middle, half->start, h->kArg)
+           && (++half->count <= CONX_BRES_MAX_MOVES)))
+    return 0;
+  if (m->emitted > 0) {
+    bres_move(&half->middle, &half->last, h->dw, h->dh, bres_memo_metric, m);
+    if (conx_bres_memo_closes(m, half->middle, &half->left)) return 0;
+  }
+  BRES_LOCK(h);
+  meets = (m->emitted > 0 && bres_meets(h, k, half->middle));
+  if (!meets) {
+    conx_bres_memo_emit(m, half->middle);
+    BRES_BROADCAST(h);
+  }
+  BRES_UNLOCK(h);
+  if (meets) return 0;
+  conx_ptbuf_append(half->middle.x, half->middle.y, &half->pts);
+  return 1;
+}
+
+static void *bres_worker(void *ww)
+/* Traces halves index, index + nworkers, ..., with this thread's fArg, a
+   point of each in turn until all have stopped. */
+{
+  BresWorker *w = (BresWorker *) ww;
+  BresHalves *h = w->h;
+  size_t k;
+  int going;
+
+  BRES_LOCK(h);
+  while (!h->go)
+    BRES_WAIT(h);
+  BRES_UNLOCK(h);
+  for (k = w->index; k < h->nhalves; k += h->nworkers)
+    h->half[k].memo.fArg = w->fArg;
+  do {
+    going = 0;
+    for (k = w->index; k < h->nhalves; k += h->nworkers) {
+      if (h->half[k].done) continue;
+      if (bres_half_step(h, k)) {
+        going = 1;
+      } else {
+        BRES_LOCK(h);
+        h->half[k].done = 1;
+        BRES_BROADCAST(h);
+        BRES_UNLOCK(h);
+      }
+    }
+  } while (going);
+  return NULL;
+}
+
+void conx_bresenham_threaded(Pt LB, Pt RB, ConxBatchMetric *func,
+                             void **fArgs, size_t nthreads,
+                             double delta_x, double delta_y,
+                             ConxContinueFunc *keepgoing, void *kArg,
+                             ConxVertexSink *sink, ConxBresStats *stats)
+/* Like conx_bresenham_batch with conx_bres_trace_batch as the tracer, but
+   the (up to four) directions of the branches are traced by up to nthreads
+   threads at once.  Thread k calls *func with fArgs[k], and *keepgoing
+   must be safe to call from several threads at once.  Each direction's
+   points are kept in its own buffer, and the buffers are given to *sink,
+   which we then flush, a branch at a time.
+
+   The directions see what the others have drawn.  Each stops where it
+   meets the other direction of its branch, so the two directions of a
+   closed curve meet about halfway around rather than the first going all
+   the way around as it does in conx_bresenham_batch, and where the
+   second branch meets the first, so that if the second is the first
+   again we give up on it early.  Open curves are drawn just as
+   conx_bresenham_batch draws them.  stats may be NULL. */
+{
+  BresHalves h;
+  BresHalf *half;
+  BresWorker w[4];
+  BresMemo m;
+  ConxBresStats ignored;
+  ConxDirection last;
+  Pt B[2], middle;
+  size_t b, i, k, nbranches, nworkers;
+#ifdef HAVE_PTHREAD_H
+  pthread_t tids[4];
+  int started[4];
+#endif
+
+  assert(func != NULL); assert(fArgs != NULL); assert(nthreads > 0);
+  assert(keepgoing != NULL); assert(sink != NULL);
+  assert(delta_x != 0.0); assert(delta_y != 0.0);
+  B[0] = LB;
+  B[1] = RB;
+  nbranches = ((RB.x != LB.x) || (RB.y != LB.y)) ? 2 : 1;
+
+  /* Find where each direction starts just as conx_bres_tracebranch does. */
+  h.nhalves = 0;
+  for (b = 0; b < nbranches; b++) {
+    last = conx_startpoint(B[b], delta_x, delta_y, func, fArgs[0]);
+    middle = B[b];
+    for (k = 0; k < 2; k++) {
+      if (k == 1) last = conx_compass_opposite(last);
+      MOVE_POINT(&middle, last, delta_x, delta_y);
+      half = &h.half[h.nhalves++];
+      half->start = half->middle = middle;
+      half->last = last;
+      half->count = half->left = half->done = 0;
+      conx_bres_memo_init(&half->memo, func, NULL, B[b], delta_x, delta_y);
+      half->memo.direction = (int) k;
+      conx_ptbuf_init(&half->pts);
+    }
+  }
+  h.func = func;
+  h.dw = delta_x;
+  h.dh = delta_y;
+  h.keepgoing = keepgoing;
+  h.kArg = kArg;
+  h.go = 0;
+
+  nworkers = lesser(nthreads, h.nhalves);
+  for (k = 0; k < nworkers; k++) {
+    w[k].h = &h;
+    w[k].fArg = fArgs[k];
+  }
+  /* This thread is worker 0, and those that start are 1, 2, .... */
+  h.nworkers = 1;
+  w[0].index = 0;
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&h.lock, NULL);
+  pthread_cond_init(&h.moved, NULL);
+  for (k = 1; k < nworkers; k++) {
+    started[k] = (pthread_create(&tids[k], NULL, bres_worker, &w[k]) == 0);
+    if (started[k]) w[k].index = h.nworkers++;
+  }
+#endif
+  BRES_LOCK(&h);
+  h.go = 1;
+  BRES_BROADCAST(&h);
+  BRES_UNLOCK(&h);
+  (void) bres_worker(&w[0]);
+#ifdef HAVE_PTHREAD_H
+  for (k = 1; k < nworkers; k++)
+    if (started[k]) pthread_join(tids[k], NULL);
+  pthread_cond_destroy(&h.moved);
+  pthread_mutex_destroy(&h.lock);
+#endif
+
+  if (stats == NULL) stats = &ignored;
+  stats->hits = stats->emitted = stats->unique = 0;
+  /* As bresenham() does, skip the second branch if the first drew it. */
+  if (nbranches == 2
+      && (conx_bres_memo_drawn(&h.half[0].memo, RB)
+          || conx_bres_memo_drawn(&h.half[1].memo, RB)))
+    h.half[2].pts.n = h.half[3].pts.n = 0;
+  for (b = 0; b < nbranches; b++) {
+    conx_bres_memo_init(&m, NULL, NULL, B[b], delta_x, delta_y);
+    for (k = 2 * b; k < 2 * b + 2; k++) {
+      for (i = 0; i < h.half[k].pts.n; i++)
+        conx_bres_memo_emit(&m, h.half[k].pts.pts[i]);
+    }
+    conx_bres_memo_stats(&m, stats);
+    conx_bres_memo_free(&m);
+  }
+  for (k = 0; k < h.nhalves; k++) {
+    stats->hits += h.half[k].memo.hits;
+    conx_bres_memo_free(&h.half[k].memo);
+    conx_sink_ptbuf(sink, &h.half[k].pts);
+    conx_ptbuf_free(&h.half[k].pts);
+  }
+  conx_sink_flush(sink);
+}
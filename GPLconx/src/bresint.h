@@ -18,14 +18,20 @@
 */
 
 /*
-  Internal header for the Bresenham method.
+  Internal header for the Bresenham method.  bres2.c and the templates of
+  kernels.hh share what is here, so that both trace the same pixels.
  */
 
 #ifndef CONX_BRESINT_H
 #define CONX_BRESINT_H 1
 
+#include "point.h"
 #include "util.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Here are two ways to move a point in one of eight directions: */
 
 /* void MOVE_POINT(Pt *current_location, ConxDirection dir,
@@ -67,4 +73,91 @@
   (current_location)->y += MM_VERTICAL((dir)) * (dh)
 #endif
 
+/* A hash table keyed by lattice points' offsets in pixels from the start
+   point of a branch.  Collisions are resolved by linear probing. */
+typedef struct BresEntry {
+  long i, j;
+  double f;           /* the metric, in a memo's values */
+  int owner;          /* the direction that drew it, in a memo's visits */
+  size_t step;        /* how many points were drawn before it, likewise */
+  int used;
+} BresEntry;
+
+typedef struct BresTable {
+  BresEntry *tab;
+  size_t size, n;     /* size is a power of two at least twice n */
+} BresTable;
+
+#define BRES_TABLE_INITIAL 1024
+
+/* The most moves that a trace makes in one direction */
+#define CONX_BRES_MAX_MOVES 15000
+
+/* What we know about the branch being traced.  values is a memo of the
+   metric: tracing the branch the other way starts among the start point's
+   neighbors, so this saves evaluations.  visits holds the points drawn so
+   far, so that a direction stops where the curve closes up rather than
+   going around again; see conx_bres_memo_closes(). */
+typedef struct BresMemo {
+  ConxBatchMetric *func;
+  void *fArg;
+  Pt origin;
+  double dw, dh;
+  BresTable values, visits;
+  int direction;      /* the directions begun, less one */
+  size_t hits;        /* points whose metric came from the memo */
+  size_t emitted;     /* points drawn, some perhaps more than once */
+} BresMemo;
+
+/* Set *mindirptr to x, if array[x] is the minimum among
+    { array[dir1], array[dir2], array[dir3] }
+*/
+#define GET_MINDIR3(mdp, array, dir1, dir2, dir3) \
+   if ((array)[dir1] < (array)[dir2]) { \
+     /* not dir2 */ \
+     if ((array)[dir1] < (array)[dir3]) *(mdp)=dir1; else *(mdp)=dir3; \
+   } else { \
+     /* not dir1 */ \
+     if ((array)[dir3] < (array)[dir2]) *(mdp)=dir3; else *(mdp)=dir2; \
+   }
+
+/* Set *mindirptr to x, if array[x] is the minimum among
+   { array[direcarray[0]], array[direcarray[1]], array[direcarray[2]] }
+*/
+#define ALT_GET_MINDIR3(mindirptr, array, direcarray) \
+  GET_MINDIR3(mindirptr, array, \
+              (direcarray)[0], (direcarray)[1], (direcarray)[2])
+
+#define FILL_DIRECTIONS3(lastdir, direcarray) \
+  { \
+    (direcarray)[0] = (lastdir); \
+    switch ((lastdir)) { \
+    case CXD_SE: (direcarray)[1] = CXD_S;  (direcarray)[2] = CXD_E; break; \
+    case CXD_S:  (direcarray)[1] = CXD_SE; (direcarray)[2] = CXD_SW; break; \
+    case CXD_NW: (direcarray)[1] = CXD_N;  (direcarray)[2] = CXD_W; break; \
+    case CXD_N:  (direcarray)[1] = CXD_NW; (direcarray)[2] = CXD_NE; break; \
+    case CXD_SW: (direcarray)[1] = CXD_S;  (direcarray)[2] = CXD_W; break; \
+    case CXD_W:  (direcarray)[1] = CXD_NW; (direcarray)[2] = CXD_SW; break; \
+    case CXD_NE: (direcarray)[1] = CXD_E;  (direcarray)[2] = CXD_N; break; \
+    default: assert((lastdir) == CXD_E); \
+                 (direcarray)[1] = CXD_NE; (direcarray)[2] = CXD_SE; break; \
+    } \
+  }
+
+ConxDirection conx_compass_opposite(ConxDirection d);
+void conx_bres_memo_init(BresMemo *m, ConxBatchMetric *func, void *fArg,
+                         Pt origin, double dw, double dh);
+void conx_bres_memo_free(BresMemo *m);
+int conx_bres_memo_lookup(BresMemo *m, double x, double y, double *f,
+                          long *i, long *j);
+void conx_bres_memo_store(BresMemo *m, long i, long j, double f);
+void conx_bres_memo_emit(BresMemo *m, Pt middle);
+int conx_bres_memo_closes(const BresMemo *m, Pt middle, int *left);
+int conx_bres_memo_drawn(const BresMemo *m, Pt P);
+void conx_bres_memo_stats(const BresMemo *m, ConxBresStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* CONX_BRESINT_H */
@@ -26,6 +26,13 @@
 #endif
 
 #include <iostream.h>
+#include <math.h>
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+#if defined(HAVE_SYS_TIME_H) && defined(HAVE_GETTIMEOFDAY)
+#include <sys/time.h>
+#endif
 
 #include "canvas.hh"
 #include "dgeomobj.hh"
@@ -33,8 +40,9 @@
 
 CF_INLINE
 CConxDumbCanvas::CConxDumbCanvas()
-  : width(300), height(300), xmin(-1.03), xmax(1.03),
-    ymin(-1.03), ymax(1.03)
+  : width(300), height(300), numThreads(1), coarseness(1),
+    xmin(-1.03), xmax(1.03),
+    ymin(-1.03), ymax(1.03), atlasIsValid(FALSE)
 {
   MMM("CConxDumbCanvas()");
 }
@@ -45,11 +53,13 @@ void CConxDumbCanvas::setSize(uint w, uint h) throw(int)
   // throws an int if w or h is 0.
   if (w == 0) throw 0;
   if (h == 0) throw 1;
+  invalidateAtlas();
   width = w; height = h;
 
   // Make it square. DLC
   if (width < height) width = height;
   if (width > height) height = width;
+  viewChanged();
 }
 
 BUGGY_INLINE
@@ -63,22 +73,62 @@ void CConxDumbCanvas::setViewingRectangle(double xmin, double xmax,
 
   if (xmin > xmax) throw 1;
   if (ymin > ymax) throw 2;
+  invalidateAtlas();
   this->xmin = xmin;
   this->xmax = xmax;
   this->ymin = ymin;
   this->ymax = ymax;
+  viewChanged();
+}
+
+BUGGY_INLINE
+void CConxDumbCanvas::setNumThreads(uint n) throw(int)
+{
+  // throws an int if n is 0.
+  if (n == 0) throw 0;
+  numThreads = n;
+}
+
+BUGGY_INLINE
+void CConxDumbCanvas::setCoarseness(uint c) throw(int)
+{
+  // throws an int if c is 0.
+  if (c == 0) throw 0;
+  if (c != coarseness) invalidateAtlas();
+  coarseness = c;
+}
+
+NF_INLINE
+const ConxLattice &CConxDumbCanvas::getAtlas(ConxModlType modl) const
+{
+  if (!atlasIsValid || atlasModl != modl) {
+    invalidateAtlas();
+    conx_lattice_build(&atlas, modl, getPixelWidth(), getPixelHeight(),
+                       getXmin(), getXmax(), getYmin(), getYmax());
+    conx_lattice_klein(&atlas, modl);
+    atlasModl = modl;
+    atlasIsValid = TRUE;
+  }
+  return atlas;
+}
+
+NF_INLINE
+void CConxDumbCanvas::invalidateAtlas() const
+{
+  if (atlasIsValid) conx_lattice_free(&atlas);
+  atlasIsValid = FALSE;
 }
 
 NF_INLINE
 double CConxDumbCanvas::getPixelWidth() const
 {
-  return (getXmax()-getXmin())/(double)getWidth();
+  return (getXmax()-getXmin())/(double)getWidth() * (double)getCoarseness();
 }
 
 NF_INLINE
 double CConxDumbCanvas::getPixelHeight() const
 {
-  return (getYmax()-getYmin())/(double)getHeight();
+  return (getYmax()-getYmin())/(double)getHeight() * (double)getCoarseness();
 }
 
 NF_INLINE
@@ -92,6 +142,7 @@ NF_INLINE
 void CConxCanvas::clearDrawables()
 {
   artists.clear();
+  restartRefinement();
 }
 
 NF_INLINE
@@ -104,27 +155,287 @@ void CConxCanvas::append(const CConxArtist *m) throw(const char *)
   CConxArtist *nn = m->aClone();
   if (nn == NULL) OOM();
   artists.append(nn);
+  restartRefinement();
+}
+
+NF_INLINE
+void CConxCanvas::setFrameBudget(double seconds)
+{
+  frameBudget = seconds;
+  restartRefinement();
+}
+
+static double wallClock()
+// Returns the time in seconds since some fixed time.  clock() will not
+// do, since it adds up the time of all our drawing threads.
+{
+#if defined(HAVE_SYS_TIME_H) && defined(HAVE_GETTIMEOFDAY)
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (double) tv.tv_sec + 1e-6 * (double) tv.tv_usec;
+#else
+  return (double) time(NULL);
+#endif
+}
+
+NF_INLINE
+uint CConxCanvas::finestAffordable(uint coarsest) const
+// Returns the smallest coarseness, a power of two no greater than coarsest,
+// at which a pass should fit in the frame budget.  A pass takes about four
+// times as long as one twice as coarse since it has four times as many
+// pixels.  Without a timed pass to go by, returns coarsest.
+{
+  if (passCoarseness == 0) return coarsest;
+  for (uint c = 1; c < coarsest; c *= 2) {
+    double ratio = (double) passCoarseness / (double) c;
+    if (passSeconds * ratio * ratio <= getFrameBudget()) return c;
+  }
+  return coarsest;
 }
 
 NF_INLINE
 void CConxCanvas::masterDraw()
+{
+  if (viewMoved && sceneIsValid) {
+    // Only the view changed, as when the user drags it, so we move what
+    // we drew, which is quick.  The next call draws the artists afresh as
+    // the view moves them, unless the view moves again first.
+    replayScene();
+    if (getFrameBudget() > 0.0) refinement = finestAffordable(CCONX_COARSEST);
+    return;
+  }
+  if (getFrameBudget() <= 0.0) {
+    setCoarseness(1);
+    drawScene();
+    return;
+  }
+  // Draw one pass, so that the caller shows it before the next.
+  if (refinement == 0) refinement = 1; // Redraw the finished scene.
+  double start = wallClock();
+  setCoarseness(refinement);
+  drawScene();
+  passSeconds = wallClock() - start;
+  passCoarseness = refinement;
+  refinement = (refinement == 1) ? 0 : finestAffordable(refinement / 2);
+}
+
+NF_INLINE
+void CConxCanvas::drawScene()
+// Draws everything at the present coarseness and keeps it as the scene.
 {
   clear();
+  sceneSteps.clear();
+  scenePts.n = 0;
+  recording = TRUE;
   if (getModel() != CONX_POINCARE_UHP) {
     // Draw the bounding circle if it is visible
     // DLC make this optional
     setDrawingColor(CConxNamedColor(CConxNamedColor::WHITE));
     drawCircle(0.0, 0.0, 1.0);
   }
-  size_t i, sz = numArtists();
-  for (i = 0; i < sz; i++) {
-    const CConxArtist &a = artists.get(i);
+  size_t i, j, sz = numArtists(), nfused = 0;
+  // We draw the artists moved by the view rather than moving what they
+  // draw, so that pixel-spaced points stay pixel-spaced and what the view
+  // brings into sight is drawn.
+  Boole moved = !conx_isom_is_identity(&view);
+  const CConxArtist **drawn = new const CConxArtist *[sz + 1];
+  if (drawn == NULL) OOM();
+  for (i = 0; i < sz; i++)
+    drawn[i] = moved ? artists.get(i).movedClone(view) : &artists.get(i);
+  sceneView = view;
+  const CConxDwGeomObj **fused = NULL;
+  char **hits = NULL;
+  if (getLongwayFusing() && sz > 1) {
+    fused = new const CConxDwGeomObj *[sz];
+    if (fused == NULL) OOM();
+    for (i = 0; i < sz; i++) {
+      fused[i] = drawn[i]->getFusibleLongway();
+      if (fused[i] != NULL) ++nfused;
+    }
+  }
+  if (nfused > 1) {
+    // One sweep evaluates every fused artist at each point while the
+    // point's coordinates are in the cache.
+    const CConxDwGeomObj **d = new const CConxDwGeomObj *[nfused];
+    hits = new char *[nfused];
+    if (d == NULL || hits == NULL) OOM();
+    size_t npts = conx_lattice_size(&getAtlas(getModel()));
+    for (i = j = 0; i < sz; i++) {
+      if (fused[i] == NULL) continue;
+      d[j] = fused[i];
+      hits[j] = new char[npts + 1];
+      if (hits[j] == NULL) OOM();
+      ++j;
+    }
+    CConxDwGeomObj::findFusedHits(*this, d, nfused, hits);
+    delete [] d;
+  }
+  for (i = j = 0; i < sz; i++) {
+    const CConxArtist &a = *drawn[i];
     LLL("Now rendering " << flush << a);
-    a.drawOn(*this);
+    if (nfused > 1 && fused[i] != NULL)
+      fused[i]->drawFusedHits(*this, hits[j++]);
+    else
+      a.drawOn(*this);
   }
+  if (hits != NULL) {
+    for (j = 0; j < nfused; j++) delete [] hits[j];
+    delete [] hits;
+  }
+  if (fused != NULL) delete [] fused;
+  if (moved) {
+    for (i = 0; i < sz; i++) delete drawn[i];
+  }
+  delete [] drawn;
+  recording = FALSE;
+  sceneIsValid = TRUE;
+  viewMoved = FALSE;
+  flushQueue();
+}
+
+NF_INLINE
+void CConxCanvas::replayScene()
+// Draws the scene that drawScene() kept as the view now moves it.
+{
+  clear();
+  replaying = TRUE;
+  // The scene was drawn as sceneView moved it.
+  if (conx_isom_is_identity(&sceneView)) {
+    replayView = view;
+  } else {
+    conx_isom_inverse(&sceneView, &replayView);
+    conx_isom_compose(&view, &replayView, &replayView);
+  }
+  size_t i, end, sz = sceneSteps.size();
+  for (i = 0; i < sz; i++) {
+    SceneStep st = sceneSteps.get(i);
+    switch (st.kind) {
+    case SceneStep::COLOR:
+      setDrawingColor(CConxColor(st.v[0], st.v[1], st.v[2]));
+      break;
+    case SceneStep::POINT_SIZE:
+      setPointSize(st.v[0]);
+      break;
+    default:
+      assert(st.kind == SceneStep::BEGIN);
+      end = (i + 1 < sz) ? sceneSteps.get(i + 1).start : scenePts.n;
+      beginDraw(st.dt);
+      drawVertices(scenePts.pts + st.start, end - st.start);
+      endDraw();
+    }
+  }
+  replaying = FALSE;
+  viewMoved = FALSE;
   flushQueue();
 }
 
+NF_INLINE
+void CConxCanvas::recordBegin(DrawingType dt)
+{
+  if (!recording || replaying) return;
+  SceneStep st;
+  st.kind = SceneStep::BEGIN;
+  st.dt = dt;
+  st.start = scenePts.n;
+  sceneSteps.append(st);
+}
+
+NF_INLINE
+void CConxCanvas::recordColor(const CConxColor &C)
+{
+  if (!recording || replaying) return;
+  SceneStep st;
+  st.kind = SceneStep::COLOR;
+  st.v[0] = C.getR(); st.v[1] = C.getG(); st.v[2] = C.getB();
+  st.start = scenePts.n;
+  sceneSteps.append(st);
+}
+
+NF_INLINE
+void CConxCanvas::recordPointSize(double pSize)
+{
+  if (!recording || replaying) return;
+  SceneStep st;
+  st.kind = SceneStep::POINT_SIZE;
+  st.v[0] = pSize;
+  st.start = scenePts.n;
+  sceneSteps.append(st);
+}
+
+NF_INLINE
+const Pt *CConxCanvas::recordVertices(const Pt *pts, size_t n)
+// drawScene() draws the artists already moved by the view, so their
+// vertices are kept as they are.  A replay moves them by replayView, and
+// anything drawn outside of masterDraw() is moved by the view.
+{
+  const ConxIsometry *g = &view;
+  if (recording && !replaying) {
+    conx_ptbuf_extend(pts, n, &scenePts);
+    return pts;
+  }
+  if (replaying) g = &replayView;
+  if (conx_isom_is_identity(g)) return pts;
+  viewedPts.n = 0;
+  conx_ptbuf_extend(pts, n, &viewedPts);
+  conx_isom_apply_pts(g, getModel(), viewedPts.pts, viewedPts.pts, n);
+  return viewedPts.pts;
+}
+
+NF_INLINE
+void CConxCanvas::setView(const ConxIsometry &g)
+{
+  view = g;
+  viewMoved = TRUE;
+}
+
+BUGGY_INLINE
+void CConxCanvas::translateBy(const CConxPoint &P) throw(int)
+{
+  ConxIsometry t;
+  if (P.isAtInfinity()
+      || !conx_isom_translation(&t, P.getX(CONX_POINCARE_DISK),
+                                P.getY(CONX_POINCARE_DISK)))
+    throw 0;
+  conx_isom_compose(&t, &view, &t);
+  setView(t);
+}
+
+NF_INLINE
+void CConxCanvas::rotateBy(double radians)
+{
+  ConxIsometry r;
+  conx_isom_rotation(&r, radians);
+  conx_isom_compose(&r, &view, &r);
+  setView(r);
+}
+
+NF_INLINE
+void CConxCanvas::resetView()
+{
+  ConxIsometry g;
+  conx_isom_identity(&g);
+  setView(g);
+}
+
+NF_INLINE
+void CConxCanvas::initScene()
+{
+  conx_ptbuf_init(&scenePts);
+  conx_ptbuf_init(&viewedPts);
+  recording = replaying = FALSE;
+  sceneIsValid = viewMoved = FALSE;
+  conx_isom_identity(&sceneView);
+}
+
+NF_INLINE
+void CConxCanvas::clearScene()
+{
+  sceneSteps.clear();
+  conx_ptbuf_free(&scenePts);
+  conx_ptbuf_free(&viewedPts);
+  sceneIsValid = FALSE;
+}
+
 NF_INLINE
 void CConxCanvas::setModel(ConxModlType modl)
 {
@@ -132,6 +443,7 @@ void CConxCanvas::setModel(ConxModlType modl)
          || modl == CONX_POINCARE_DISK
          || modl == CONX_POINCARE_UHP);
   // DLC invalidate display lists.
+  if (modl != this->modl) restartRefinement();
   this->modl = modl;
 }
 
@@ -160,6 +472,7 @@ const char *CConxCanvas::modelToString(ConxModlType modl)
 NF_INLINE
 CConxDumbCanvas &CConxDumbCanvas::operator=(const CConxDumbCanvas &o)
 {
+  invalidateAtlas();
   uninitializedCopy(o);
   return *this;
 }
@@ -186,9 +499,12 @@ void CConxDumbCanvas::screenCoordinatesToModelCoordinates(long x, long y, Pt &mo
 
 NF_INLINE
 void CConxDumbCanvas::uninitializedCopy(const CConxDumbCanvas &o)
+  // The atlas is not copied.
 {
   width = o.width;
   height = o.height;
+  numThreads = o.numThreads;
+  coarseness = o.coarseness;
   xmin = o.xmin;
   xmax = o.xmax;
   ymin = o.ymin;
@@ -214,10 +530,39 @@ void CConxDrawCanvas::drawArc(Pt center, double r, double t0, double t1)
   drawArc(center.x, center.y, r, t0, t1);
 }
 
+NF_INLINE
+void CConxDrawCanvas::drawEllipse(double x, double y, double a, double b,
+                                  double phi)
+{
+  double c = cos(phi), s = sin(phi);
+  beginDraw(LINE_STRIP);
+  for (double t = 0.0; t <= M_PI * 2.0; t += 0.005/* DLC tstep */) {
+    drawVertex(x + a*cos(t)*c - b*sin(t)*s, y + a*cos(t)*s + b*sin(t)*c);
+  }
+  drawVertex(x + a*c, y + a*s); // close the loop
+  endDraw();
+}
+
+NF_INLINE
+void CConxDrawCanvas::drawVertices(const Pt *pts, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    drawVertex(pts[i].x, pts[i].y);
+}
+
+NF_INLINE
+void CConxDrawCanvas::sinkVertices(const Pt *pts, size_t n, void *cv)
+{
+  assert(cv != NULL);
+  ((CConxDrawCanvas *) cv)->drawVertices(pts, n);
+}
+
 CF_INLINE
 CConxCanvas::CConxCanvas(const CConxCanvas &o)
   : CConxDrawCanvas(o)
 {
+  initFieldRasters();
+  initScene();
   uninitializedCopy(o);
 }
 
@@ -225,6 +570,7 @@ NF_INLINE
 CConxCanvas &CConxCanvas::operator=(const CConxCanvas &o)
 {
   (void) CConxDrawCanvas::operator=(o);
+  clearFieldRasters();
   uninitializedCopy(o);
   return *this;
 }
@@ -237,7 +583,231 @@ int CConxCanvas::operator==(const CConxCanvas &o) const
 
 NF_INLINE
 void CConxCanvas::uninitializedCopy(const CConxCanvas &o)
+  // Field rasters and the scene are not copied.
 {
   artists = o.artists;
+  view = o.view;
+  viewMoved = TRUE;
+  fusesLongway = o.fusesLongway;
+  tracesCurves = o.tracesCurves;
+  metricPrecision = o.metricPrecision;
+  frameBudget = o.frameBudget;
+  passCoarseness = 0;
+  restartRefinement();
+}
+
+NF_INLINE
+void CConxCanvas::initFieldRasters()
+{
+  for (size_t i = 0; i < CCONX_FIELD_RASTERS; i++)
+    rasters[i] = NULL;
+  oldestRaster = 0;
+}
+
+NF_INLINE
+void CConxCanvas::clearFieldRasters()
+{
+  for (size_t i = 0; i < CCONX_FIELD_RASTERS; i++) {
+    if (rasters[i] != NULL) {
+      delete rasters[i]->artist;
+      delete [] rasters[i]->g;
+      delete [] rasters[i]->gf;
+      delete rasters[i];
+      rasters[i] = NULL;
+    }
+  }
+  oldestRaster = 0;
+}
+
+NF_INLINE
+CConxCanvas::FieldRaster *
+CConxCanvas::findFieldRaster(const CConxSimpleArtist &a,
+                             ConxPrecision prec) const
+{
+  for (size_t i = 0; i < CCONX_FIELD_RASTERS; i++) {
+    FieldRaster *r = rasters[i];
+    if (r != NULL && r->modl == getModel() && r->prec == prec
+        && r->xmin == getXmin() && r->xmax == getXmax()
+        && r->ymin == getYmin() && r->ymax == getYmax()
+        && r->pixelWidth == getPixelWidth()
+        && r->pixelHeight == getPixelHeight()
+        && r->artist->sameField(a))
+      return r;
+  }
+  return NULL;
 }
 
+// Each thread sampling a field evaluates it at its own CConxPoint.
+struct FieldScratch {
+  const CConxSimpleArtist *artist;
+  ConxModlType modl;
+  ConxPrecision prec;
+  CConxPoint X;
+};
+
+NF_INLINE
+void CConxCanvas::fieldMetric(const double *x, const double *y, double *g,
+                              size_t n, void *t)
+{
+  FieldScratch *s = (FieldScratch *) t;
+  s->artist->definingFields(x, y, n, s->modl, g, s->X, s->prec);
+}
+
+NF_INLINE
+void CConxCanvas::fieldMetricf(const double *x, const double *y, float *g,
+                               size_t n, void *t)
+{
+  FieldScratch *s = (FieldScratch *) t;
+  s->artist->definingFieldsf(x, y, n, s->modl, g, s->X);
+}
+
+NF_INLINE
+const CConxCanvas::FieldRaster &
+CConxCanvas::getFieldRaster(const CConxSimpleArtist &a, ConxPrecision prec)
+{
+  FieldRaster *r = findFieldRaster(a, prec);
+  if (r != NULL) return *r;
+
+  // Replace the oldest raster.
+  r = rasters[oldestRaster];
+  if (r == NULL) {
+    r = rasters[oldestRaster] = new FieldRaster;
+    if (r == NULL) OOM();
+  } else {
+    delete r->artist;
+    delete [] r->g;
+    delete [] r->gf;
+  }
+  oldestRaster = (oldestRaster + 1) % CCONX_FIELD_RASTERS;
+
+  r->artist = a.clone();
+  if (r->artist == NULL) OOM();
+  r->modl = getModel();
+  r->prec = prec;
+  r->xmin = getXmin(); r->xmax = getXmax();
+  r->ymin = getYmin(); r->ymax = getYmax();
+  r->pixelWidth = getPixelWidth();
+  r->pixelHeight = getPixelHeight();
+  const ConxLattice &L = getAtlas(r->modl);
+  size_t i, n = getNumThreads(), npts = conx_lattice_size(&L);
+
+  // We construct every thread's CConxPoint here because CConxObject's
+  // constructors are not thread-safe.
+  FieldScratch *scratch = new FieldScratch[n];
+  void **args = new void *[n];
+  if (scratch == NULL || args == NULL) OOM();
+  for (i = 0; i < n; i++) {
+    scratch[i].artist = &a;
+    scratch[i].modl = CONX_KLEIN_DISK; // The atlas gives Klein coordinates.
+    scratch[i].prec = prec;
+    args[i] = scratch + i;
+  }
+  if (n > 1) {
+    // Fill the artist's caches while there is only one thread; see
+    // CConxDwGeomObj::drawLongway().
+    double o = 0.0, g;
+    fieldMetric(&o, &o, &g, 1, scratch);
+  }
+  r->g = NULL;
+  r->gf = NULL;
+  if (prec == CONX_FAST) {
+    // Sampled straight into floats, so there is never a raster of doubles.
+    r->gf = new float[npts + 1];
+    if (r->gf == NULL) OOM();
+    conx_lattice_samplef(fieldMetricf, args, n, &L, r->gf);
+  } else {
+    r->g = new double[npts + 1];
+    if (r->g == NULL) OOM();
+    conx_lattice_sample(fieldMetric, args, n, &L, r->g);
+  }
+  delete [] args;
+  delete [] scratch;
+  return *r;
+}
+
+// What conx_trace needs to evaluate an artist's defining function.
+struct TraceScratch {
+  const CConxCanvas *cv;
+  const CConxSimpleArtist *artist;
+  CConxPoint X;
+};
+
+NF_INLINE
+void CConxCanvas::traceMetric(const double *x, const double *y, double *f,
+                              double *gx, double *gy, size_t n, void *t)
+{
+  TraceScratch *s = (TraceScratch *) t;
+  s->artist->definingGradients(x, y, n, s->cv->getModel(), f, gx, gy, s->X);
+}
+
+NF_INLINE
+int CConxCanvas::traceKeepGoing(Pt middle, Pt oldmiddle, void *t)
+// Like CConxGLCanvas::bresKeepGoing().
+{
+  const CConxCanvas *cv = ((TraceScratch *) t)->cv;
+  if (cv->getModel() != CONX_POINCARE_UHP)
+    return (sqr(middle.x) + sqr(middle.y) < 1.0);
+  return (middle.x < cv->getXmax() && middle.x > cv->getXmin()
+          && middle.y < cv->getYmax() && middle.y > cv->getYmin());
+}
+
+NF_INLINE
+void CConxCanvas::traceDrawPolyline(const Pt *pts, size_t n, void *t)
+{
+#ifdef HAVE_CONST_CAST
+  CConxCanvas *cv = const_cast< CConxCanvas * >( ((TraceScratch *) t)->cv );
+#else
+  CConxCanvas *cv = (CConxCanvas *) ((TraceScratch *) t)->cv;
+#endif
+  cv->beginDraw(cv->LINE_STRIP);
+  cv->drawVertices(pts, n);
+  cv->endDraw();
+}
+
+NF_INLINE
+void CConxCanvas::drawCurve(const CConxPoint &lb, const CConxPoint &rb,
+                            DFN *f, const CConxSimpleArtist *sa)
+{
+  assert(sa != NULL);
+  if (!getCurveTracing()) {
+    drawByBresenham(lb, rb, f, sa);
+    return;
+  }
+  TraceScratch s;
+  s.cv = this;
+  s.artist = sa;
+  (void) conx_trace(lb.getPt(getModel()), rb.getPt(getModel()),
+                    traceMetric, &s, getPixelWidth(), getPixelHeight(),
+                    traceKeepGoing, &s, traceDrawPolyline, &s);
+}
+
+NF_INLINE
+int CConxCanvas::polarKeepGoing(Pt p, Pt q, void *t)
+// Returns nonzero if the curve between p and q, which are close together
+// on it, may cross the viewing rectangle.  Short of splitting the chord,
+// we cannot tell how far the curve bulges from it, so we allow it as much
+// as the chord's length.
+{
+  const CConxCanvas *cv = ((TraceScratch *) t)->cv;
+  double pad = sqrt(sqr(p.x - q.x) + sqr(p.y - q.y));
+  return (lesser(p.x, q.x) - pad < cv->getXmax()
+          && greater(p.x, q.x) + pad > cv->getXmin()
+          && lesser(p.y, q.y) - pad < cv->getYmax()
+          && greater(p.y, q.y) + pad > cv->getYmin());
+}
+
+NF_INLINE
+void CConxCanvas::drawPolar(const CConxPoint &F, ConxBatchMetric *f,
+                            void *fArg)
+{
+  double h[3];
+  TraceScratch s;
+
+  assert(f != NULL);
+  if (!F.getHyperboloid(h)) return;
+  s.cv = this;
+  s.artist = NULL;
+  (void) conx_polar(h, getModel(), f, fArg, getPixelWidth(),
+                    getPixelHeight(), polarKeepGoing, &s,
+                    traceDrawPolyline, &s);
+}
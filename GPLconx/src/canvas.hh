@@ -35,8 +35,13 @@ class CConxDumbCanvas
   CCONX_CLASSNAME("CConxDumbCanvas")
 public:
   CConxDumbCanvas();
-  CConxDumbCanvas(const CConxDumbCanvas &o) { uninitializedCopy(o); }
+  CConxDumbCanvas(const CConxDumbCanvas &o)
+  {
+    atlasIsValid = FALSE;
+    uninitializedCopy(o);
+  }
   CConxDumbCanvas &operator=(const CConxDumbCanvas &o);
+  ~CConxDumbCanvas() { invalidateAtlas(); }
   // The default operator== and != will work.
 
   void setSize(uint w, uint h) throw(int);
@@ -52,15 +57,42 @@ public:
   double getPixelHeight() const;
   Pt screenCoordinatesToModelCoordinates(long x, long y);
   void screenCoordinatesToModelCoordinates(long x, long y, Pt &modelCoords);
+
+  // The most threads that a drawing method like LONGWAY may use to draw
+  // on this canvas.  1, the default, means that no threads are created.
+  void setNumThreads(uint n) throw(int);
+  uint getNumThreads() const { return numThreads; }
+
+  // Drawing methods treat c by c blocks of pixels as one pixel, i.e.
+  // getPixelWidth() and getPixelHeight() are c times as large, so that
+  // an expensive scene can be previewed.  1, the default, is full detail.
+  void setCoarseness(uint c) throw(int);
+  uint getCoarseness() const { return coarseness; }
+
+  // The points of this canvas that the LONGWAY method visits in the modl
+  // model, with their Klein coordinates, so that artists need not convert
+  // each point to the Klein model themselves.  This is built the first time
+  // you ask and kept until the size, viewing rectangle, or model changes.
+  const ConxLattice &getAtlas(ConxModlType modl) const;
   ostream &printOn(ostream &o) const;
 
+protected:
+  // Called whenever the size or viewing rectangle changes.
+  virtual void viewChanged() { }
+
 private: // operations
   void uninitializedCopy(const CConxDumbCanvas &o);
+  void invalidateAtlas() const;
 
 private: // attributes
   uint width, height; // In pixels.  Always strictly positive.
+  uint numThreads; // Always strictly positive.
+  uint coarseness; // Always strictly positive.
   double xmin, xmax, ymin, ymax;
   // model coordinates.  Always xmin <= xmax and ymin <= ymax
+  mutable ConxLattice atlas;
+  mutable Boole atlasIsValid;
+  mutable ConxModlType atlasModl;
 }; // class CConxDumbCanvas
 
 
@@ -90,14 +122,26 @@ public:
   virtual void endDraw() = 0;
   virtual void drawVertex(double x, double y) = 0;
   virtual void drawVertex(const Pt &p) { drawVertex(p.x, p.y); }
+  // Draws n vertices as n calls to drawVertex() would.  Subclasses should
+  // override this if they can take vertices in bulk.
+  virtual void drawVertices(const Pt *pts, size_t n);
+  // A ConxVertexSink flush function; cv is a CConxDrawCanvas *.
+  static void sinkVertices(const Pt *pts, size_t n, void *cv);
   virtual void drawCircle(double x, double y, double r) = 0;
   virtual void drawCircle(Pt p, double r) { drawCircle(p.x, p.y, r); }
   virtual void drawTopSemiCircle(double x, double y, double r) = 0;
   virtual void drawTopSemiCircle(Pt p, double r);
   virtual void drawArc(double x, double y, double r, double t0, double t1) = 0;
   virtual void drawArc(Pt center, double r, double t0, double t1);
+  // Draws the ellipse centered at (x, y) with semi-axes a, at phi radians
+  // counterclockwise from the x axis, and b.  The default draws a
+  // LINE_STRIP as CConxGLCanvas::drawArc() does.
+  virtual void drawEllipse(double x, double y, double a, double b,
+                           double phi);
 
   typedef double (DFN) (const CConxSimpleArtist *sa, const CConxPoint &);
+  // f(sa, X) must be sa->definingFunction(X), so a canvas may call
+  // sa->definingFunctions() to evaluate f at several points at once.
   virtual void drawByBresenham(const CConxPoint &lb, const CConxPoint &rb,
                                DFN *f, const CConxSimpleArtist *sa) = 0;
   virtual void setDrawingColor(const CConxColor &C) = 0;
@@ -110,15 +154,44 @@ public:
 }; // class CConxDrawCanvas
 
 
+// A canvas keeps at most this many field rasters; see getFieldRaster().
+#define CCONX_FIELD_RASTERS 8
+
+// Progressive drawing starts with this coarseness (see setCoarseness())
+// and halves it each pass.  It must be a power of two.
+#define CCONX_COARSEST 8
+
 //////////////////////////////////////////////////////////////////////////////
 // Abstract -- you must subclass and implement the drawing operations.
 // A canvas that you can draw on that knows what model it represents.
 class CConxCanvas : VIRT public CConxDrawCanvas {
   CCONX_CLASSNAME("CConxCanvas")
+public: // types
+  // The field of an artist (see CConxSimpleArtist::hasDefiningField())
+  // sampled at each point of the atlas (see getAtlas()) for a given model,
+  // viz area, and pixel size.  A CONX_FAST raster keeps floats, which is
+  // all that CONX_FAST evaluation gives anyway.
+  struct FieldRaster {
+    CConxSimpleArtist *artist;  // a copy of the artist whose field this is
+    ConxModlType modl;
+    ConxPrecision prec;
+    double xmin, xmax, ymin, ymax, pixelWidth, pixelHeight;
+    double *g;                  // g[k] goes with getAtlas(modl).ys[k]
+    float *gf;                  // in place of g, which is then NULL
+  };
 public:
-  CConxCanvas() : modl(CONX_KLEIN_DISK) { }
+  CConxCanvas()
+    : fusesLongway(TRUE), tracesCurves(FALSE), metricPrecision(CONX_PRECISE),
+      frameBudget(0.0), refinement(0), passSeconds(0.0), passCoarseness(0),
+      modl(CONX_KLEIN_DISK)
+  {
+    initFieldRasters();
+    initScene();
+    conx_isom_identity(&view);
+  }
   CConxCanvas(const CConxCanvas &o);
   CConxCanvas &operator=(const CConxCanvas &o);
+  ~CConxCanvas() { clearFieldRasters(); clearScene(); }
   int operator==(const CConxCanvas &o) const;
   int operator!=(const CConxCanvas &o) const { return !operator==(o); }
 
@@ -126,19 +199,145 @@ public:
   void setModel(ConxModlType modl);
   ostream &printOn(ostream &o) const;
   virtual void masterDraw(); // non-const because there are side effects.
+
+  // With a positive frame budget, in seconds, masterDraw() draws
+  // progressively: after the scene changes, it draws everything coarsely,
+  // at most at coarseness CCONX_COARSEST, and then in finer passes, one
+  // pass per call.  Each pass is as fine as the wall-clock time of the
+  // last pass says will fit in the budget, so fast scenes skip the coarse
+  // passes.  While needsRefinement() is TRUE, show what was drawn and let
+  // the user interface run before calling masterDraw() again for the next
+  // pass.  A change to the artists, model, size, or viewing rectangle
+  // abandons the old passes.  Each artist is drawn whole, so a single
+  // slow artist can still exceed the budget.
+  double getFrameBudget() const { return frameBudget; }
+  void setFrameBudget(double seconds);
+  Boole needsRefinement() const { return (refinement != 0); }
   void append(const CConxArtist *m) throw(const char *); // you still own m
   void clearDrawables();
   size_t numArtists() const { return artists.size(); }
+  // If TRUE, masterDraw() evaluates all the artists that draw by the
+  // LONGWAY method (see CConxArtist::getFusibleLongway()) in one sweep of
+  // the atlas and then draws each in turn, which draws just what drawing
+  // them one by one does.
+  Boole getLongwayFusing() const { return fusesLongway; }
+  void setLongwayFusing(Boole f) { fusesLongway = f; }
+  // The precision with which drawByBresenham() evaluates defining
+  // functions.  An artist that wants CONX_FAST sets this while it draws.
+  ConxPrecision getMetricPrecision() const { return metricPrecision; }
+  void setMetricPrecision(ConxPrecision p) { metricPrecision = p; }
+
+  // Artists call this rather than drawByBresenham().  It follows the curve
+  // through lb and rb (see conx_bresenham_batch()) by drawByBresenham(),
+  // or, if getCurveTracing() is TRUE, by conx_trace(), which draws
+  // LINE_STRIPs.  An artist that wants tracing sets this while it draws.
+  void drawCurve(const CConxPoint &lb, const CConxPoint &rb,
+                 DFN *f, const CConxSimpleArtist *sa);
+  Boole getCurveTracing() const { return tracesCurves; }
+  void setCurveTracing(Boole t) { tracesCurves = t; }
+  // Draws the curve on which f is zero as LINE_STRIPs by solving for it
+  // along rays from F; see conx_polar().  f is evaluated in this canvas's
+  // model, must be negative at F, and must not decrease along any ray
+  // from F.  Parts of the curve outside the viewing rectangle are drawn
+  // coarsely.  Draws nothing if F is at infinity.
+  void drawPolar(const CConxPoint &F, ConxBatchMetric *f, void *fArg);
+
+  // The view is an isometry of the plane that moves everything drawn on
+  // this canvas, so that the user can pan and turn without leaving the
+  // model.  masterDraw() draws the artists moved by the view and keeps
+  // what it drew.  If only the view has changed since, as while the user
+  // drags it, masterDraw() moves those vertices rather than drawing the
+  // artists again, and the call after that draws them afresh.
+  const ConxIsometry &getView() const { return view; }
+  void setView(const ConxIsometry &g);
+  // Moves the view so that the origin (i.e. (0, 1) in the Poincare UHP)
+  // goes to P.  Throws an int if P is at infinity.
+  void translateBy(const CConxPoint &P) throw(int);
+  // Turns the view by radians, counterclockwise, about the origin.
+  void rotateBy(double radians);
+  void resetView();
+  // Returns a raster of a's field for this canvas as it is now.  The field
+  // is only sampled if no raster we have kept fits; changing a's scalar
+  // or your tolerance does not change the field.  The raster is valid
+  // until the next call.
+  const FieldRaster &getFieldRaster(const CConxSimpleArtist &a,
+                                    ConxPrecision prec = CONX_PRECISE);
+  Boole hasFieldRaster(const CConxSimpleArtist &a,
+                       ConxPrecision prec = CONX_PRECISE) const
+  {
+    return (findFieldRaster(a, prec) != NULL);
+  }
+  void clearFieldRasters();
 
 protected:
   static const char *modelToString(ConxModlType modl);
+  void viewChanged() { restartRefinement(); }
+
+  // A subclass calls these from its beginDraw(), setDrawingColor(),
+  // setPointSize(), drawVertex(), and drawVertices() so that masterDraw()
+  // can replay the scene, and draws the vertices that recordVertices()
+  // returns, which are pts moved by the view.  Those are valid until the
+  // next call.
+  void recordBegin(DrawingType dt);
+  void recordColor(const CConxColor &C);
+  void recordPointSize(double pSize);
+  const Pt *recordVertices(const Pt *pts, size_t n);
 
 
 private: // operations
   void uninitializedCopy(const CConxCanvas &o);
+  void initFieldRasters();
+  void drawScene();
+  uint finestAffordable(uint coarsest) const;
+  void restartRefinement()
+  {
+    refinement = (frameBudget > 0.0) ? finestAffordable(CCONX_COARSEST) : 0;
+    sceneIsValid = FALSE;
+  }
+  void initScene();
+  void clearScene();
+  void replayScene();
+  FieldRaster *findFieldRaster(const CConxSimpleArtist &a,
+                               ConxPrecision prec) const;
+  static void fieldMetric(const double *x, const double *y, double *g,
+                          size_t n, void *t);
+  static void fieldMetricf(const double *x, const double *y, float *g,
+                           size_t n, void *t);
+  static void traceMetric(const double *x, const double *y, double *f,
+                          double *gx, double *gy, size_t n, void *t);
+  static int traceKeepGoing(Pt middle, Pt oldmiddle, void *t);
+  static void traceDrawPolyline(const Pt *pts, size_t n, void *t);
+  static int polarKeepGoing(Pt p, Pt q, void *t);
+
+private: // types
+  // One step of a recorded scene.  The vertices of a BEGIN are
+  // scenePts.pts[start] up to the next step's start.
+  struct SceneStep {
+    enum { BEGIN, COLOR, POINT_SIZE } kind;
+    DrawingType dt;
+    double v[3];                // the color's RGB or the point size
+    size_t start;
+  };
 
 private: // attributes
+  FieldRaster *rasters[CCONX_FIELD_RASTERS];
+  size_t oldestRaster;
+  Boole fusesLongway, tracesCurves;
+  ConxPrecision metricPrecision;
+  double frameBudget;
+  uint refinement; // The coarseness of the next pass, or 0 if none is due
+  double passSeconds; // How long the last pass took by the wall clock
+  uint passCoarseness; // and at what coarseness, or 0 if none was timed
   ConxModlType modl;
+  ConxIsometry view;
+  ConxIsometry sceneView;  // the view as the scene was drawn
+  ConxIsometry replayView; // what moves the scene to the view
+  CConxSimpleArray<SceneStep> sceneSteps;
+  ConxPtBuffer scenePts;  // the scene's vertices before the view moves them
+  ConxPtBuffer viewedPts; // what recordVertices() returns
+  Boole recording, replaying;
+  Boole sceneIsValid;     // TRUE if the scene is of the artists as they are
+  Boole viewMoved;        // TRUE if the view changed since we last drew
   CConxPrintableOwnerArray<CConxArtist> artists;
   // If we kept just the pointers in a simple array, then
   // calling `kdc addFirst: (p := Point new) .. kdc sync .. pdc addFirst: (kdc at: 1) .. pdc sync'
@@ -0,0 +1,344 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Contour extraction by marching squares.  Rather than drawing each pixel
+  where the metric is nearly zero, as the LONGWAY method does, we sample
+  the metric at the corners of a grid of pixel-sized cells, a row at a
+  time, and find the edges of the cells across which the metric changes
+  sign.  The zero on such an edge is found by linear interpolation, and
+  the zeroes within each cell are joined by a segment.  Finally the
+  segments are joined end to end into polylines.  Given the metric's
+  gradient, we then move each vertex onto the curve by a Newton step.
+
+  This only works for metrics that are negative on one side of the curve
+  and positive on the other.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "viewer.h"
+#include "util.h"
+
+/* A sample this large is treated as being at infinity (see CCONX_INFINITY
+   in h_simple.hh), and no curve is drawn near it. */
+#define CONTOUR_HUGE 1.0e+300
+
+/* The "sample" at a point that is not strictly inside the model */
+#define CONTOUR_OUTSIDE (2.0 * CONTOUR_HUGE)
+
+#define CONTOUR_NO_PARTNER ((size_t) -1)
+
+/* Which side of the curve a sample is on */
+#define NEGATIVE(v) ((v) < 0.0)
+
+typedef struct ContourSegment {
+  size_t edge[2];  /* the cell edges this segment's ends lie on */
+  Pt end[2];
+} ContourSegment;
+
+typedef struct ContourEnd {
+  size_t edge;
+  size_t which;    /* 2*segment + 0 or 1 */
+} ContourEnd;
+
+typedef struct Contour {
+  ContourSegment *segs;
+  size_t nsegs, segsz;
+  ConxBatchGradient *grad;  /* NULL if we are not to refine vertices */
+  void *gradArg;
+  double maxstep;           /* the longest Newton step we trust */
+} Contour;
+
+static int contour_usable(double v)
+/* Returns non-zero if v is neither NaN nor (nearly) infinite. */
+{
+  return (v == v) && (myabs(v) < CONTOUR_HUGE);
+}
+
+static Pt contour_zero(double xa, double ya, double fa,
+                       double xb, double yb, double fb)
+/* Returns the zero of the linear interpolant between a and b, which have
+   metrics of opposite signs.  Pass the ends of a given edge in the same
+   order every time so that both cells sharing the edge agree exactly. */
+{
+  Pt p;
+  double t = fa / (fa - fb);
+
+  p.x = xa + t * (xb - xa);
+  p.y = ya + t * (yb - ya);
+  return p;
+}
+
+static void contour_add(Contour *c, size_t e0, Pt p0, size_t e1, Pt p1)
+{
+  if (c->nsegs == c->segsz) {
+    c->segsz = (c->segsz == 0) ? 256 : 2 * c->segsz;
+    c->segs = (ContourSegment *) realloc(c->segs,
+                                         c->segsz * sizeof(ContourSegment));
+    CHECK_OOM(c->segs, "contour_add");
+  }
+  c->segs[c->nsegs].edge[0] = e0;
+  c->segs[c->nsegs].end[0] = p0;
+  c->segs[c->nsegs].edge[1] = e1;
+  c->segs[c->nsegs].end[1] = p1;
+  ++c->nsegs;
+}
+
+static void contour_row(Contour *c, size_t nx, size_t r, const double *xs,
+                        double y0, double y1,
+                        const double *f0, const double *f1)
+/* Finds the segments in the row of cells between grid rows r and r+1,
+   which have ordinate y0 and y1 and samples f0 and f1. */
+{
+  size_t i, k, n, e[4];
+  Pt p[4];
+  double fc;
+
+  for (i = 0; i + 1 < nx; i++) {
+    double bl = f0[i], br = f0[i+1], tl = f1[i], tr = f1[i+1];
+    if (!(contour_usable(bl) && contour_usable(br)
+          && contour_usable(tl) && contour_usable(tr)))
+      continue;
+
+    /* The edges are numbered so that neighboring cells agree: horizontal
+       edges get even numbers and vertical edges odd numbers.  They are
+       listed here in counterclockwise order from the bottom. */
+    n = 0;
+    if (NEGATIVE(bl) != NEGATIVE(br)) {
+      e[n] = 2*(r*nx + i);
+      p[n++] = contour_zero(xs[i], y0, bl, xs[i+1], y0, br);
+    }
+    if (NEGATIVE(br) != NEGATIVE(tr)) {
+      e[n] = 2*(r*nx + i + 1) + 1;
+      p[n++] = contour_zero(xs[i+1], y0, br, xs[i+1], y1, tr);
+    }
+    if (NEGATIVE(tl) != NEGATIVE(tr)) {
+      e[n] = 2*((r+1)*nx + i);
+      p[n++] = contour_zero(xs[i], y1, tl, xs[i+1], y1, tr);
+    }
+    if (NEGATIVE(bl) != NEGATIVE(tl)) {
+      e[n] = 2*(r*nx + i) + 1;
+      p[n++] = contour_zero(xs[i], y0, bl, xs[i], y1, tl);
+    }
+    if (n == 2) {
+      contour_add(c, e[0], p[0], e[1], p[1]);
+    } else if (n == 4) {
+      /* A saddle.  The average of the four corners, which is the
+         bilinear interpolant's value at the center, decides whether the
+         bottom left and top right corners are connected, in which case
+         we cut off the other two corners. */
+      fc = 0.25 * (bl + br + tl + tr);
+      k = (NEGATIVE(fc) == NEGATIVE(bl)) ? 0 : 1;
+      if (k == 0) {
+        contour_add(c, e[0], p[0], e[1], p[1]);  /* around br */
+        contour_add(c, e[2], p[2], e[3], p[3]);  /* around tl */
+      } else {
+        contour_add(c, e[3], p[3], e[0], p[0]);  /* around bl */
+        contour_add(c, e[1], p[1], e[2], p[2]);  /* around tr */
+      }
+    }
+  }
+}
+
+static int contour_inside(ConxModlType modl, double x, double y)
+{
+  return (modl == CONX_POINCARE_UHP) ? (y > 0.0) : (sqr(x) + sqr(y) < 1.0);
+}
+
+static void contour_sample(ConxBatchMetric *test, void *testArg,
+                           ConxModlType modl, size_t nx, const double *xs,
+                           double y, double *xbuf, double *ybuf,
+                           double *fbuf, double *f)
+/* Sets f[i] to the metric at (xs[i], y), or to CONTOUR_OUTSIDE if that
+   point is not strictly inside the model. */
+{
+  size_t i, n = 0;
+
+  for (i = 0; i < nx; i++) {
+    if (contour_inside(modl, xs[i], y)) {
+      xbuf[n] = xs[i];
+      ybuf[n++] = y;
+    }
+  }
+  if (n > 0) (*test)(xbuf, ybuf, fbuf, n, testArg);
+  for (i = 0, n = 0; i < nx; i++) {
+    f[i] = contour_inside(modl, xs[i], y) ? fbuf[n++] : CONTOUR_OUTSIDE;
+  }
+}
+
+static int contour_end_cmp(const void *a, const void *b)
+{
+  size_t ea = ((const ContourEnd *) a)->edge;
+  size_t eb = ((const ContourEnd *) b)->edge;
+  return (ea < eb) ? -1 : ((ea > eb) ? 1 : 0);
+}
+
+static void contour_refine(const Contour *c, ConxPtBuffer *b)
+/* Takes one Newton step from each of b's points toward the curve, unless
+   that would move it farther than a linear interpolant could be off. */
+{
+  double *x, *y, *f, *gx, *gy, g2, step;
+  size_t i, n = b->n;
+
+  x = (double *) malloc(5 * n * sizeof(double));
+  CHECK_OOM(x, "contour_refine");
+  y = x + n; f = y + n; gx = f + n; gy = gx + n;
+  for (i = 0; i < n; i++) {
+    x[i] = b->pts[i].x;
+    y[i] = b->pts[i].y;
+  }
+  (*c->grad)(x, y, f, gx, gy, n, c->gradArg);
+  for (i = 0; i < n; i++) {
+    g2 = sqr(gx[i]) + sqr(gy[i]);
+    if (!(g2 > 0.0) || !contour_usable(f[i])) continue;
+    step = myabs(f[i]) / sqrt(g2);
+    if (!(step < c->maxstep)) continue;
+    b->pts[i].x -= f[i] * gx[i] / g2;
+    b->pts[i].y -= f[i] * gy[i] / g2;
+  }
+  free(x);
+}
+
+static void contour_walk(const Contour *c, const size_t *partner,
+                         char *done, size_t s, size_t e, ConxPtBuffer *b,
+                         ConxPolylineFunc *lfunc, void *lArg)
+/* Emits the polyline that starts at end e of segment s. */
+{
+  size_t k;
+
+  b->n = 0;
+  conx_ptbuf_append(c->segs[s].end[e].x, c->segs[s].end[e].y, b);
+  for (;;) {
+    done[s] = 1;
+    conx_ptbuf_append(c->segs[s].end[1-e].x, c->segs[s].end[1-e].y, b);
+    k = partner[2*s + 1 - e];
+    if (k == CONTOUR_NO_PARTNER || done[k/2]) break;
+    s = k/2;
+    e = k%2;
+  }
+  if (c->grad != NULL) contour_refine(c, b);
+  (*lfunc)(b->pts, b->n, lArg);
+}
+
+static void contour_stitch(const Contour *c, ConxPolylineFunc *lfunc,
+                           void *lArg)
+/* Joins the segments end to end and emits the polylines, first those that
+   have two ends and then the closed ones. */
+{
+  ContourEnd *ends;
+  size_t *partner, i, n = 2 * c->nsegs;
+  char *done;
+  ConxPtBuffer b;
+
+  if (c->nsegs == 0) return;
+  ends = (ContourEnd *) malloc(n * sizeof(ContourEnd));
+  partner = (size_t *) malloc(n * sizeof(size_t));
+  done = (char *) calloc(c->nsegs, 1);
+  CHECK_OOM(ends, "contour_stitch");
+  CHECK_OOM(partner, "contour_stitch");
+  CHECK_OOM(done, "contour_stitch");
+  for (i = 0; i < n; i++) {
+    ends[i].edge = c->segs[i/2].edge[i%2];
+    ends[i].which = i;
+    partner[i] = CONTOUR_NO_PARTNER;
+  }
+  /* Each edge is shared by at most two cells, and each cell has at most
+     one segment ending on a given edge. */
+  qsort(ends, n, sizeof(ContourEnd), contour_end_cmp);
+  for (i = 0; i + 1 < n; i++) {
+    if (ends[i].edge == ends[i+1].edge) {
+      partner[ends[i].which] = ends[i+1].which;
+      partner[ends[i+1].which] = ends[i].which;
+      ++i;
+    }
+  }
+  free(ends);
+
+  conx_ptbuf_init(&b);
+  for (i = 0; i < n; i++) {
+    if (partner[i] == CONTOUR_NO_PARTNER && !done[i/2])
+      contour_walk(c, partner, done, i/2, i%2, &b, lfunc, lArg);
+  }
+  for (i = 0; i < c->nsegs; i++) {
+    if (!done[i])
+      contour_walk(c, partner, done, i, 0, &b, lfunc, lArg);
+  }
+  conx_ptbuf_free(&b);
+  free(partner);
+  free(done);
+}
+
+void conx_contour(ConxBatchMetric *test, ConxBatchGradient *grad,
+                  void *testArg, ConxModlType modl,
+                  double delta_x, double delta_y,
+                  double x_min, double x_max, double y_min, double y_max,
+                  ConxPolylineFunc *lfunc, void *lArg)
+/* Finds the curve on which the function *test is zero in the viz area,
+   sampling *test on a grid with spacing delta_x by delta_y, and calls
+   (*lfunc)(pts, n, lArg) for each of the polylines that make up the curve.
+   A closed polyline ends where it starts.  *test is given a row of the
+   grid at a time.  If grad is not NULL, it gives the same metric and its
+   gradient, and each polyline's vertices are refined with it.
+*/
+{
+  size_t nx, ny, i, i0, j, j0;
+  double *xs, *xbuf, *ybuf, *fbuf, *f0, *f1, *tmp;
+  Contour c;
+
+  /* The grid is the LONGWAY method's lattice.  In the disks, its rows are
+     those of the column x == 0, which is the tallest. */
+  nx = conx_lattice_columns(modl, delta_x, x_min, x_max, &i0);
+  ny = conx_lattice_column(modl, 0.0, delta_y, y_min, y_max, &j0);
+  if (nx == 0 || ny == 0) return;
+  xs = (double *) malloc(6 * nx * sizeof(double));
+  CHECK_OOM(xs, "conx_contour");
+  xbuf = xs + nx;
+  ybuf = xbuf + nx;
+  fbuf = ybuf + nx;
+  f0 = fbuf + nx;
+  f1 = f0 + nx;
+  for (i = 0; i < nx; i++)
+    xs[i] = CONX_LATTICE_COORD(x_min, delta_x, i0 + i);
+
+  c.segs = NULL;
+  c.nsegs = c.segsz = 0;
+  c.grad = grad;
+  c.gradArg = testArg;
+  c.maxstep = 0.5 * lesser(delta_x, delta_y);
+  contour_sample(test, testArg, modl, nx, xs,
+                 CONX_LATTICE_COORD(y_min, delta_y, j0), xbuf, ybuf, fbuf, f1);
+  for (j = 1; j < ny; j++) {
+    tmp = f0; f0 = f1; f1 = tmp;
+    contour_sample(test, testArg, modl, nx, xs,
+                   CONX_LATTICE_COORD(y_min, delta_y, j0 + j),
+                   xbuf, ybuf, fbuf, f1);
+    contour_row(&c, nx, j-1, xs,
+                CONX_LATTICE_COORD(y_min, delta_y, j0 + j - 1),
+                CONX_LATTICE_COORD(y_min, delta_y, j0 + j), f0, f1);
+  }
+  free(xs);
+  contour_stitch(&c, lfunc, lArg);
+  if (c.segs != NULL) free(c.segs);
+}
@@ -29,6 +29,7 @@
 
 #include "dgeomobj.hh"
 #include "canvas.hh"
+#include "kernels.hh"
 
 
 NF_INLINE
@@ -50,20 +51,39 @@ void CConxDwGeomObj::drawOn(CConxCanvas &cv) const throw(int)
 
   // DLC test requiresHeavyComputation() and make a display list (maybe not
   // in this function).
-  if (P == NULL) throw 38;
-  cv.setDrawingColor(getColor());
-  cv.setPointSize(getThickness());
-  if (getGarnishing()) {
-    P->drawGarnishOn(cv);
-  }
+  beginDrawing(cv);
   switch (getDrawingMethod()) {
   case LONGWAY:
   case SAFEST:
     drawLongway(cv, *P);
     break;
+  case QUADTREE:
+    (void) drawQuadtree(cv, *P);
+    break;
+  case CONTOUR:
+    drawContour(cv, *P);
+    break;
   case BRESENHAM:
   case BEST:
+    cv.setMetricPrecision(getPrecision());
+    P->drawBresenhamOn(cv);
+    cv.setMetricPrecision(CONX_PRECISE);
+    break;
+  case TRACER:
+    // Like BRESENHAM, but curves are followed by conx_trace().
+    cv.setMetricPrecision(getPrecision());
+    cv.setCurveTracing(TRUE);
     P->drawBresenhamOn(cv);
+    cv.setCurveTracing(FALSE);
+    cv.setMetricPrecision(CONX_PRECISE);
+    break;
+  case POLAR:
+    // Artists that are not star-shaped about a point are drawn as for
+    // BRESENHAM.
+    cv.setMetricPrecision(getPrecision());
+    if (!P->drawPolarOn(cv))
+      P->drawBresenhamOn(cv);
+    cv.setMetricPrecision(CONX_PRECISE);
     break;
   }
 
@@ -71,14 +91,109 @@ void CConxDwGeomObj::drawOn(CConxCanvas &cv) const throw(int)
 }
 
 NF_INLINE
-double CConxDwGeomObj::longwayMetric(Pt x, void *t)
+void CConxDwGeomObj::beginDrawing(CConxCanvas &cv) const throw(int)
+// Sets up cv for drawing P and draws P's garnish.
+{
+  if (P == NULL) throw 38;
+  cv.setDrawingColor(getColor());
+  cv.setPointSize(getThickness() * (double) cv.getCoarseness());
+  if (getGarnishing()) {
+    P->drawGarnishOn(cv);
+  }
+}
+
+NF_INLINE
+const CConxDwGeomObj *CConxDwGeomObj::getFusibleLongway() const
+// Artists that the field rasters draw are not fused, since thresholding a
+// raster is cheaper still.
+{
+  if (P == NULL) return NULL;
+  if (getDrawingMethod() != LONGWAY && getDrawingMethod() != SAFEST)
+    return NULL;
+  if (getFieldCaching() && P->hasDefiningField()) return NULL;
+  return this;
+}
+
+NF_INLINE
+void CConxDwGeomObj::findFusedHits(CConxCanvas &cv,
+                                   const CConxDwGeomObj *const *d, size_t n,
+                                   char **hits)
+{
+  const ConxLattice &L = cv.getAtlas(cv.getModel());
+  uint i, t, nthreads = cv.getNumThreads();
+  size_t j;
+  double o = 0.0, f;
+
+  // Thread t evaluates d[j]'s artist at scratch[t*n + j]'s CConxPoint.
+  LongwayScratch *scratch = new LongwayScratch[nthreads * n];
+  void **args = new void *[nthreads * n];
+  double *tlrances = new double[n];
+  if (scratch == NULL || args == NULL || tlrances == NULL) OOM();
+  for (j = 0; j < n; j++) {
+    assert(d[j]->getFusibleLongway() == d[j]);
+    d[j]->saveLongwayModel(CONX_KLEIN_DISK); // The atlas's coordinates
+    tlrances[j] = d[j]->getLongwayTolerance();
+    for (t = 0; t < nthreads; t++) {
+      i = t * n + j;
+      scratch[i].self = d[j];
+      scratch[i].tlrance = tlrances[j];
+      args[i] = scratch + i;
+    }
+    // Fill the artist's caches while there is only one thread; see
+    // drawLongway().
+    if (nthreads > 1) longwayMetric(&o, &o, &f, 1, scratch + j);
+  }
+  conx_lattice_longway_fused(longwayMetric, args, n, nthreads, tlrances, &L,
+                             hits);
+  delete [] tlrances;
+  delete [] args;
+  delete [] scratch;
+}
+
+NF_INLINE
+void CConxDwGeomObj::drawFusedHits(CConxCanvas &cv, const char *hits) const
+  throw(int)
+{
+  const ConxLattice &L = cv.getAtlas(cv.getModel());
+  size_t i, k, last;
+
+  beginDrawing(cv);
+  cv.beginDraw(cv.POINTS);
+  for (i = 0; i < L.ncols; i++) {
+    last = L.start[i] + L.count[i];
+    for (k = L.start[i]; k < last; k++) {
+      if (hits[k]) cv.drawVertex(L.xs[i], L.ys[k]);
+    }
+  }
+  cv.endDraw();
+}
+
+NF_INLINE
+void CConxDwGeomObj::longwayMetric(const double *x, const double *y,
+                                   double *f, size_t n, void *t)
 {
-  // DLC static object, affects instance count (debugging is harder)
-  static CConxPoint sPoint;
   assert(t != NULL);
-  assert(((const CConxDwGeomObj *)t)->P != NULL);
-  sPoint.setPoint(x, ((const CConxDwGeomObj *)t)->getLongwaySavedModel());
-  return (((const CConxDwGeomObj *)t)->P)->definingFunction(sPoint);
+  LongwayScratch *s = (LongwayScratch *) t;
+  assert(s->self->P != NULL);
+  if (s->self->getPrecision() == CONX_COMPARE && s->tlrance > 0.0)
+    (s->self->P)->thresholdFunctions(x, y, n,
+                                     s->self->getLongwaySavedModel(),
+                                     s->tlrance, f, s->X);
+  else
+    (s->self->P)->definingFunctions(x, y, n, s->self->getLongwaySavedModel(),
+                                    f, s->X, s->self->getPrecision());
+}
+
+NF_INLINE
+void CConxDwGeomObj::longwayGradient(const double *x, const double *y,
+                                     double *f, double *gx, double *gy,
+                                     size_t n, void *t)
+{
+  assert(t != NULL);
+  LongwayScratch *s = (LongwayScratch *) t;
+  assert(s->self->P != NULL);
+  (s->self->P)->definingGradients(x, y, n, s->self->getLongwaySavedModel(),
+                                  f, gx, gy, s->X);
 }
 
 NF_INLINE
@@ -87,27 +202,174 @@ void CConxDwGeomObj::longwayDrawVertex(double a, double b, void *t)
   (((const CConxDwGeomObj *)t)->getStoredCanvas())->drawVertex(a, b);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Draws by the LONGWAY method once conxWithArtistMetric() has found the
+// metric of the artist's class: by conxLatticeLongway() with one thread,
+// or by conx_lattice_longway_sink() with a copy of the metric per thread.
+class CConxLongwayKernel {
+public:
+  CConxLongwayKernel(size_t n, double t, const ConxLattice &l,
+                     ConxVertexSink *s)
+    : nthreads(n), tlrance(t), L(l), sink(s) { }
+  template <class M> void run(M &m)
+  {
+    if (nthreads == 1) {
+      CConxSinkCall s(sink);
+      conxLatticeLongway(m, tlrance, L, s);
+      return;
+    }
+    // The artist caches things like its points' Klein coordinates in
+    // mutable members.  Fill those caches now, while there is only one
+    // thread, so that the threads only read them.
+    double o = 0.0, f;
+    m(&o, &o, &f, 1);
+    CConxThreadMetrics< M > ms(m, nthreads);
+    conx_lattice_longway_sink(ms.call, ms.getArgs(), nthreads, tlrance, &L,
+                              sink);
+  }
+
+private:
+  size_t nthreads;
+  double tlrance;
+  const ConxLattice &L;
+  ConxVertexSink *sink;
+}; // class CConxLongwayKernel
+
 NF_INLINE
 void CConxDwGeomObj::drawLongway(CConxCanvas &cv,
                                  const CConxSimpleArtist &o) const
 {
-  saveLongwayModel(cv.getModel());
+  if (getFieldCaching() && o.hasDefiningField()) {
+    drawFieldRaster(cv, o);
+    return;
+  }
+  // The atlas gives longwayMetric Klein coordinates.
+  const ConxLattice &L = cv.getAtlas(cv.getModel());
+  saveLongwayModel(CONX_KLEIN_DISK);
   // DLC  CONX_BEGIN_DISP_LIST(dl);
   cv.beginDraw(cv.POINTS);
+  // The points reach the canvas CONX_SINK_SIZE at a time.
+  Pt pts[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, CConxCanvas::sinkVertices,
+                 (CConxDrawCanvas *) &cv);
+
+  // The artist's defining function is called without a virtual function
+  // call, and with one thread the sink is inlined into the scan too.  This
+  // draws what conx_lattice_longway_sink() with longwayMetric would.
+  uint i, n = cv.getNumThreads();
+  CConxLongwayKernel k(n, getLongwayTolerance(), L, &sink);
+  if (conxWithArtistMetric(o, CONX_KLEIN_DISK, getPrecision(), k,
+                           getLongwayTolerance())) {
+    cv.endDraw();
+    return;
+  }
+
+  // We construct every thread's CConxPoint here because CConxObject's
+  // constructors are not thread-safe.
+  LongwayScratch *scratch = new LongwayScratch[n];
+  void **args = new void *[n];
+  if (scratch == NULL || args == NULL) OOM();
+  for (i = 0; i < n; i++) {
+    scratch[i].self = this;
+    scratch[i].tlrance = getLongwayTolerance();
+    args[i] = scratch + i;
+  }
+  if (n > 1) {
+    // Fill the artist's caches, as CConxLongwayKernel does.
+    double o = 0.0, f;
+    longwayMetric(&o, &o, &f, 1, scratch);
+  }
+  conx_lattice_longway_sink(longwayMetric, args, n, getLongwayTolerance(),
+                            &L, &sink);
+  delete [] args;
+  delete [] scratch;
+  cv.endDraw();
+  // DLC  CONX_END_DISP_LIST(dl);
+}
+
+NF_INLINE
+size_t CConxDwGeomObj::drawQuadtree(CConxCanvas &cv,
+                                    const CConxSimpleArtist &o) const
+{
+  const ConxLattice &L = cv.getAtlas(cv.getModel());
+  saveLongwayModel(CONX_KLEIN_DISK);
+  cv.beginDraw(cv.POINTS);
+  storeCanvas(&cv);
+#ifdef HAVE_CONST_CAST
+  CConxDwGeomObj *constlessThis = const_cast< CConxDwGeomObj * >( this );
+#else
+  CConxDwGeomObj *constlessThis = this;
+#endif
+  LongwayScratch scratch;
+  scratch.self = this;
+  scratch.tlrance = 0.0; // Skipping regions needs exact values.
+  size_t evaluations
+    = conx_longway_quadtree(longwayMetric, &scratch,
+                            o.getLipschitzConstant(), cv.getModel(),
+                            getLongwayTolerance(), &L,
+                            longwayDrawVertex, constlessThis);
+  removeStoredCanvas();
+  cv.endDraw();
+  return evaluations;
+}
+
+NF_INLINE
+void CConxDwGeomObj::drawFieldRaster(CConxCanvas &cv,
+                                     const CConxSimpleArtist &o) const
+{
+  // The raster outlives our tolerance, so CONX_COMPARE cannot help.
+  const CConxCanvas::FieldRaster &r
+    = cv.getFieldRaster(o, (getPrecision() == CONX_FAST) ? CONX_FAST
+                                                          : CONX_PRECISE);
+  const ConxLattice &L = cv.getAtlas(cv.getModel());
+  double s = o.definingScalar(), tol = getLongwayTolerance();
+  size_t i, k, last;
+
+  // This is the same test, in the same order, that the LONGWAY method
+  // makes, since the defining function is exactly the field minus s.
+  cv.beginDraw(cv.POINTS);
+  for (i = 0; i < L.ncols; i++) {
+    last = L.start[i] + L.count[i];
+    for (k = L.start[i]; k < last; k++) {
+      if (myabs(((r.g != NULL) ? r.g[k] : (double) r.gf[k]) - s) < tol)
+        cv.drawVertex(L.xs[i], L.ys[k]);
+    }
+  }
+  cv.endDraw();
+}
+
+NF_INLINE
+void CConxDwGeomObj::contourDrawPolyline(const Pt *pts, size_t n, void *t)
+{
+  CConxCanvas *cv = ((const CConxDwGeomObj *)t)->getStoredCanvas();
+  cv->beginDraw(cv->LINE_STRIP);
+  cv->drawVertices(pts, n);
+  cv->endDraw();
+}
+
+NF_INLINE
+void CConxDwGeomObj::drawContour(CConxCanvas &cv,
+                                 const CConxSimpleArtist &o) const
+{
+  if (!o.hasSignedDefiningFunction()) {
+    drawLongway(cv, o);
+    return;
+  }
+  saveLongwayModel(cv.getModel());
   storeCanvas(&cv);
 #ifdef HAVE_CONST_CAST
   CConxDwGeomObj *constlessThis = const_cast< CConxDwGeomObj * >( this );
 #else
   CConxDwGeomObj *constlessThis = this;
 #endif
-  conx_longway(longwayMetric, constlessThis, cv.getModel(),
-               getLongwayTolerance(),
+  LongwayScratch scratch;
+  scratch.self = this;
+  conx_contour(longwayMetric, longwayGradient, &scratch, cv.getModel(),
                cv.getPixelWidth(), cv.getPixelHeight(),
                cv.getXmin(), cv.getXmax(), cv.getYmin(), cv.getYmax(),
-               longwayDrawVertex, constlessThis);
+               contourDrawPolyline, constlessThis);
   removeStoredCanvas();
-  cv.endDraw();
-  // DLC  CONX_END_DISP_LIST(dl);
 }
 
 NF_INLINE
@@ -144,6 +406,16 @@ CConxDwGeomObj::CConxDwGeomObj(const CConxDwGeomObj &o)
   uninitializedCopy(o);
 }
 
+NF_INLINE
+CConxArtist *CConxDwGeomObj::movedClone(const ConxIsometry &g) const
+{
+  CConxDwGeomObj *j = new CConxDwGeomObj(*this);
+  if (j == NULL) OOM();
+  if (j->P != NULL) j->P->moveBy(g);
+  j->setValidity(FALSE);
+  return j;
+}
+
 NF_INLINE
 int CConxDwGeomObj::operator==(const CConxDwGeomObj &o) const
 {
@@ -152,6 +424,7 @@ int CConxDwGeomObj::operator==(const CConxDwGeomObj &o) const
           && getThickness() == o.getThickness()
           && getLongwayTolerance() == o.getLongwayTolerance()
           && getDrawingMethod() == o.getDrawingMethod()
+          && getPrecision() == o.getPrecision()
           && ((P == NULL && o.P == NULL)
               || (P != NULL && o.P != NULL && P->eql(*o.P))));
 }
@@ -227,7 +500,7 @@ ostream &CConxDwGeomObj::printOn(ostream &o) const
   o << ", isValid=" << BOOLE2STRING(isValid) << ", withGarnish="
     << BOOLE2STRING(withGarnish) << ", drawingMethod="
     << drawingMethodToString(dm) << ", thickness=" << thickness
-    << ", lwtol=" << lwtol
+    << ", lwtol=" << lwtol << ", precision=" << prec
     << ">";
   return o;
 }
@@ -239,6 +512,10 @@ const char *CConxDwGeomObj::drawingMethodToString(DrawingMethod m)
   case SAFEST: return "SAFEST";
   case BRESENHAM: return "BRESENHAM";
   case LONGWAY: return "LONGWAY";
+  case QUADTREE: return "QUADTREE";
+  case CONTOUR: return "CONTOUR";
+  case TRACER: return "TRACER";
+  case POLAR: return "POLAR";
   default: assert(m == BEST); return "BEST";
   }
 }
@@ -277,6 +554,8 @@ void CConxDwGeomObj::init()
   color = CConxNamedColor::GREEN;
   isValid = FALSE;
   withGarnish = TRUE;
+  cachesField = TRUE;
+  prec = CONX_PRECISE;
   dm = BEST;
   thickness = 1.0;
   lwtol = .0015;
@@ -296,6 +575,8 @@ void CConxDwGeomObj::uninitializedCopy(const CConxDwGeomObj &o)
   color = o.color;
   isValid = o.isValid;
   withGarnish = o.withGarnish;
+  cachesField = o.cachesField;
+  prec = o.prec;
   dm = o.dm;
   thickness = o.thickness;
   lwtol = o.lwtol;
@@ -49,6 +49,7 @@
 typedef unsigned long SDID;
 
 class CConxCanvas;
+class CConxDwGeomObj;
 
 //////////////////////////////////////////////////////////////////////////////
 // An abstract class that has a virtual
@@ -76,6 +77,12 @@ public:
     if (j == NULL) OOM();
     return j;
   }
+  // Returns a copy, which you must delete, of this artist moved by the
+  // isometry g; see CConxSimpleArtist::moveBy().
+  virtual CConxArtist *movedClone(const ConxIsometry &g) const
+  {
+    return aClone();
+  }
   CConxArtist() { }
   CConxArtist(const CConxArtist &o) : CConxObject(o) { }
   CConxArtist &operator=(const CConxArtist &o);
@@ -89,6 +96,11 @@ public:
   // loop.
   ostream &printOn(ostream &o, ConxModlType m) const { return printOn(o); }
   void drawOn(class CConxCanvas &o) const;
+
+  // Returns non-NULL if drawOn() would evaluate a defining function at
+  // each point of the canvas's atlas, in which case CConxCanvas::masterDraw()
+  // may instead evaluate it in one sweep with the other artists'.
+  virtual const CConxDwGeomObj *getFusibleLongway() const { return NULL; }
 }; // class CConxArtist
 
 
@@ -112,7 +124,9 @@ public:
 class CConxDwGeomObj : VIRT public CConxArtist {
   CCONX_CLASSNAME("CConxDwGeomObj")
 public: // types
-  enum DrawingMethod { SAFEST, BRESENHAM, LONGWAY, BEST };
+  enum DrawingMethod {
+    SAFEST, BRESENHAM, LONGWAY, BEST, QUADTREE, CONTOUR, TRACER, POLAR
+  };
 public:
   CConxArtist *aClone() const
   {
@@ -120,6 +134,7 @@ public:
     if (j == NULL) OOM();
     return j;
   }
+  CConxArtist *movedClone(const ConxIsometry &g) const;
   CConxDwGeomObj(CConxSimpleArtist *p);
   CConxDwGeomObj(const CConxSimpleArtist &p);
   CConxDwGeomObj() { init(); }
@@ -140,6 +155,21 @@ public:
   virtual void setGarnishing(Boole g);
   virtual DrawingMethod getDrawingMethod() const { return dm; }
   virtual void setDrawingMethod(DrawingMethod m);
+  // If TRUE, the LONGWAY method uses the canvas's raster of our artist's
+  // field when the artist has one (see CConxCanvas::getFieldRaster()), so
+  // that only the first drawing of a field evaluates it.
+  virtual Boole getFieldCaching() const { return cachesField; }
+  virtual void setFieldCaching(Boole c) { cachesField = c; }
+  // CONX_FAST evaluates our artist's defining function in single precision
+  // where that is safe, whatever the drawing method, and keeps its field
+  // raster in floats.  The TRACER method's corrector needs gradients,
+  // which are always in double precision.  A few pixels on the edge of the tolerance may
+  // differ from what CONX_PRECISE draws.  CONX_COMPARE draws what
+  // CONX_PRECISE does, but the LONGWAY method evaluates our artist's
+  // thresholdFunctions(), which skips most acosh calls for points and
+  // circles and ellipses.
+  virtual ConxPrecision getPrecision() const { return prec; }
+  virtual void setPrecision(ConxPrecision p) { setValidity(FALSE); prec = p; }
   ostream &printOn(ostream &o) const;
   ostream &printOn(ostream &o, ConxModlType m) const { return printOn(o); }
   static const char *drawingMethodToString(DrawingMethod m);
@@ -156,6 +186,15 @@ public:
 
   void drawOn(CConxCanvas &cv) const throw(int);
 
+  const CConxDwGeomObj *getFusibleLongway() const;
+  // Sets hits[j][k] to 1 if the artist of d[j] is drawn at the point k of
+  // cv's atlas, and to 0 otherwise, evaluating the n artists' defining
+  // functions in one sweep of the atlas.  Each d[j] must be fusible.
+  static void findFusedHits(CConxCanvas &cv, const CConxDwGeomObj *const *d,
+                            size_t n, char **hits);
+  // Draws what drawOn() would, given hits from findFusedHits().
+  void drawFusedHits(CConxCanvas &cv, const char *hits) const throw(int);
+
   // DLC avoid run-time type identification by providing a `virtual TypeIdEnum whoAmI()' method
   // DLC add CConxString identifier
 
@@ -166,16 +205,42 @@ protected:
   void storeCanvas(CConxCanvas *c) const { sc = c; }
   void removeStoredCanvas() const { sc = NULL; }
   void drawLongway(CConxCanvas &cv, const CConxSimpleArtist &o) const;
+  // Draws the same points as drawLongway, but skips regions that are
+  // provably far from the curve.  Returns the number of points at which
+  // o's defining function was evaluated.
+  size_t drawQuadtree(CConxCanvas &cv, const CConxSimpleArtist &o) const;
+  // Draws the curve as LINE_STRIPs through interpolated zeroes of o's
+  // defining function, or by the LONGWAY method if o's defining function
+  // is not signed.
+  void drawContour(CConxCanvas &cv, const CConxSimpleArtist &o) const;
+  // Draws what drawLongway would by thresholding a raster of o's field.
+  void drawFieldRaster(CConxCanvas &cv, const CConxSimpleArtist &o) const;
 
   // We need this to send to the longway method, but it must use stored
-  // information.
-  static double longwayMetric(Pt x, void *t);
+  // information.  t is a LongwayScratch *.  This is a ConxBatchMetric.
+  static void longwayMetric(const double *x, const double *y, double *f,
+                            size_t n, void *t);
+  // The same, with gradients.  This is a ConxBatchGradient.
+  static void longwayGradient(const double *x, const double *y, double *f,
+                              double *gx, double *gy, size_t n, void *t);
+
+  // Each thread drawing by the LONGWAY method evaluates P's defining
+  // function at its own CConxPoint.
+  // tlrance is the LONGWAY tolerance against which longwayMetric's values
+  // are only compared, or zero if the values themselves matter.
+  struct LongwayScratch {
+    const CConxDwGeomObj *self;
+    double tlrance;
+    CConxPoint X;
+  };
 
   void saveLongwayModel(ConxModlType m) const { sModel = m; }
   ConxModlType getLongwaySavedModel() const { return sModel; }
 
 private: // operations
+  void beginDrawing(CConxCanvas &cv) const throw(int);
   static void longwayDrawVertex(double a, double b, void *t);
+  static void contourDrawPolyline(const Pt *pts, size_t n, void *t);
   void clear();
   void init();
   void uninitializedCopy(const CConxDwGeomObj &o);
@@ -185,7 +250,8 @@ private: // attributes
   mutable CConxCanvas *sc;
   CConxNamedColor color;
   Boole isValid;
-  Boole withGarnish;
+  Boole withGarnish, cachesField;
+  ConxPrecision prec;
   DrawingMethod dm;
   double thickness, lwtol;
   mutable ConxModlType sModel;
@@ -73,8 +73,10 @@ GLfloat conx_colors[][4] = {
 inline static
 void conx_gl_vertex2(double a, double b, void *ignored);
 inline static
+void conx_gl_vertices(const Pt *pts, size_t n, void *ignored);
+inline static
 void conx_gl_bres_trace(Pt middle, ConxDirection last, double dw, double dh,
-                        ConxMetric *func, void *fArg,
+                        ConxMetric *func, void *fArg, ConxBresMemo *memo,
                         ConxContinueFunc *keepgoing, void *kArg);
 
 
@@ -100,26 +102,41 @@ void conx_gl_vertex2(double a, double b, void *ignored)
   glVertex2f((GLfloat)a, (GLfloat)b);
 }
 
+void conx_gl_vertices(const Pt *pts, size_t n, void *ignored)
+/* A ConxVertexSink flush function; call between glBegin and glEnd. */
+{
+  size_t i;
+  for (i = 0; i < n; i++)
+    glVertex2dv(&pts[i].x);
+}
+
 void conx_gl_longway(ConxMetric *test, ConxModlType modl, double tlrance,
                      double delta_x, double delta_y,
                      double x_min, double x_max, double y_min, double y_max,
                      ConxDispList dl)
 {
+  ConxMetricAdapter a;
+  Pt pts[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+
+  a.func = test;
+  a.fArg = NULL;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_gl_vertices, NULL);
   CONX_BEGIN_DISP_LIST(dl);
   glBegin(GL_POINTS);
-  conx_longway(test, NULL, modl, tlrance, delta_x, delta_y, x_min, x_max,
-               y_min, y_max, conx_gl_vertex2, NULL);
+  conx_longway_sink(conx_batch_of_metric, &a, modl, tlrance,
+                    delta_x, delta_y, x_min, x_max, y_min, y_max, &sink);
   glEnd();
   FLUSH();
   CONX_END_DISP_LIST(dl);
 }
 
 void conx_gl_bres_trace(Pt middle, ConxDirection last, double dw, double dh,
-                        ConxMetric *func, void *fArg,
+                        ConxMetric *func, void *fArg, ConxBresMemo *memo,
                         ConxContinueFunc *keepgoing, void *kArg)
 {
   glBegin(GL_POINTS);
-  conx_bres_trace(middle, last, dw, dh, func, fArg, keepgoing, kArg,
+  conx_bres_trace(middle, last, dw, dh, func, fArg, memo, keepgoing, kArg,
                   conx_gl_vertex2, NULL);
   glEnd();
   FLUSH();
@@ -134,7 +151,8 @@ void conx_gl_bresenham(ConxBresenhamStarter *getB, ConxMetric *func,
   assert(getB != NULL);
   (*getB)(&LB, &RB);
   conx_bresenham(LB, RB, func, fArg,
-                 delta_x, delta_y, keepgoing, NULL, conx_gl_bres_trace);
+                 delta_x, delta_y, keepgoing, NULL, conx_gl_bres_trace,
+                 NULL);
   green();
   CONX_END_DISP_LIST(dl);
 }
@@ -163,10 +181,13 @@ void conx_gl_draw_arc(double x, double y, double r, double theta_1,
                       double theta_2, double tstp,
                       ConxPoint2DConverterFunc *converter, ConxDispList dl)
 {
+  Pt pts[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_gl_vertices, NULL);
   CONX_BEGIN_DISP_LIST(dl);
   glBegin(GL_LINE_STRIP);
-  conx_draw_arc(x, y, r, theta_1, theta_2, tstp, converter, conx_gl_vertex2,
-                NULL);
+  conx_draw_arc_sink(x, y, r, theta_1, theta_2, tstp, converter, &sink);
   glEnd();
   FLUSH();
   CONX_END_DISP_LIST(dl);
@@ -32,6 +32,7 @@
 #include <GL/glu.h>
 
 #include "glcanvas.hh"
+#include "kernels.hh"
 
 
 // DLC TODO add OpenGL error checking and throw if errors are found.
@@ -40,6 +41,52 @@
 
 Boole CConxGLCanvas::isInitialized = FALSE;
 
+// When to stop a Bresenham trace on glc; see CConxGLCanvas::bresKeepGoing().
+static CConxViewKeepGoing viewKeepGoing(const CConxGLCanvas &glc)
+{
+  return CConxViewKeepGoing(glc.getModel(), glc.getXmin(), glc.getXmax(),
+                            glc.getYmin(), glc.getYmax());
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Traces a curve once conxWithArtistMetric() has found the metric of the
+// artist's class: by conxBresenham() with one thread, or by
+// conx_bresenham_threaded() with a copy of the metric per thread.
+class CConxGLBresKernel {
+public:
+  CConxGLBresKernel(Pt l, Pt r, const CConxGLCanvas &glc, size_t n,
+                    ConxVertexSink *s)
+    : LB(l), RB(r), dw(glc.getPixelWidth()), dh(glc.getPixelHeight()),
+      nthreads(n), keepgoing(viewKeepGoing(glc)), sink(s) { }
+  template <class M> void run(M &m)
+  {
+    if (nthreads == 1) {
+      CConxSinkCall s(sink);
+      conxBresenham(LB, RB, dw, dh, m, keepgoing, s, (ConxBresStats *) NULL);
+      return;
+    }
+    // Fill the artist's caches while there is only one thread, as
+    // CConxDwGeomObj::drawLongway() does.
+    double g;
+    m(&LB.x, &LB.y, &g, 1);
+    CConxThreadMetrics< M > ms(m, nthreads);
+    conx_bresenham_threaded(LB, RB, ms.call, ms.getArgs(), nthreads,
+                            dw, dh, keepGoing, &keepgoing, sink, NULL);
+  }
+  // What CConxGLCanvas::bresKeepGoing() does, for the threads.
+  static int keepGoing(Pt middle, Pt oldmiddle, void *k)
+  {
+    return (*(CConxViewKeepGoing *) k)(middle, oldmiddle);
+  }
+
+private:
+  Pt LB, RB;
+  double dw, dh;
+  size_t nthreads;
+  CConxViewKeepGoing keepgoing;
+  ConxVertexSink *sink;
+}; // class CConxGLBresKernel
+
 NF_INLINE
 void CConxGLCanvas::drawByBresenham(const CConxPoint &lb, const CConxPoint &rb,
                                     DFN *f, const CConxSimpleArtist *sa)
@@ -48,9 +95,43 @@ void CConxGLCanvas::drawByBresenham(const CConxPoint &lb, const CConxPoint &rb,
   savedFooArg = sa;
   // DLC CONX_BEGIN_DISP_LIST(dl);
   assert(sa != NULL);
-  conx_bresenham(lb.getPt(getModel()), rb.getPt(getModel()), bresMetric, this,
-                 getPixelWidth(), getPixelHeight(),
-                 bresKeepGoing, this, bresTrace);
+
+  Pt LB = lb.getPt(getModel()), RB = rb.getPt(getModel());
+  Pt pts[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, sinkVertices,
+                 (CConxDrawCanvas *) this);
+  beginDraw(POINTS);
+  // The artist's defining function is called without a virtual function
+  // call, and with one thread the test for stopping and the sink are
+  // inlined into the tracer too.  This draws what conx_bresenham_batch()
+  // or conx_bresenham_threaded() with bresMetric would.
+  uint i, n = getNumThreads();
+  CConxGLBresKernel k(LB, RB, *this, n, &sink);
+  if (!conxWithArtistMetric(*sa, getModel(), getMetricPrecision(), k)) {
+    // We construct every thread's CConxPoint here because CConxObject's
+    // constructors are not thread-safe.
+    BresScratch *scratch = new BresScratch[n];
+    void **args = new void *[n];
+    if (scratch == NULL || args == NULL) OOM();
+    for (i = 0; i < n; i++) {
+      scratch[i].glc = this;
+      args[i] = scratch + i;
+    }
+    if (n > 1) {
+      double g;
+      bresMetric(&LB.x, &LB.y, &g, 1, scratch);
+      conx_bresenham_threaded(LB, RB, bresMetric, args, n,
+                              getPixelWidth(), getPixelHeight(),
+                              bresKeepGoing, this, &sink, NULL);
+    } else {
+      CConxBatchMetricCall m(bresMetric, scratch);
+      k.run(m);
+    }
+    delete [] args;
+    delete [] scratch;
+  }
+  endDraw();
   savedFoo = NULL;
   savedFooArg = NULL;
   // DLC  CONX_END_DISP_LIST(dl);
@@ -143,6 +224,8 @@ void CConxGLCanvas::beginDraw(DrawingType dt)
 // make either a new point or a vertex of a line or a vertex of a line strip.
 {
   assert(isInitialized);
+  recordBegin(dt);
+  drawing = dt;
   switch (dt) {
   case POINTS: glBegin(GL_POINTS); break;
   case LINE_STRIP: glBegin(GL_LINE_STRIP); break;
@@ -163,13 +246,37 @@ void CConxGLCanvas::drawVertex(double x, double y)
 // most recent beginDraw (in any instance of this class!)
 // This only works in between a beginDraw...endDraw()
 {
-  glVertex2d((GLdouble) x, (GLdouble) y);
+  Pt p;
+  p.x = x; p.y = y;
+  glVertex2dv(&recordVertices(&p, 1)->x);
+}
+
+NF_INLINE
+void CConxGLCanvas::drawVertices(const Pt *pts, size_t n)
+// Like drawVertex, n times.  Points go to OpenGL as one vertex array.
+// Lines cannot, since a batch may end in the middle of a line strip, so
+// they go one at a time but without a virtual call apiece.
+{
+  pts = recordVertices(pts, n);
+  if (drawing == POINTS) {
+    // glDrawArrays is not allowed between glBegin and glEnd.
+    glEnd();
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, sizeof(Pt), &pts[0].x);
+    glDrawArrays(GL_POINTS, 0, (GLsizei) n);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glBegin(GL_POINTS);
+  } else {
+    for (size_t i = 0; i < n; i++)
+      glVertex2dv(&pts[i].x);
+  }
 }
 
 NF_INLINE
 void CConxGLCanvas::setDrawingColor(const CConxColor &C)
 // Affects upcoming drawVertex calls (in any instance of this class!)
 {
+  recordColor(C);
   glColor3d((GLdouble)C.getR(), (GLdouble)C.getG(), (GLdouble)C.getB());
 }
 
@@ -179,6 +286,7 @@ void CConxGLCanvas::setPointSize(double pSize)
 // when you are drawing POINTS.  Call this before beginDraw().
 {
   assert(pSize > 0.0); // DLC
+  recordPointSize(pSize);
   if (pSize > 0.0) {
     glPointSize(pSize);
   }
@@ -257,43 +365,22 @@ void CConxGLCanvas::uninitializedCopy(const CConxGLCanvas &o)
   // do NOT share stored drawings.
   lowestSD = 3;
   highestSD = 2;
+  drawing = POINTS;
   // Do not allow initDraw to work for both. DLC?
 }
 
 NF_INLINE
-void CConxGLCanvas::bresVertex2(double a, double b, void *kArg)
-{
-  assert(kArg != NULL);
-  CConxGLCanvas *glc = (CConxGLCanvas *) kArg;
-  glc->drawVertex(a, b);
-}
-
-NF_INLINE
-double CConxGLCanvas::bresMetric(Pt middle, void *t)
+void CConxGLCanvas::bresMetric(const double *x, const double *y, double *f,
+                               size_t n, void *t)
 {
   assert(t != NULL);
-  CConxGLCanvas *glc = (CConxGLCanvas *)t;
+  BresScratch *s = (BresScratch *) t;
+  const CConxGLCanvas *glc = s->glc;
   assert(glc->savedFoo != NULL);
   assert(glc->savedFooArg != NULL);
-  static CConxPoint pt;
-  pt.setPoint(middle, glc->getModel());
-  return (*glc->savedFoo)(glc->savedFooArg, pt);
-  // DLC static point for a speed-up that makes debugging memory alloc a bit
-  // harder.
-}
-
-NF_INLINE
-void CConxGLCanvas::bresTrace(Pt middle, ConxDirection last,
-                              double dw, double dh,
-                              ConxMetric *func, void *fArg,
-                              ConxContinueFunc *keepgoing, void *kArg)
-{
-  assert(kArg != NULL);
-  CConxGLCanvas *glc = (CConxGLCanvas *) kArg;
-  glc->beginDraw(POINTS);
-  conx_bres_trace(middle, last, dw, dh, func, fArg, keepgoing, kArg,
-                  bresVertex2, kArg);
-  glc->endDraw();
+  // savedFoo is savedFooArg's definingFunction, so we can do this:
+  glc->savedFooArg->definingFunctions(x, y, n, glc->getModel(), f, s->X,
+                                      glc->getMetricPrecision());
 }
 
 NF_INLINE
@@ -301,17 +388,5 @@ int CConxGLCanvas::bresKeepGoing(Pt middle, Pt oldmiddle, void *t)
 {
   assert(t != NULL);
   CConxGLCanvas *glc = (CConxGLCanvas *) t;
-  ConxModlType saved_hgmodel = glc->getModel();
-  return (((saved_hgmodel != CONX_POINCARE_UHP)
-           ? (sqr(middle.x) + sqr(middle.y) < 1.0)
-           /* DLC what about xmin and xmax?  We can save time but may
-              have to reenter if we treat them correctly, the same
-              troubles as in the Poincare UHP. */
-           : ((middle.x < glc->getXmax())
-              && (middle.x > glc->getXmin())
-              && (middle.y < glc->getYmax())
-              && (middle.y > glc->getYmin())))
-          && (myabs(middle.x - oldmiddle.x) + myabs(middle.y - oldmiddle.y)
-              > ARBITRARILYSMALL)
-          );
+  return viewKeepGoing(*glc)(middle, oldmiddle);
 }
@@ -41,7 +41,7 @@ class CConxGLCanvas : VIRT public CConxCanvas {
   CCONX_CLASSNAME("CConxGLCanvas")
   DEFAULT_PRINTON()
 public:
-  CConxGLCanvas() : lowestSD(3), highestSD(2) { }
+  CConxGLCanvas() : lowestSD(3), highestSD(2), drawing(POINTS) { }
   CConxGLCanvas(const CConxGLCanvas &o);
   CConxGLCanvas &operator=(const CConxGLCanvas &o);
   ~CConxGLCanvas();
@@ -58,6 +58,7 @@ public:
   void beginDraw(DrawingType dt);
   void endDraw();
   void drawVertex(double x, double y);
+  void drawVertices(const Pt *pts, size_t n);
   void setDrawingColor(const CConxColor &C);
   void setPointSize(double pSize);
   void flushQueue();
@@ -69,16 +70,20 @@ public:
 
 private: // operations
   void uninitializedCopy(const CConxGLCanvas &o);
-  static void bresVertex2(double a, double b, void *kArg);
-  static double bresMetric(Pt middle, void *t);
-  static void bresTrace(Pt middle, ConxDirection last,
-                        double dw, double dh,
-                        ConxMetric *func, void *fArg,
-                        ConxContinueFunc *keepgoing, void *kArg);
+  // t is a BresScratch *.
+  static void bresMetric(const double *x, const double *y, double *f,
+                         size_t n, void *t);
 
   // The Bresenham method requires this to know when to stop.
   static int bresKeepGoing(Pt middle, Pt oldmiddle, void *t);
 
+  // Each thread tracing by the Bresenham method evaluates the artist's
+  // defining function at its own CConxPoint.
+  struct BresScratch {
+    CConxGLCanvas *glc;
+    CConxPoint X;
+  };
+
 
 private: // attributes
   // These are invalid if and only if highestSD < lowestSD.
@@ -86,6 +91,9 @@ private: // attributes
   SDID lowestSD;
   SDID highestSD;
 
+  // What the most recent beginDraw() began
+  DrawingType drawing;
+
   DFN *savedFoo;
   const CConxSimpleArtist *savedFooArg;
 
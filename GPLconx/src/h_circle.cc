@@ -104,60 +104,55 @@ void CConxCircle::drawGarnishOn(CConxCanvas &cv) const
 
 NF_INLINE
 void CConxCircle::drawBresenhamOn(CConxCanvas &cv) const
+// A hyperbolic circle is a Euclidean circle in the Poincare models and an
+// ellipse in the Klein disk, so we find its Euclidean center and radius or
+// its axes and let the canvas draw it.
 {
   ConxModlType modl = cv.getModel();
-
-  // The Poincare UHP and Poincare Disk
-  // circles are Euclidean circular, but their Euclidean center is not
-  // the same as the true, hyperbolic center.  We convert and draw the
-  // Euclidean circles.
-
-  // DLC implement like we do in conx_quickdraw_circle()
-  Pt uhpCenter = getCenter().getPt(CONX_POINCARE_UHP);
   double r = getRadius();
-  Pt uhpEuclideanCenter = { uhpCenter.x, myabs(uhpCenter.y * cosh(r)) };
-  // DLC explain this math in terms of the uhp distance metric.
-  double uhpEuclideanRadius = myabs(uhpCenter.y * sinh(r));
+
   if (modl == CONX_POINCARE_UHP) {
-    cv.drawCircle(uhpEuclideanCenter, uhpEuclideanRadius);
+    // DLC explain this math in terms of the uhp distance metric.
+    Pt uhpCenter = getCenter().getPt(CONX_POINCARE_UHP);
+    cv.drawCircle(uhpCenter.x, myabs(uhpCenter.y * cosh(r)),
+                  myabs(uhpCenter.y * sinh(r)));
+    return;
+  }
+
+  // The circle is symmetric about the line through the origin and its
+  // center, which is at distance s from the origin.  That line crosses it
+  // at distances s + r and s - r (the latter on the far side of the
+  // origin if r > s), i.e. at tanh((s +- r)/2) in the Poincare disk and
+  // tanh(s +- r) in the Klein disk.
+  double h[3];
+  if (!getCenter().getHyperboloid(h)) return;
+  double rho = sqrt(sqr(h[0]) + sqr(h[1]));
+  double s = log(rho + h[2]), ux = 1.0, uy = 0.0; // asinh(rho)
+  if (rho > 0.0) {
+    ux = h[0] / rho;
+    uy = h[1] / rho;
+  }
+  if (modl == CONX_POINCARE_DISK) {
+    double e1 = tanh((s + r) / 2.0), e2 = tanh((s - r) / 2.0);
+    cv.drawCircle((e1 + e2) / 2.0 * ux, (e1 + e2) / 2.0 * uy,
+                  (e1 - e2) / 2.0);
   } else {
-    // The Klein disk circle is not Euclidean-circular, but the Poincare Disk
-    // circle is. Luckily, it is roughly the same number of
-    // pixels as the Euclidean-circular circle in the Poincare Disk,
-    // so we can just find the
-    // points that correspond to those pixels, convert them to Klein Disk
-    // coordinates, and then draw them.  We might want to zoom in
-    // (xmin, xmax, ymin, ymax) on the Poincare disk so that we draw a few
-    // more points than we need, else we'll need to do
-    // a line strip and the accuracy may not be as high as you'd like.
-
-    // For now, we do the simpler trick of calculating the HG points on the
-    // Poincare UHP circle via the Euclidean equations
-    // ( x=uhpEuclideanCenter.x+uhpEuclideanRadius*cos(theta),
-    //   y=uhpEuclideanCenter.y+uhpEuclideanRadius*sin(theta)  )
-    // and then converting these uhp points to Klein disk or Poincare disk
-    // points.  To avoid the zooming in and out and still get a good-looking
-    // circle, we just use a small theta increment, smaller than is needed.
-
-    // DLC for greater efficiency, calculate the Euclidean center and
-    // radius of the Poincare Disk circle.  For now, we do what we do in
-    // the Klein disk.
-
-#define NUM_POINTS_PER_CIRCLE 1500.0
-    // A 1500-gon is going to be drawn, which will look pretty much like
-    // a smooth curve.
-
-    double thetaIncr = M_PI * 2.0 / NUM_POINTS_PER_CIRCLE;
-    cv.beginDraw(cv.LINE_STRIP);
-    CConxPoint pointOnTheCircle;
-    for (double theta = 0.0; theta < M_PI * 2.0; theta += thetaIncr) {
-      pointOnTheCircle.setPoint( \
-                         uhpEuclideanCenter.x+uhpEuclideanRadius*cos(theta), \
-                         uhpEuclideanCenter.y+uhpEuclideanRadius*sin(theta), \
-                         CONX_POINCARE_UHP);
-      cv.drawVertex(pointOnTheCircle.getPt(modl));
-    }
-    cv.endDraw();
+    // Points (u, v) of the Klein disk, with u along the line, satisfy
+    // (cosh s - u sinh s)^2 = cosh^2 r (1 - u^2 - v^2), an ellipse whose
+    // center m maximizes v.
+    double cs = cosh(s), ss = sinh(s), cr = cosh(r);
+    double m = ss * cs / (sqr(cr) + sqr(ss));
+    double b2 = 1.0 - sqr(m) - sqr((cs - ss * m) / cr);
+    cv.drawEllipse(m * ux, m * uy, (tanh(s + r) - tanh(s - r)) / 2.0,
+                   sqrt((b2 > 0.0) ? b2 : 0.0), atan2(uy, ux));
   }
 }
 
+
+NF_INLINE
+void CConxCircle::moveBy(const ConxIsometry &g)
+{
+  CConxPoint C = getCenter();
+  C.moveBy(g);
+  setCenter(C);
+}
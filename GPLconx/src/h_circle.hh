@@ -48,6 +48,54 @@ public:
   {
     return (getCenter().distanceFrom(X) - getRadius());
   }
+  double getLipschitzConstant() const { return 1.0; }
+  Boole hasSignedDefiningFunction() const { return TRUE; }
+  void definingFunctions(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f,
+                         CConxPoint &scratch,
+                         ConxPrecision prec = CONX_PRECISE) const
+  {
+    getCenter().distancesFrom(x, y, n, modl, f, prec);
+    for (size_t i = 0; i < n; i++)
+      f[i] -= getRadius();
+  }
+  void thresholdFunctions(const double *x, const double *y, size_t n,
+                          ConxModlType modl, double tol, double *f,
+                          CConxPoint &scratch) const
+  {
+    double lo = getRadius() - tol, hi = getRadius() + tol;
+    getCenter().distancesWithin(x, y, n, modl, lo, hi, f);
+    // lo - getRadius() may round to just less than tol in absolute value.
+    for (size_t i = 0; i < n; i++)
+      f[i] = (f[i] <= lo) ? -tol : ((f[i] >= hi) ? tol : f[i] - getRadius());
+  }
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const
+  {
+    getCenter().distanceGradientsFrom(x, y, n, modl, f, gx, gy);
+    for (size_t i = 0; i < n; i++)
+      f[i] -= getRadius();
+  }
+  Boole hasDefiningField() const { return TRUE; }
+  double definingScalar() const { return getRadius(); }
+  void definingFields(const double *x, const double *y, size_t n,
+                      ConxModlType modl, double *g, CConxPoint &scratch,
+                      ConxPrecision prec = CONX_PRECISE) const
+  {
+    getCenter().distancesFrom(x, y, n, modl, g, prec);
+  }
+  void definingFieldsf(const double *x, const double *y, size_t n,
+                       ConxModlType modl, float *g, CConxPoint &scratch) const
+  {
+    getCenter().distancesFromf(x, y, n, modl, g);
+  }
+  Boole sameField(const CConxSimpleArtist &o) const
+  {
+    return (o.getSAType() == SA_CIRCLE
+            && getCenter().isIdenticalTo(((const CConxCircle &) o)
+                                         .getCenter()));
+  }
   void setCenter(const CConxPoint &c) { setA(c); }
   const CConxPoint &getCenter() const { return getA(); }
   void setRadius(double r);
@@ -60,6 +108,7 @@ public:
 
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
   Boole requiresHeavyComputation() const { return TRUE; }
 }; // class CConxCircle
 // DLC TODO What is the HG area of a circle?
@@ -25,6 +25,8 @@
 #include <config.h>
 #endif
 
+#include <math.h>
+
 #include "hypmath.hh"
 #include "h_eqdist.hh"
 #include "cassert.h"
@@ -88,18 +90,125 @@ ostream &CConxEqDistCurve::printOn(ostream &o, ConxModlType modl) const
   return o;
 }
 
+NF_INLINE
+void CConxEqDistCurve::definingFields(const double *x, const double *y,
+                                      size_t n, ConxModlType modl,
+                                      double *g, CConxPoint &scratch,
+                                      ConxPrecision prec) const
+// Sets g[i] to the distance from our line.  There is no fast version of
+// that yet, so prec is ignored.
+{
+  for (size_t i = 0; i < n; i++) {
+    scratch.setPoint(x[i], y[i], modl);
+    g[i] = getLine().distanceFrom(scratch);
+  }
+}
+
+NF_INLINE
+void CConxEqDistCurve::definingGradients(const double *x, const double *y,
+                                         size_t n, ConxModlType modl,
+                                         double *f, double *gx, double *gy,
+                                         CConxPoint &scratch) const
+{
+  getLine().distanceGradientsFrom(x, y, n, modl, f, gx, gy);
+  for (size_t i = 0; i < n; i++)
+    f[i] -= getDistance();
+}
+
 NF_INLINE
 void CConxEqDistCurve::drawGarnishOn(CConxCanvas &cv) const
 {
   // DLC draw the line and possibly some perpendicular segments?
 }
 
+static void drawArcInside(CConxCanvas &cv, Pt c, double R, Pt E1, Pt E2)
+// Draws the arc of the circle about c of radius R from E1 to E2, which are
+// on it and on the boundary of the canvas's model, that is inside the
+// model.
+{
+  double t0 = atan2(E1.y - c.y, E1.x - c.x);
+  double t1 = atan2(E2.y - c.y, E2.x - c.x);
+  if (t1 < t0) t1 += 2.0 * M_PI;
+  double tm = (t0 + t1) / 2.0, x = c.x + R * cos(tm), y = c.y + R * sin(tm);
+  if ((cv.getModel() == CONX_POINCARE_UHP) ? !(y > 0.0)
+      : !(sqr(x) + sqr(y) < 1.0)) {
+    tm = t0 + 2.0 * M_PI;
+    t0 = t1;
+    t1 = tm;
+  }
+  cv.drawArc(c, R, t0, t1);
+}
+
 NF_INLINE
 void CConxEqDistCurve::drawBresenhamOn(CConxCanvas &cv) const
+// The points at distance d from our line are, on the hyperboloid, the h
+// with <h, n> = +-sinh(d), where n is the line's pole.  In the Poincare
+// models, each sign gives an arc of a circle through the line's ideal
+// endpoints; in the Klein disk, the two together are an ellipse.  The
+// TRACER method still traces the curve.
 {
-  CConxPoint lb, rb; // DLC static for a slight speed increase.
-  getPointsOn(&lb, &rb, cv.getYmin(), cv.getYmax());
-  cv.drawByBresenham(lb, rb, definingFunctionWrapper, this);
+  double n[3];
+  if (cv.getCurveTracing() || !getLine().getPole(n)) {
+    CConxPoint lb, rb; // DLC static for a slight speed increase.
+    getPointsOn(&lb, &rb, cv.getYmin(), cv.getYmax());
+    cv.drawCurve(lb, rb, definingFunctionWrapper, this);
+    return;
+  }
+  double S = sinh(getDistance()), C = cosh(getDistance());
+  double nu = sqrt(sqr(n[0]) + sqr(n[1])); // sqrt(1 + n[2]^2)
+  double ux = n[0] / nu, uy = n[1] / nu, k;
+  Pt E1, E2, c;
+
+  switch (cv.getModel()) {
+  case CONX_KLEIN_DISK:
+    // The line is u = n[2]/nu, with u along (ux, uy), and the ellipse is
+    // (nu u - n[2])^2 = S^2 (1 - u^2 - v^2).
+    k = sqr(nu) + sqr(S);
+    cv.drawEllipse(nu * n[2] / k * ux, nu * n[2] / k * uy, S * C / k,
+                   C / sqrt(k), atan2(uy, ux));
+    break;
+  case CONX_POINCARE_DISK:
+    // The ideal endpoints are those of the Klein disk's chord.  Each
+    // circle is (c - n[2]) |z|^2 + 2 n[0] x + 2 n[1] y = n[2] + c.
+    E1.x = (n[2] * ux - uy) / nu; E1.y = (n[2] * uy + ux) / nu;
+    E2.x = (n[2] * ux + uy) / nu; E2.y = (n[2] * uy - ux) / nu;
+    for (int sign = 1; sign >= -1; sign -= 2) {
+      k = sign * S - n[2];
+      if (myabs(k) < EQUALITY_TOL) {
+        // The circle is the line n[0] x + n[1] y = n[2], the chord E1E2.
+        DRAW_SINGLE_LINE(cv, E1, E2);
+      } else {
+        c.x = -n[0] / k;
+        c.y = -n[1] / k;
+        drawArcInside(cv, c, sqrt(sqr(c.x) + sqr(c.y) + (n[2] + sign*S)/k),
+                      E1, E2);
+      }
+      if (S == 0.0) break;
+    }
+    break;
+  default:
+    assert(cv.getModel() == CONX_POINCARE_UHP);
+    // Each circle is (n[1] - n[2])/2 (x^2 + y^2) + n[0] x - c y
+    // = (n[1] + n[2])/2, which is a line through the ideal point
+    // (n[2]/n[0], 0) if the line is vertical.
+    k = n[1] - n[2];
+    for (int sign = 1; sign >= -1; sign -= 2) {
+      if (myabs(k) < EQUALITY_TOL) {
+        E1.x = n[2] / n[0]; E1.y = 0.0;
+        E2.y = greater(cv.getYmax(), 0.0);
+        E2.x = (n[2] + sign * S * E2.y) / n[0];
+        DRAW_SINGLE_LINE(cv, E1, E2);
+      } else {
+        c.x = -n[0] / k;
+        c.y = sign * S / k;
+        double w = sqrt(myabs(sqr(c.x) + (n[1] + n[2]) / k));
+        E1.x = c.x - w; E2.x = c.x + w;
+        E1.y = E2.y = 0.0;
+        drawArcInside(cv, c, sqrt(sqr(w) + sqr(c.y)), E1, E2);
+      }
+      if (S == 0.0) break;
+    }
+  }
 }
 
 NF_INLINE
@@ -112,3 +221,11 @@ void CConxEqDistCurve::uninitializedCopy(const CConxEqDistCurve &o)
   }
 }
 
+
+NF_INLINE
+void CConxEqDistCurve::moveBy(const ConxIsometry &g)
+{
+  CConxLine L = getLine();
+  L.moveBy(g);
+  setLine(L);
+}
@@ -58,8 +58,25 @@ public:
   {
     return (getLine().distanceFrom(X) - getDistance());
   }
+  double getLipschitzConstant() const { return 1.0; }
+  Boole hasSignedDefiningFunction() const { return TRUE; }
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const;
+  Boole hasDefiningField() const { return TRUE; }
+  double definingScalar() const { return getDistance(); }
+  void definingFields(const double *x, const double *y, size_t n,
+                      ConxModlType modl, double *g, CConxPoint &scratch,
+                      ConxPrecision prec = CONX_PRECISE) const;
+  Boole sameField(const CConxSimpleArtist &o) const
+  {
+    return (o.getSAType() == SA_EQDISTCURVE
+            && getLine().isIdenticalTo(((const CConxEqDistCurve &) o)
+                                       .getLine()));
+  }
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
   Boole requiresHeavyComputation() const { return TRUE; }
   int operator==(const CConxEqDistCurve &o) const {
     return CConxGeomObj::operator==(o);
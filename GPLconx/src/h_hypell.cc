@@ -40,6 +40,138 @@ double CConxHypEllipse::definingFunction(const CConxPoint &X) const
                    - getFocus2().distanceFrom(X)) - getScalar()));
 }
 
+NF_INLINE
+void CConxHypEllipse::definingFunctions(const double *x, const double *y,
+                                        size_t n, ConxModlType modl,
+                                        double *f, CConxPoint &scratch,
+                                        ConxPrecision prec) const
+{
+  definingFields(x, y, n, modl, f, scratch, prec);
+  for (size_t i = 0; i < n; i++)
+    f[i] -= getScalar();
+}
+
+NF_INLINE
+void CConxHypEllipse::thresholdFunctions(const double *x, const double *y,
+                                         size_t n, ConxModlType modl,
+                                         double tol, double *f,
+                                         CConxPoint &scratch) const
+// Each focus is within the scalar of each point of an ellipse, so a focal
+// distance of more than the scalar plus tol decides a point whatever the
+// other is.  Nothing like that bounds a hyperbola's difference.
+{
+#define HYPELL_CHUNK 128
+  double d2[HYPELL_CHUNK], hi = getScalar() + tol;
+  size_t i, j, m;
+
+  if (!isEllipse()) {
+    definingFunctions(x, y, n, modl, f, scratch, CONX_PRECISE);
+    return;
+  }
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > HYPELL_CHUNK) m = HYPELL_CHUNK;
+    getFocus1().distancesWithin(x+i, y+i, m, modl, 0.0, hi, f+i);
+    getFocus2().distancesWithin(x+i, y+i, m, modl, 0.0, hi, d2);
+    for (j = 0; j < m; j++) {
+      // hi - getScalar() may round to just less than tol.
+      f[i+j] = (f[i+j] >= hi || d2[j] >= hi) ? tol
+        : (f[i+j] + d2[j]) - getScalar();
+    }
+  }
+#undef HYPELL_CHUNK
+}
+
+NF_INLINE
+void CConxHypEllipse::definingFields(const double *x, const double *y,
+                                     size_t n, ConxModlType modl,
+                                     double *g, CConxPoint &scratch,
+                                     ConxPrecision prec) const
+// Sets g[i] to the sum of (for an ellipse) or the absolute difference
+// between (for a hyperbola) the distances from the foci.
+{
+#define HYPELL_CHUNK 128
+  double d2[HYPELL_CHUNK];
+  size_t i, j, m;
+  Boole ellipse = isEllipse();
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > HYPELL_CHUNK) m = HYPELL_CHUNK;
+    getFocus1().distancesFrom(x+i, y+i, m, modl, g+i, prec);
+    getFocus2().distancesFrom(x+i, y+i, m, modl, d2, prec);
+    for (j = 0; j < m; j++) {
+      g[i+j] = (ellipse ? (g[i+j] + d2[j]) : myabs(g[i+j] - d2[j]));
+    }
+  }
+#undef HYPELL_CHUNK
+}
+
+NF_INLINE
+void CConxHypEllipse::definingFieldsf(const double *x, const double *y,
+                                      size_t n, ConxModlType modl,
+                                      float *g, CConxPoint &scratch) const
+// As definingFields(), but in single precision.
+{
+#define HYPELL_CHUNK 128
+  float d2[HYPELL_CHUNK];
+  size_t i, j, m;
+  Boole ellipse = isEllipse();
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > HYPELL_CHUNK) m = HYPELL_CHUNK;
+    getFocus1().distancesFromf(x+i, y+i, m, modl, g+i);
+    getFocus2().distancesFromf(x+i, y+i, m, modl, d2);
+    for (j = 0; j < m; j++) {
+      // Two float infinities, at a point at infinity, differ by NaN, but
+      // definingFields() gives 0 there.
+      if (ellipse)
+        g[i+j] += d2[j];
+      else
+        g[i+j] = (g[i+j] == d2[j]) ? 0.0f : (float) fabs(g[i+j] - d2[j]);
+    }
+  }
+#undef HYPELL_CHUNK
+}
+
+NF_INLINE
+void CConxHypEllipse::definingGradients(const double *x, const double *y,
+                                        size_t n, ConxModlType modl,
+                                        double *f, double *gx, double *gy,
+                                        CConxPoint &scratch) const
+{
+#define HYPELL_CHUNK 128
+  double d2[HYPELL_CHUNK], gx2[HYPELL_CHUNK], gy2[HYPELL_CHUNK], s;
+  size_t i, j, m;
+  Boole ellipse = isEllipse();
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > HYPELL_CHUNK) m = HYPELL_CHUNK;
+    getFocus1().distanceGradientsFrom(x+i, y+i, m, modl, f+i, gx+i, gy+i);
+    getFocus2().distanceGradientsFrom(x+i, y+i, m, modl, d2, gx2, gy2);
+    for (j = 0; j < m; j++) {
+      s = (ellipse || f[i+j] >= d2[j]) ? 1.0 : -1.0;
+      f[i+j] = (ellipse ? (f[i+j] + d2[j]) : s * (f[i+j] - d2[j]))
+        - getScalar();
+      gx[i+j] = s * gx[i+j] + (ellipse ? gx2[j] : -s * gx2[j]);
+      gy[i+j] = s * gy[i+j] + (ellipse ? gy2[j] : -s * gy2[j]);
+    }
+  }
+#undef HYPELL_CHUNK
+}
+
+NF_INLINE
+Boole CConxHypEllipse::sameField(const CConxSimpleArtist &o) const
+{
+  if (o.getSAType() != SA_HYPELLIPSE) return FALSE;
+  const CConxHypEllipse &h = (const CConxHypEllipse &) o;
+  return ((isEllipse() != 0) == (h.isEllipse() != 0)
+          && getFocus1().isIdenticalTo(h.getFocus1())
+          && getFocus2().isIdenticalTo(h.getFocus2()));
+}
+
 NF_INLINE
 void CConxHypEllipse::init()
 {
@@ -70,7 +202,66 @@ void CConxHypEllipse::drawBresenhamOn(CConxCanvas &cv) const
   // implement only once!
   CConxPoint lb, rb; // DLC static for a slight speed increase.
   getPointsOn(&lb, &rb);
-  cv.drawByBresenham(lb, rb, definingFunctionWrapper, this);
+  cv.drawCurve(lb, rb, definingFunctionWrapper, this);
+}
+
+// What polarMetric needs
+struct HypEllPolar {
+  const CConxHypEllipse *self;
+  ConxModlType modl;
+  ConxPrecision prec;
+  double sign;
+};
+
+NF_INLINE
+void CConxHypEllipse::polarMetric(const double *x, const double *y,
+                                  double *f, size_t n, void *t)
+// Sets f[i] to d1 + d2 - s for an ellipse, or to
+// sign * (d1 - d2) + s for a hyperbola, where di is the distance from
+// focus i.  Each is negative at a focus and grows along the rays from it
+// (by the triangle inequality), and the hyperbola's is zero only on the
+// branch nearer the focus from which we solve.  At infinity, where the
+// distances are CCONX_INFINITY, f[i] is HUGE_VAL.
+{
+#define HYPELL_CHUNK 128
+  HypEllPolar *p = (HypEllPolar *) t;
+  const CConxHypEllipse *s = p->self;
+  double d2[HYPELL_CHUNK];
+  size_t i, j, m;
+  Boole ellipse = s->isEllipse();
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > HYPELL_CHUNK) m = HYPELL_CHUNK;
+    s->getFocus1().distancesFrom(x+i, y+i, m, p->modl, f+i, p->prec);
+    s->getFocus2().distancesFrom(x+i, y+i, m, p->modl, d2, p->prec);
+    for (j = 0; j < m; j++) {
+      if (f[i+j] >= CCONX_INFINITY || d2[j] >= CCONX_INFINITY)
+        f[i+j] = HUGE_VAL; // conx_polar() must not see the difference.
+      else
+        f[i+j] = (ellipse ? (f[i+j] + d2[j] - s->getScalar())
+                  : (p->sign * (f[i+j] - d2[j]) + s->getScalar()));
+    }
+  }
+#undef HYPELL_CHUNK
+}
+
+NF_INLINE
+Boole CConxHypEllipse::drawPolarOn(CConxCanvas &cv) const
+// An ellipse is star-shaped about either focus and each branch of a
+// hyperbola about the focus inside it.
+{
+  HypEllPolar p;
+  p.self = this;
+  p.modl = cv.getModel();
+  p.prec = cv.getMetricPrecision();
+  p.sign = 1.0;
+  cv.drawPolar(getFocus1(), polarMetric, &p);
+  if (!isEllipse()) {
+    p.sign = -1.0;
+    cv.drawPolar(getFocus2(), polarMetric, &p);
+  }
+  return TRUE;
 }
 
 NF_INLINE
@@ -124,6 +315,7 @@ Boole CConxHypEllipse::isEllipse() const
     isEllips = (getScalar()
                   > conxp_distAB(getFocus1().getPt(CONX_POINCARE_UHP),
                                  getFocus2().getPt(CONX_POINCARE_UHP)));
+    isEllipseIsValid = TRUE;
   }
   return isEllips;
 }
@@ -150,3 +342,14 @@ ostream &CConxHypEllipse::printOn(ostream &o, ConxModlType modl) const
   return o;
 }
 
+
+NF_INLINE
+void CConxHypEllipse::moveBy(const ConxIsometry &g)
+{
+  CConxPoint F = getFocus1();
+  F.moveBy(g);
+  setFocus1(F);
+  F = getFocus2();
+  F.moveBy(g);
+  setFocus2(F);
+}
@@ -48,11 +48,20 @@ public:
   }
   CConxHypEllipse(const CConxHypEllipse &A)
     : CConxGeomObj(A) { uninitializedCopy(A); }
-  void setScalar(double S) { isValid = FALSE; CConxGeomObj::setScalar(S); }
+  void setScalar(double S)
+  {
+    isValid = isEllipseIsValid = FALSE; CConxGeomObj::setScalar(S);
+  }
   CONX_USING CConxGeomObj::getScalar;
-  void setFocus1(const CConxPoint &p) { isValid = FALSE; setA(p); }
+  void setFocus1(const CConxPoint &p)
+  {
+    isValid = isEllipseIsValid = FALSE; setA(p);
+  }
   const CConxPoint &getFocus1() const { return getA(); }
-  void setFocus2(const CConxPoint &p) { isValid = FALSE; setB(p); }
+  void setFocus2(const CConxPoint &p)
+  {
+    isValid = isEllipseIsValid = FALSE; setB(p);
+  }
   const CConxPoint &getFocus2() const { return getB(); }
   int isEllipse() const;
   void getPointsOn(CConxPoint *lb, CConxPoint *rb) const;
@@ -69,11 +78,35 @@ public:
 
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
+  Boole drawPolarOn(CConxCanvas &cv) const;
   double definingFunction(const CConxPoint &X) const;
+  void definingFunctions(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f,
+                         CConxPoint &scratch,
+                         ConxPrecision prec = CONX_PRECISE) const;
+  void thresholdFunctions(const double *x, const double *y, size_t n,
+                          ConxModlType modl, double tol, double *f,
+                          CConxPoint &scratch) const;
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const;
+  double getLipschitzConstant() const { return 2.0; }
+  Boole hasSignedDefiningFunction() const { return TRUE; }
+  Boole hasDefiningField() const { return TRUE; }
+  double definingScalar() const { return getScalar(); }
+  void definingFields(const double *x, const double *y, size_t n,
+                      ConxModlType modl, double *g, CConxPoint &scratch,
+                      ConxPrecision prec = CONX_PRECISE) const;
+  void definingFieldsf(const double *x, const double *y, size_t n,
+                       ConxModlType modl, float *g, CConxPoint &scratch) const;
+  Boole sameField(const CConxSimpleArtist &o) const;
 
 private: // operations
   void init();
   void uninitializedCopy(const CConxHypEllipse &o);
+  static void polarMetric(const double *x, const double *y, double *f,
+                          size_t n, void *t);
 
 private: // attributes
   // Save the point(s) analytically determined to be on the ellipse(hyperbola)
@@ -40,6 +40,8 @@ void CConxLine::uninitializedCopy(const CConxLine &o)
     y[i] = o.y[i];
   }
   pd_radius = o.pd_radius;
+  for (int k = 0; k < 3; k++)
+    pole[k] = o.pole[k];
   klein_endpts[0] = o.klein_endpts[0];
   klein_endpts[1] = o.klein_endpts[1];
   pd_endpts[0] = o.pd_endpts[0];
@@ -117,12 +119,62 @@ int CConxLine::isTypeI() const
   return (getPUHP_R() < 0.0);
 }
 
+NF_INLINE
+Boole CConxLine::getPole(double *n) const
+// Sets n[0..2] to the pole of this line on the hyperboloid, normalized so
+// that <n, n> = 1, and returns TRUE, or returns FALSE if this line is
+// degenerate.
+{
+  if (!(isValid & CONX_HYPERBOLOID_BIT)) {
+    double a[3], b[3];
+    if (!getA().getHyperboloid(a)) {
+      a[0] = getA().getX(CONX_KLEIN_DISK);
+      a[1] = getA().getY(CONX_KLEIN_DISK);
+      a[2] = 1.0;
+    }
+    if (!getB().getHyperboloid(b)) {
+      b[0] = getB().getX(CONX_KLEIN_DISK);
+      b[1] = getB().getY(CONX_KLEIN_DISK);
+      b[2] = 1.0;
+    }
+    if (!conxh_pole(a, b, pole) && !conxk_polemb(getK_M(), getK_B(), pole))
+      return FALSE;
+    isValid |= CONX_HYPERBOLOID_BIT;
+  }
+  n[0] = pole[0]; n[1] = pole[1]; n[2] = pole[2];
+  return TRUE;
+}
+
 NF_INLINE
 double CConxLine::distanceFrom(const CConxPoint &P, double computol) const
 {
   return P.distanceFrom(*this, computol);
 }
 
+NF_INLINE
+void CConxLine::distanceGradientsFrom(const double *x, const double *y,
+                                      size_t n, ConxModlType modl,
+                                      double *d, double *gx,
+                                      double *gy) const
+// Sets d[i] to distanceFrom(CConxPoint(x[i], y[i], modl)), computed in
+// closed form rather than by searching along the line, and (gx[i], gy[i])
+// to its gradient with respect to (x[i], y[i]).  Points at infinity get
+// CCONX_INFINITY and a zero gradient.
+{
+  double m = getK_M(), b = getK_B(), kx, ky, J[4], g0, g1;
+
+  for (size_t i = 0; i < n; i++) {
+    if (!conxhm_tok_jacobian(modl, x[i], y[i], &kx, &ky, J)) {
+      d[i] = CCONX_INFINITY;
+      gx[i] = gy[i] = 0.0;
+      continue;
+    }
+    conxk_distmb_grad(m, b, kx, ky, d+i, &g0, &g1);
+    gx[i] = J[0]*g0 + J[2]*g1;
+    gy[i] = J[1]*g0 + J[3]*g1;
+  }
+}
+
 NF_INLINE
 void CConxLine::getPerpendicular(CConxLine &P, const CConxPoint &A,
                                  double computol) const
@@ -415,3 +467,14 @@ void CConxLine::drawBresenhamOn(CConxCanvas &cv) const
   } // uhp and pd treatment
 }
 
+
+NF_INLINE
+void CConxLine::moveBy(const ConxIsometry &g)
+{
+  CConxPoint P = getA();
+  P.moveBy(g);
+  setA(P);
+  P = getB();
+  P.moveBy(g);
+  setB(P);
+}
@@ -66,10 +66,14 @@ public:
   double getPUHP_A() const;
   double getPUHP_R() const;
   int isTypeI() const;
+  Boole getPole(double *n) const;
   Boole isLineSegment() const { return isSegment; }
   void setSegment(Boole yess) { isSegment = yess; }
   double distanceFrom(const CConxPoint &P,
                       double computol = EQUALITY_TOL) const;
+  void distanceGradientsFrom(const double *x, const double *y, size_t n,
+                             ConxModlType modl, double *d,
+                             double *gx, double *gy) const;
   void getPerpendicular(CConxLine &P, const CConxPoint &A,
                         double computol = EQUALITY_TOL) const;
   ostream &printOn(ostream &o) const;
@@ -80,13 +84,27 @@ public:
     return (isSegment == o.isSegment && CConxTwoPts::operator==(o));
   }
   int operator!=(const CConxLine &o) const { return !operator==(o); }
+  // Unlike operator==, this is TRUE only if distances from o are exactly
+  // distances from us.
+  Boole isIdenticalTo(const CConxLine &o) const
+  {
+    return (getK_M() == o.getK_M() && getK_B() == o.getK_B());
+  }
 
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
   double definingFunction(const CConxPoint &X) const
   {
     return distanceFrom(X);
   }
+  double getLipschitzConstant() const { return 1.0; }
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const
+  {
+    distanceGradientsFrom(x, y, n, modl, f, gx, gy);
+  }
 
 private: // operations
   void convertTo(ConxModlType modl) const;
@@ -104,6 +122,11 @@ private: // attributes
 
   mutable double pd_radius; // the radius of this line in the Poincare disk.
 
+  mutable double pole[3];
+  // The pole of this line on the hyperboloid T^2-X^2-Y^2=1, valid if
+  // isValid & CONX_HYPERBOLOID_BIT.  A point is on this line iff it is
+  // orthogonal to the pole.
+
   mutable Pt klein_endpts[2];
   mutable Pt pd_endpts[2];
   // The points on the Klein disk's boundary where the line goes at infinity;
@@ -117,6 +117,30 @@ int CConxParabola::getPointOn(CConxPoint *LB, double computol) const
   return 0;
 }
 
+NF_INLINE
+void CConxParabola::definingGradients(const double *x, const double *y,
+                                      size_t n, ConxModlType modl,
+                                      double *f, double *gx, double *gy,
+                                      CConxPoint &scratch) const
+{
+#define PARABO_CHUNK 128
+  double d[PARABO_CHUNK], dx[PARABO_CHUNK], dy[PARABO_CHUNK];
+  size_t i, j, m;
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > PARABO_CHUNK) m = PARABO_CHUNK;
+    getFocus().distanceGradientsFrom(x+i, y+i, m, modl, f+i, gx+i, gy+i);
+    getLine().distanceGradientsFrom(x+i, y+i, m, modl, d, dx, dy);
+    for (j = 0; j < m; j++) {
+      f[i+j] -= d[j];
+      gx[i+j] -= dx[j];
+      gy[i+j] -= dy[j];
+    }
+  }
+#undef PARABO_CHUNK
+}
+
 NF_INLINE
 void CConxParabola::drawBresenhamOn(CConxCanvas &cv) const
 {
@@ -127,7 +151,63 @@ void CConxParabola::drawBresenhamOn(CConxCanvas &cv) const
   if (getPointOn(&lb)) return; // DLC should the user be able to find out
   // about this if she wants to?
 
-  cv.drawByBresenham(lb, lb, definingFunctionWrapper, this);
+  cv.drawCurve(lb, lb, definingFunctionWrapper, this);
+}
+
+// What polarMetric needs
+struct ParaboPolar {
+  const CConxParabola *self;
+  ConxModlType modl;
+  ConxPrecision prec;
+  Boole hoisted;             // the line's pole n is good
+  double n[3];
+  CConxPoint X;
+};
+
+NF_INLINE
+void CConxParabola::polarMetric(const double *x, const double *y, double *f,
+                                size_t n, void *t)
+// Like definingFunctions(), but HUGE_VAL at infinity, where the two
+// distances are both CCONX_INFINITY.  The distance from the line comes
+// from its pole, as in conxHoistedFunction(), a chunk at a time.
+{
+#define PARABO_CHUNK 128
+  ParaboPolar *p = (ParaboPolar *) t;
+  double h[3], X[PARABO_CHUNK], Y[PARABO_CHUNK], T[PARABO_CHUNK];
+  size_t i, j, m;
+
+  p->self->getFocus().distancesFrom(x, y, n, p->modl, f, p->prec);
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > PARABO_CHUNK) m = PARABO_CHUNK;
+    if (p->hoisted) conxhm_toh_batch(p->modl, x+i, y+i, X, Y, T, m);
+    for (j = 0; j < m; j++) {
+      if (f[i+j] >= CCONX_INFINITY) {
+        f[i+j] = HUGE_VAL;
+      } else if (p->hoisted) {
+        h[0] = X[j]; h[1] = Y[j]; h[2] = T[j];
+        f[i+j] -= conxh_distline(p->n, h);
+      } else {
+        p->X.setPoint(x[i+j], y[i+j], p->modl);
+        f[i+j] -= p->self->getLine().distanceFrom(p->X);
+      }
+    }
+  }
+#undef PARABO_CHUNK
+}
+
+NF_INLINE
+Boole CConxParabola::drawPolarOn(CConxCanvas &cv) const
+// The distance from the focus less that from the line is negative at the
+// focus and grows along the rays from it, by the triangle inequality.
+{
+  ParaboPolar p;
+  p.self = this;
+  p.modl = cv.getModel();
+  p.prec = cv.getMetricPrecision();
+  p.hoisted = getLine().getPole(p.n);
+  cv.drawPolar(getFocus(), polarMetric, &p);
+  return TRUE;
 }
 
 NF_INLINE
@@ -143,3 +223,14 @@ void CConxParabola::uninitializedCopy(const CConxParabola &o)
   if (isValid)
     pLB = o.pLB;
 }
+
+NF_INLINE
+void CConxParabola::moveBy(const ConxIsometry &g)
+{
+  CConxPoint F = getFocus();
+  CConxLine L = getLine();
+  F.moveBy(g);
+  L.moveBy(g);
+  setFocus(F);
+  setLine(L);
+}
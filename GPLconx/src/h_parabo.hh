@@ -55,13 +55,22 @@ public:
 
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
+  Boole drawPolarOn(CConxCanvas &cv) const;
   double definingFunction(const CConxPoint &X) const
   {
     return getFocus().distanceFrom(X) - getLine().distanceFrom(X);
   }
+  double getLipschitzConstant() const { return 2.0; }
+  Boole hasSignedDefiningFunction() const { return TRUE; }
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const;
 
 private: // operations
   void uninitializedCopy(const CConxParabola &o);
+  static void polarMetric(const double *x, const double *y, double *f,
+                          size_t n, void *t);
 
 private: // attributes
   mutable Boole isValid;
@@ -85,6 +85,16 @@ int CConxPoint::operator==(const CConxPoint &o) const
   return (distanceFrom(o) <= EQUALITY_TOL);
 }
 
+NF_INLINE
+Boole CConxPoint::isIdenticalTo(const CConxPoint &o) const
+// Unlike operator==, which allows for rounding errors, this is TRUE only
+// if o's Klein coordinates are exactly ours, so that distances from o are
+// exactly distances from us.
+{
+  Pt a = getPt(CONX_KLEIN_DISK), b = o.getPt(CONX_KLEIN_DISK);
+  return (a.x == b.x && a.y == b.y && isAtInfinity() == o.isAtInfinity());
+}
+
 NF_INLINE
 void CConxPoint::setPoint(double x, double y, ConxModlType modl)
 {
@@ -109,20 +119,30 @@ Boole CConxPoint::isAtInfinity(double tol) const
 // This value is not cached.
 {
   CONX_INVARIANT(isValid != 0);
+  ConxModlType modl = CONX_KLEIN_DISK;
+  if (isValid & CONX_MODEL2BIT(CONX_POINCARE_UHP))
+    modl = CONX_POINCARE_UHP;
+  else if (isValid & CONX_MODEL2BIT(CONX_POINCARE_DISK))
+    modl = CONX_POINCARE_DISK;
+  return isAtInfinity(x[modl], y[modl], modl, tol);
+}
+
+NF_INLINE
+Boole CConxPoint::isAtInfinity(double x, double y, ConxModlType modl,
+                               double tol)
+// Returns TRUE if (x, y) in the modl model is at infinity.  See above.
+{
   if (tol < 0.0) tol = 0.0;
-  if (isValid & CONX_MODEL2BIT(CONX_POINCARE_UHP)) {
-    return y[CONX_POINCARE_UHP] <= 0.0 + tol;
+  if (modl == CONX_POINCARE_UHP) {
+    return y <= 0.0 + tol;
   } else {
-    ConxModlType modl = CONX_KLEIN_DISK;
-    if (isValid & CONX_MODEL2BIT(CONX_POINCARE_DISK))
-      modl = CONX_POINCARE_DISK;
     // Test to see if the distance from the origin, sqrt(x^2+y^2), is within
     // tol of being greater than or equal 1.0.
 
     // sqrt(x^2+y^2) >= 1.0 - tol
     //  ===
     // x^2+y^2 >= (1 - tol)^2
-    return (sqr(x[modl]) + sqr(y[modl]) >= sqr(1.0 - tol));
+    return (sqr(x) + sqr(y) >= sqr(1.0 - tol));
   }
 }
 
@@ -157,6 +177,30 @@ Pt CConxPoint::getPt(ConxModlType modl) const
   return n;
 }
 
+NF_INLINE
+Boole CConxPoint::getHyperboloid(double *hv) const
+// Sets hv[0..2] to this point on the hyperboloid T^2-X^2-Y^2=1, of which
+// the three models are projections, and returns TRUE, or returns FALSE if
+// this point is at infinity.  We compute it from the Poincare
+// coordinates if we have them, since they lose the least precision near
+// the boundary.
+{
+  CONX_INVARIANT(isValid != 0);
+  if (!(isValid & CONX_HYPERBOLOID_BIT)) {
+    ConxModlType modl = CONX_KLEIN_DISK;
+    if (isValid & CONX_MODEL2BIT(CONX_POINCARE_UHP))
+      modl = CONX_POINCARE_UHP;
+    else if (isValid & CONX_MODEL2BIT(CONX_POINCARE_DISK))
+      modl = CONX_POINCARE_DISK;
+    if (isAtInfinity(x[modl], y[modl], modl, 0.0)
+        || !conxhm_toh(modl, x[modl], y[modl], h))
+      return FALSE;
+    isValid |= CONX_HYPERBOLOID_BIT;
+  }
+  hv[0] = h[0]; hv[1] = h[1]; hv[2] = h[2];
+  return TRUE;
+}
+
 PF_INLINE
 ostream &CConxPoint::printOn(ostream &o) const
 {
@@ -214,12 +258,19 @@ NF_INLINE
 void CConxPoint::convertTo(ConxModlType modl) const
 {
   CONX_INVARIANT(isValid != 0);
+  double hv[3];
+  if (getHyperboloid(hv)) {
+    // Each model is a cheap projection of the hyperboloid.
+    conxhm_fromh(hv, modl, x+modl, y+modl);
+    isValid |= CONX_MODEL2BIT(modl);
+    return;
+  }
   for (int i = 0; i < CONX_NUM_MODELS; i++) {
     if (isValid & CONX_MODEL2BIT(i)) {
       // Convert from model i to model modl.
       modelToModel(x[i], y[i], (ConxModlType) i,
                    x+modl, y+modl, modl);
-      isValid |= CONX_MODEL2BIT((ConxModlType) i);
+      isValid |= CONX_MODEL2BIT(modl);
       return;
     }
   }
@@ -229,14 +280,174 @@ NF_INLINE
 double CConxPoint::distanceFrom(const CConxPoint &A, double tol) const
 {
   if (isAtInfinity(tol) || A.isAtInfinity(tol)) return CCONX_INFINITY;
+  double a[3], b[3];
+  if (getHyperboloid(a) && A.getHyperboloid(b))
+    return conxh_dist(a, b);
   return conxk_distAB(getPt(CONX_KLEIN_DISK), A.getPt(CONX_KLEIN_DISK));
 }
 
+NF_INLINE
+void CConxPoint::distancesFrom(const double *xs, const double *ys, size_t n,
+                               ConxModlType modl, double *d,
+                               ConxPrecision prec) const
+// Sets d[i] to distanceFrom(CConxPoint(xs[i], ys[i], modl)) for
+// 0 <= i < n, several points at a time.  With prec == CONX_FAST, the
+// distances are computed in single precision where that is safe;
+// otherwise, they are computed on the hyperboloid.
+{
+#define DISTANCES_CHUNK 128
+  double kx[DISTANCES_CHUNK], ky[DISTANCES_CHUNK], kt[DISTANCES_CHUNK];
+  double me_h[3];
+  size_t i, j, m;
+
+  if (isAtInfinity()) {
+    for (i = 0; i < n; i++) d[i] = CCONX_INFINITY;
+    return;
+  }
+  Boole onHyperboloid = (prec != CONX_FAST && getHyperboloid(me_h));
+  Pt me = getPt(CONX_KLEIN_DISK);
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > DISTANCES_CHUNK) m = DISTANCES_CHUNK;
+    for (j = 0; j < m; j++) {
+      kx[j] = xs[i+j];
+      ky[j] = ys[i+j];
+      if (modl == CONX_POINCARE_UHP && ky[j] < 0.0)
+        ky[j] = 0.0; // as setPoint() does
+    }
+    if (onHyperboloid) {
+      conxhm_toh_batch(modl, kx, ky, kx, ky, kt, m);
+      conxh_dist_batch(me_h, kx, ky, kt, d+i, m);
+    } else {
+      if (modl == CONX_POINCARE_UHP)
+        conxhm_ptok_batch(kx, ky, kx, ky, m);
+      else if (modl == CONX_POINCARE_DISK)
+        conxhm_pdtok_batch(kx, ky, kx, ky, m);
+      if (prec == CONX_FAST)
+        conxk_dist_batchf(me.x, me.y, kx, ky, d+i, m);
+      else
+        conxk_dist_batch(me.x, me.y, kx, ky, d+i, m);
+    }
+    for (j = 0; j < m; j++) {
+      if (isAtInfinity(xs[i+j], ys[i+j], modl, EQUALITY_TOL))
+        d[i+j] = CCONX_INFINITY;
+    }
+  }
+#undef DISTANCES_CHUNK
+}
+
+NF_INLINE
+void CConxPoint::distancesFromf(const double *xs, const double *ys, size_t n,
+                                ConxModlType modl, float *d) const
+// Like distancesFrom() with CONX_FAST, but stores floats.  The points at
+// infinity, CCONX_INFINITY, become float infinities.
+{
+#define DISTANCES_CHUNK 128
+  double kx[DISTANCES_CHUNK], ky[DISTANCES_CHUNK];
+  size_t i, j, m;
+
+  if (isAtInfinity()) {
+    for (i = 0; i < n; i++) d[i] = (float) CCONX_INFINITY;
+    return;
+  }
+  Pt me = getPt(CONX_KLEIN_DISK);
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > DISTANCES_CHUNK) m = DISTANCES_CHUNK;
+    for (j = 0; j < m; j++) {
+      kx[j] = xs[i+j];
+      ky[j] = ys[i+j];
+      if (modl == CONX_POINCARE_UHP && ky[j] < 0.0)
+        ky[j] = 0.0; // as setPoint() does
+    }
+    // The UHP's axis goes to the Klein disk's boundary, where
+    // conxk_dist_batchff() falls back to double precision.
+    if (modl == CONX_POINCARE_UHP)
+      conxhm_ptok_batch(kx, ky, kx, ky, m);
+    else if (modl == CONX_POINCARE_DISK)
+      conxhm_pdtok_batch(kx, ky, kx, ky, m);
+    conxk_dist_batchff(me.x, me.y, kx, ky, d+i, m);
+    for (j = 0; j < m; j++) {
+      if (isAtInfinity(xs[i+j], ys[i+j], modl, EQUALITY_TOL))
+        d[i+j] = (float) CCONX_INFINITY;
+    }
+  }
+#undef DISTANCES_CHUNK
+}
+
+NF_INLINE
+void CConxPoint::distancesWithin(const double *xs, const double *ys,
+                                 size_t n, ConxModlType modl, double lo,
+                                 double hi, double *d) const
+// Sets d[i] to distancesFrom()'s d[i] clamped to [lo, hi], but only the
+// distances strictly between lo and hi are computed; see
+// conxh_dist_clamp_batch().
+{
+#define DISTANCES_CHUNK 128
+  double kx[DISTANCES_CHUNK], ky[DISTANCES_CHUNK], kt[DISTANCES_CHUNK];
+  double me_h[3];
+  size_t i, j, m;
+
+  if (isAtInfinity() || !getHyperboloid(me_h)) {
+    distancesFrom(xs, ys, n, modl, d);
+    for (i = 0; i < n; i++)
+      d[i] = (d[i] < lo) ? lo : ((d[i] > hi) ? hi : d[i]);
+    return;
+  }
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > DISTANCES_CHUNK) m = DISTANCES_CHUNK;
+    for (j = 0; j < m; j++) {
+      kx[j] = xs[i+j];
+      ky[j] = ys[i+j];
+      if (modl == CONX_POINCARE_UHP && ky[j] < 0.0)
+        ky[j] = 0.0; // as setPoint() does
+    }
+    conxhm_toh_batch(modl, kx, ky, kx, ky, kt, m);
+    conxh_dist_clamp_batch(me_h, kx, ky, kt, d+i, m, lo, hi);
+    for (j = 0; j < m; j++) {
+      if (isAtInfinity(xs[i+j], ys[i+j], modl, EQUALITY_TOL))
+        d[i+j] = hi;
+    }
+  }
+#undef DISTANCES_CHUNK
+}
+
+NF_INLINE
+void CConxPoint::distanceGradientsFrom(const double *xs, const double *ys,
+                                       size_t n, ConxModlType modl,
+                                       double *d, double *gx,
+                                       double *gy) const
+// Sets d[i] as distancesFrom() does, to within rounding, and (gx[i],
+// gy[i]) to the gradient of d[i] with respect to (xs[i], ys[i]), or zero
+// where that is at infinity or is this point.
+{
+  double kx, ky, J[4], g0, g1;
+  Boole atInfinity = isAtInfinity();
+  Pt me = getPt(CONX_KLEIN_DISK);
+
+  for (size_t i = 0; i < n; i++) {
+    if (atInfinity
+        || isAtInfinity(xs[i], ys[i], modl, EQUALITY_TOL)
+        || !conxhm_tok_jacobian(modl, xs[i], ys[i], &kx, &ky, J)) {
+      d[i] = CCONX_INFINITY;
+      gx[i] = gy[i] = 0.0;
+      continue;
+    }
+    conxk_dist_grad(me.x, me.y, kx, ky, d+i, &g0, &g1);
+    gx[i] = J[0]*g0 + J[2]*g1;
+    gy[i] = J[1]*g0 + J[3]*g1;
+  }
+}
+
 NF_INLINE
 double CConxPoint::distanceFrom(const CConxLine &L, double computol) const
 // Returns the distance from the line L along the unique perpendicular.
 {
   if (isAtInfinity(computol)) return CCONX_INFINITY;
+  double n[3], hv[3];
+  if (getHyperboloid(hv) && L.getPole(n))
+    return conxh_distline(n, hv);
   return conxk_distFrommbX(L.getK_M(), L.getK_B(), getPt(CONX_KLEIN_DISK),
                            computol);
 }
@@ -282,5 +493,15 @@ void CConxPoint::uninitializedCopy(const CConxPoint &o)
     x[i] = o.x[i];
     y[i] = o.y[i];
   }
+  for (int k = 0; k < 3; k++)
+    h[k] = o.h[k];
 }
 
+
+NF_INLINE
+void CConxPoint::moveBy(const ConxIsometry &g)
+{
+  Pt P = getPt(CONX_POINCARE_DISK);
+  conx_isom_apply_pts(&g, CONX_POINCARE_DISK, &P, &P, 1);
+  setPoint(P, CONX_POINCARE_DISK);
+}
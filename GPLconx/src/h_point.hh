@@ -46,11 +46,24 @@ public:
   double getX(ConxModlType modl) const;
   double getY(ConxModlType modl) const;
   Pt getPt(ConxModlType modl) const;
+  Boole getHyperboloid(double *h) const;
   double distanceFrom(const CConxPoint &A, double tol = EQUALITY_TOL) const;
   double distanceFrom(const CConxLine &L,
                       double computol = EQUALITY_TOL) const;
+  void distancesFrom(const double *x, const double *y, size_t n,
+                     ConxModlType modl, double *d,
+                     ConxPrecision prec = CONX_PRECISE) const;
+  void distancesFromf(const double *x, const double *y, size_t n,
+                      ConxModlType modl, float *d) const;
+  void distancesWithin(const double *x, const double *y, size_t n,
+                       ConxModlType modl, double lo, double hi,
+                       double *d) const;
+  void distanceGradientsFrom(const double *x, const double *y, size_t n,
+                             ConxModlType modl, double *d,
+                             double *gx, double *gy) const;
   Boole isBetween(const CConxPoint &P, const CConxPoint &Q) const;
   int operator==(const CConxPoint &o) const;
+  Boole isIdenticalTo(const CConxPoint &o) const;
   int operator!=(const CConxPoint &o) const { return !operator==(o); }
   ostream &printOn(ostream &o) const;
   ostream &printOn(ostream &o, ConxModlType modl) const;
@@ -59,10 +72,33 @@ public:
   {
     return distanceFrom(X);
   }
+  double getLipschitzConstant() const { return 1.0; }
+  void definingFunctions(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f,
+                         CConxPoint &scratch,
+                         ConxPrecision prec = CONX_PRECISE) const
+  {
+    distancesFrom(x, y, n, modl, f, prec);
+  }
+  void thresholdFunctions(const double *x, const double *y, size_t n,
+                          ConxModlType modl, double tol, double *f,
+                          CConxPoint &scratch) const
+  {
+    distancesWithin(x, y, n, modl, 0.0, tol, f);
+  }
+  void definingGradients(const double *x, const double *y, size_t n,
+                         ConxModlType modl, double *f, double *gx,
+                         double *gy, CConxPoint &scratch) const
+  {
+    distanceGradientsFrom(x, y, n, modl, f, gx, gy);
+  }
   void drawGarnishOn(CConxCanvas &cv) const;
   void drawBresenhamOn(CConxCanvas &cv) const;
+  void moveBy(const ConxIsometry &g);
 
 private: // operations
+  static Boole isAtInfinity(double x, double y, ConxModlType modl,
+                            double tol);
   static void modelToModel(double xFrom, double yFrom, ConxModlType mFrom,
                            double *xTo, double *yTo, ConxModlType mTo);
   void convertTo(ConxModlType modl) const;
@@ -76,9 +112,13 @@ private: // attributes
   // (x[CONX_POINCARE_UHP], y[CONX_POINCARE_UHP]) is this point in the
   // Poincare UHP.
 
+  mutable double h[3];
+  // (h[0], h[1], h[2]) is this point on the hyperboloid T^2-X^2-Y^2=1 if
+  // isValid & CONX_HYPERBOLOID_BIT.
+
   mutable Bitflag isValid;
   // This is a bitmask that indicates which of the three models we have
-  // already converted to.
+  // already converted to, and whether h is valid.
 }; // class CConxPoint
 
 
@@ -27,6 +27,7 @@
 
 #include "hypmath.hh"
 #include "h_simple.hh"
+#include "h_point.hh"
 #include "canvas.hh"
 
 CF_INLINE
@@ -49,3 +50,58 @@ const char *CConxSimpleArtist::humanSAType(SAType s)
   }
 }
 
+NF_INLINE
+void CConxSimpleArtist::definingFunctions(const double *x, const double *y,
+                                          size_t n, ConxModlType modl,
+                                          double *f,
+                                          CConxPoint &scratch,
+                                          ConxPrecision prec) const
+// There is no fast way to call definingFunction(), so prec is ignored.
+{
+  for (size_t i = 0; i < n; i++) {
+    scratch.setPoint(x[i], y[i], modl);
+    f[i] = definingFunction(scratch);
+  }
+}
+
+NF_INLINE
+void CConxSimpleArtist::definingFieldsf(const double *x, const double *y,
+                                        size_t n, ConxModlType modl,
+                                        float *g, CConxPoint &scratch) const
+// Goes through definingFields() with CONX_FAST a chunk at a time, so that
+// no raster of doubles is needed.
+{
+#define FIELDSF_CHUNK 128
+  double d[FIELDSF_CHUNK];
+  size_t i, j, m;
+
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > FIELDSF_CHUNK) m = FIELDSF_CHUNK;
+    definingFields(x+i, y+i, m, modl, d, scratch, CONX_FAST);
+    for (j = 0; j < m; j++)
+      g[i+j] = (float) d[j];
+  }
+#undef FIELDSF_CHUNK
+}
+
+NF_INLINE
+void CConxSimpleArtist::definingGradients(const double *x, const double *y,
+                                          size_t n, ConxModlType modl,
+                                          double *f, double *gx, double *gy,
+                                          CConxPoint &scratch) const
+// Estimates the gradient by forward differences, three points at a time.
+{
+  double px[3], py[3], pf[3], e;
+
+  for (size_t i = 0; i < n; i++) {
+    e = 1e-7 * (1.0 + myabs(x[i]) + myabs(y[i]));
+    px[0] = x[i];     py[0] = y[i];
+    px[1] = x[i] + e; py[1] = y[i];
+    px[2] = x[i];     py[2] = y[i] + e;
+    definingFunctions(px, py, 3, modl, pf, scratch);
+    f[i] = pf[0];
+    gx[i] = (pf[1] - pf[0]) / e;
+    gy[i] = (pf[2] - pf[0]) / e;
+  }
+}
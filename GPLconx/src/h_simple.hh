@@ -28,6 +28,7 @@
 
 class CConxCanvas;
 class CConxPoint;
+struct ConxIsometry;
 
 //////////////////////////////////////////////////////////////////////////////
 // A class that implements this interface draws itself without regard to
@@ -69,10 +70,89 @@ public:
   // Bresenham means ``Either by the Bresenham method, or the best, fastest,
   // way you know how''.
   virtual void drawBresenhamOn(CConxCanvas &cv) const = 0;
+
+  // If you are star-shaped about some point, e.g. an ellipse about a
+  // focus, override this to draw yourself with CConxCanvas::drawPolar()
+  // and return TRUE.  Returning FALSE means nothing was drawn.
+  virtual Boole drawPolarOn(CConxCanvas &cv) const { return FALSE; }
+
+  // Moves you by g, an isometry of the plane (see isometry.c).  Isometries
+  // keep distances, so your scalars, e.g. a circle's radius, stay put.
+  virtual void moveBy(const ConxIsometry &g) = 0;
    
   // This function returns zero if and only if X is on the object.
   // Most of the time, nearly zero means nearly on the object.
   virtual double definingFunction(const CConxPoint &X) const = 0;
+
+  // Sets f[i] to definingFunction() at the point (x[i], y[i]) of the modl
+  // model for 0 <= i < n.  scratch is yours to clobber so that you need
+  // not construct a CConxPoint, which is not thread-safe.  Override this
+  // if you can do better than one call to definingFunction() per point,
+  // but give the same answers.  With prec == CONX_FAST, you may give
+  // answers that are only good enough for deciding which pixels to light.
+  virtual void definingFunctions(const double *x, const double *y, size_t n,
+                                 ConxModlType modl, double *f,
+                                 CConxPoint &scratch,
+                                 ConxPrecision prec = CONX_PRECISE) const;
+
+  // Sets f[i] as definingFunctions() does with CONX_PRECISE wherever that
+  // is less than tol in absolute value, and elsewhere to something of
+  // the same sign whose absolute value is between tol and that of what
+  // definingFunctions() gives.  That is all that the LONGWAY method needs
+  // with CONX_COMPARE, and it lets you compare cosh-distances instead of
+  // computing distances far from the curve.
+  virtual void thresholdFunctions(const double *x, const double *y,
+                                  size_t n, ConxModlType modl, double tol,
+                                  double *f, CConxPoint &scratch) const
+  {
+    definingFunctions(x, y, n, modl, f, scratch, CONX_PRECISE);
+  }
+
+  // Sets f[i] as definingFunctions() does, to within rounding, and
+  // (gx[i], gy[i]) to the gradient of definingFunction() at the point
+  // (x[i], y[i]) with respect to the modl model's coordinates.  Where the
+  // gradient is undefined, e.g. at a point's center, give a one-sided
+  // gradient or zero.  This is here so that tracing and contouring need
+  // not probe the neighborhood of each point; the default does just that,
+  // by forward differences, so override it with the closed form.
+  virtual void definingGradients(const double *x, const double *y, size_t n,
+                                 ConxModlType modl, double *f, double *gx,
+                                 double *gy, CConxPoint &scratch) const;
+
+  // Returns K such that |definingFunction(P) - definingFunction(Q)| is at
+  // most K times the distance from P to Q for any two points not at
+  // infinity, or a negative number if no such K is known.  The QUADTREE
+  // drawing method uses this to skip regions far from the curve.
+  virtual double getLipschitzConstant() const { return -1.0; }
+
+  // Returns TRUE if definingFunction() is negative on one side of the
+  // curve and positive on the other, as the CONTOUR drawing method
+  // requires.  A distance, which is never negative, does not qualify.
+  virtual Boole hasSignedDefiningFunction() const { return FALSE; }
+
+  // Some defining functions are g(X) - s for a field g that does not depend
+  // on the scalar s, e.g. a circle's is the distance from its center minus
+  // its radius.  If yours is, override hasDefiningField() to return TRUE,
+  // definingScalar() to return s, and definingFields() to set g[i] so that
+  // g[i] - s is exactly what definingFunctions() gives.  sameField(o) must
+  // return TRUE only if o's field is exactly ours.  A canvas may then keep
+  // g around and redraw you with another s or another tolerance without
+  // evaluating g again.
+  virtual Boole hasDefiningField() const { return FALSE; }
+  virtual double definingScalar() const { return 0.0; }
+  virtual void definingFields(const double *x, const double *y, size_t n,
+                              ConxModlType modl, double *g,
+                              CConxPoint &scratch,
+                              ConxPrecision prec = CONX_PRECISE) const
+  {
+    definingFunctions(x, y, n, modl, g, scratch, prec);
+  }
+  // Like definingFields() with CONX_FAST, but stores floats.  Override it
+  // if your field can be computed straight into floats.
+  virtual void definingFieldsf(const double *x, const double *y, size_t n,
+                               ConxModlType modl, float *g,
+                               CConxPoint &scratch) const;
+  virtual Boole sameField(const CConxSimpleArtist &o) const { return FALSE; }
 #define SA_DEFFN() \
  private: \
    static double definingFunctionWrapper(const CConxSimpleArtist *sa, \
@@ -128,6 +208,11 @@ public:
 // a|b, a|c, b|c, and a|b|c are all distinct, we define:
 #define CONX_MODEL2BIT(modl) (1 << modl)
 
+// The bit after the models' bits, which a point or line sets in its
+// bitmask of cached representations when it has cached its hyperboloid
+// vector.
+#define CONX_HYPERBOLOID_BIT CONX_MODEL2BIT(CONX_NUM_MODELS)
+
 
 //////////////////////////////////////////////////////////////////////////////
 // Implementation
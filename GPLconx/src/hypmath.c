@@ -31,6 +31,7 @@
 
 #include "viewer.h"
 #include "util.h"
+#include "simdint.h"
 
 #ifndef HAVE_ACOSH
 extern double acosh(double);
@@ -167,6 +168,119 @@ double conxk_dist(double x, double y, double xx, double yy)
                                   * (sqr(xx)+sqr(yy)-1.0)))));
 }
 
+void conxk_dist_batch(double x, double y, const double *xx,
+                      const double *yy, double *d, size_t n)
+/* Sets d[i] to conxk_dist(x, y, xx[i], yy[i]) for 0 <= i < n. */
+{
+  size_t i = 0;
+  double xyy = sqr(x)+sqr(y)-1.0;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec vx = VSET1(x), vy = VSET1(y), vxyy = VSET1(xyy), one = VSET1(1.0);
+  ConxVec a, b, num, den;
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(xx+i);
+    b = VLOAD(yy+i);
+    num = VABS(VSUB(VADD(VMUL(vx, a), VMUL(vy, b)), one));
+    den = VSUB(VADD(VMUL(a, a), VMUL(b, b)), one);
+    VSTORE(d+i, VDIV(num, VSQRT(VABS(VMUL(vxyy, den)))));
+  }
+#endif
+  for (; i < n; i++)
+    d[i] = myabs(x*xx[i]+y*yy[i]-1.0)
+      / sqrt(myabs(xyy * (sqr(xx[i])+sqr(yy[i])-1.0)));
+  for (i = 0; i < n; i++)
+    d[i] = myabs(acosh(d[i]));
+}
+
+/* conxk_dist_batchf uses double precision for points whose squared
+   Euclidean norm in the Klein disk is within CONX_FAST_EDGE of 1 and for
+   points whose acosh argument is within CONX_FAST_NEAR of 1. */
+#define CONX_FAST_EDGE 1e-3
+#define CONX_FAST_NEAR 1e-4f
+#define CONX_FAST_CHUNK 128
+
+static void dist_batchf(double x, double y, const double *xx,
+                        const double *yy, double *d, float *fd, size_t n)
+/* The body of conxk_dist_batchf and conxk_dist_batchff.  Exactly one of
+   d and fd is non-NULL, and that one receives the distances. */
+{
+  float a[CONX_FAST_CHUNK], b[CONX_FAST_CHUNK], r[CONX_FAST_CHUNK];
+  double xyy = sqr(x)+sqr(y)-1.0;
+  float fx = (float) x, fy = (float) y, fxyy = (float) xyy;
+  size_t i, j, m;
+
+  if (-xyy < CONX_FAST_EDGE) {
+    if (d != NULL) {
+      conxk_dist_batch(x, y, xx, yy, d, n);
+    } else {
+      for (i = 0; i < n; i++)
+        fd[i] = (float) conxk_dist(x, y, xx[i], yy[i]);
+    }
+    return;
+  }
+  for (i = 0; i < n; i += m) {
+    m = n - i;
+    if (m > CONX_FAST_CHUNK) m = CONX_FAST_CHUNK;
+    for (j = 0; j < m; j++) {
+      a[j] = (float) xx[i+j];
+      b[j] = (float) yy[i+j];
+    }
+    j = 0;
+#if CONX_FVEC_WIDTH > 1
+    {
+      ConxFVec vx = FVSET1(fx), vy = FVSET1(fy), vxyy = FVSET1(fxyy);
+      ConxFVec one = FVSET1(1.0f), va, vb, num, den;
+
+      for (; j + CONX_FVEC_WIDTH <= m; j += CONX_FVEC_WIDTH) {
+        va = FVLOAD(a+j);
+        vb = FVLOAD(b+j);
+        num = FVABS(FVSUB(FVADD(FVMUL(vx, va), FVMUL(vy, vb)), one));
+        den = FVSUB(FVADD(FVMUL(va, va), FVMUL(vb, vb)), one);
+        FVSTORE(r+j, FVDIV(num, FVSQRT(FVABS(FVMUL(vxyy, den)))));
+      }
+    }
+#endif
+    for (; j < m; j++) {
+      float num = fx*a[j] + fy*b[j] - 1.0f;
+      float den = fxyy * (a[j]*a[j] + b[j]*b[j] - 1.0f);
+      if (num < 0.0f) num = -num;
+      if (den < 0.0f) den = -den;
+      r[j] = num / (float) sqrt(den); /* as correctly rounded as FVSQRT */
+    }
+    for (j = 0; j < m; j++) {
+      /* float's rounding is far smaller than CONX_FAST_EDGE. */
+      if (1.0f - (a[j]*a[j] + b[j]*b[j]) < (float) CONX_FAST_EDGE
+          || !(r[j] >= 1.0f + CONX_FAST_NEAR)) {
+        double e = conxk_dist(x, y, xx[i+j], yy[i+j]);
+        if (d != NULL) d[i+j] = e; else fd[i+j] = (float) e;
+      } else {
+        float e = logf(r[j] + sqrtf(r[j]*r[j] - 1.0f));
+        if (d != NULL) d[i+j] = (double) e; else fd[i+j] = e;
+      }
+    }
+  }
+}
+
+void conxk_dist_batchf(double x, double y, const double *xx,
+                       const double *yy, double *d, size_t n)
+/* Like conxk_dist_batch, but the argument of acosh is computed in single
+   precision except near the boundary and near (x, y), where float's
+   cancellation would show.  Elsewhere the answer is within a few parts
+   in 10^7 of conxk_dist_batch's. */
+{
+  dist_batchf(x, y, xx, yy, d, NULL, n);
+}
+
+void conxk_dist_batchff(double x, double y, const double *xx,
+                        const double *yy, float *d, size_t n)
+/* Like conxk_dist_batchf, but stores floats, for callers that keep them.
+   The double-precision fallbacks are rounded to float only at the end. */
+{
+  dist_batchf(x, y, xx, yy, NULL, d, n);
+}
+
 double conxk_distAB(Pt A, Pt B)
 {
   return conxk_dist(A.x, A.y, B.x, B.y);
@@ -191,87 +305,376 @@ double yarx(double a, double r, double x)
   return sqrt(myabs((r-(x-a))*(r+(x-a))));
 }
 
+static void conxk_polarmb(double m, double b, double *e, double *f,
+                          double *g)
+/* Sets (*e, *f, *g) so that the line y=mx+b (or x=m if b is KINFINITY) of
+   the Klein disk is ex + fy + g = 0.  The spacelike (e, f, -g) is then the
+   line's pole, orthogonal to each point (x, y, 1) of the line. */
+{
+  if (b == KINFINITY) {
+    *e = 1.0; *f = 0.0; *g = -m;
+  } else {
+    *e = m; *f = -1.0; *g = b;
+  }
+}
+
+static double conxhm_asinh(double t)
+/* asinh(t), which not every libm has */
+{
+  double a = log(myabs(t) + sqrt(1.0 + sqr(t)));
+  return (t < 0.0) ? -a : a;
+}
+
 void conxk_getPtNearXonmb(Pt X, double m, double b, Pt *A, double computol)
+/* Sets *A to the point of the line y=mx+b (or x=m if b is KINFINITY) of
+   the Klein disk that is nearest X, the foot of the perpendicular from X.
+   That is X less its component along the line's pole n = (e, f, -g):
+   X - (<X, n>/<n, n>) n, where <, > is the Minkowski product.  computol
+   is not used; this was once a search along the line to within it. */
 {
-  double t, d1, d2, d3, d4;
-  Pt left, right, midl, midr;
-  int vert;
-  
+  double e, f, g, c;
+
   assert(A != NULL);
+  conxk_polarmb(m, b, &e, &f, &g);
+  c = (e*X.x + f*X.y + g) / (sqr(e) + sqr(f) - sqr(g));
+  A->x = (X.x - c*e) / (1.0 + c*g);
+  A->y = (X.y - c*f) / (1.0 + c*g);
+}
 
-  /* begin aggressive search x=a+r*cos(theta) */
-  conxhm_getendptsmb(m, b, &left, &right);
-  LOGGG4(LOGG_FULL, "\nendpts %f %f %f %f", left.x, left.y, right.x, right.y);
-  vert=((b==KINFINITY)&&(m>-1.0)&&(m<1.0));
-  if (vert) {
-    if (left.y>right.y)
-      conx_swapAB(&left, &right);
-    left.x=left.y+computol;
-    right.x=right.y-computol;
-    left.y=right.y=m;
-  } else {
-    if (left.x>right.x)
-      conx_swapAB(&left, &right);
-    left.x+=computol;
-    right.x-=computol;
-    left.y=m*left.x+b;
-    right.y=m*right.x+b;
-  }
-  t=(right.x-left.x)/3.0;
-  midl.x=left.x+t;
-  midr.x=right.x-t;
-  if (!vert) {
-    midr.y=m*midr.x+b;  
-    midl.y=m*midl.x+b;
-  } else {
-    midr.y = midl.y = m;
-  }
-  d1=conxk_distAB(left, X);
-  d2=conxk_distAB(midl, X);
-  d3=conxk_distAB(midr, X);
-  d4=conxk_distAB(right, X);
-  do {
-    if ((d1<=d2)&&(d1<=d3)&&(d1<=d4)) {
-      right=midl;
-      d4=d2;
-    } else if ((d2<=d1)&&(d2<=d3)&&(d2<=d4)) {
-      right=midr;
-      d4=d3;
-    } else if ((d3<=d1)&&(d3<=d2)&&(d3<=d4)) {
-      left=midl;
-      d1=d2;
-    } else  {
-      left=midr;
-      d1=d3;
-    }
-    t=(right.x-left.x)/3.0;
-    midl.x=left.x+t;
-    midr.x=right.x-t;
-    if (!vert) {
-      midr.y=m*midr.x+b;
-      midl.y=m*midl.x+b;
+double conxk_distmb(double m, double b, double x, double y)
+/* Returns the distance from (x, y) to the line y=mx+b (or x=m if b is
+   KINFINITY) in the Klein disk.  See conxk_distmb_grad(). */
+{
+  double e, f, g, t;
+
+  conxk_polarmb(m, b, &e, &f, &g);
+  t = (e*x + f*y + g)
+    / sqrt((1.0 - sqr(x) - sqr(y)) * (sqr(e) + sqr(f) - sqr(g)));
+  return myabs(conxhm_asinh(t));
+}
+
+double conxk_distFrommbX(double m, double b, Pt X, double computol)
+/* Returns the distance from X to the line y=mx+b (or x=m if b is
+   KINFINITY) in the Klein disk.  computol is not used. */
+{
+  return conxk_distmb(m, b, X.x, X.y);
+}
+
+void conxk_dist_grad(double ax, double ay, double x, double y,
+                     double *d, double *gx, double *gy)
+/* Sets *d to conxk_dist(ax, ay, x, y) and (*gx, *gy) to its gradient with
+   respect to (x, y), which we call zero where the points coincide.  Both
+   points must be strictly inside the disk.
+
+   With w = 1 - A.X, p = 1 - |A|^2, and q = 1 - |X|^2, cosh d = u =
+   w/sqrt(pq), so grad u = (-A + wX/q)/sqrt(pq) and grad d = grad u /
+   sinh d. */
+{
+  double p, q, w, s, u, sh;
+
+  assert(d != NULL); assert(gx != NULL); assert(gy != NULL);
+  p = 1.0 - sqr(ax) - sqr(ay);
+  q = 1.0 - sqr(x) - sqr(y);
+  w = 1.0 - ax*x - ay*y;
+  s = sqrt(p*q);
+  u = w/s;
+  if (u < 1.0) u = 1.0;
+  *d = acosh(u);
+  sh = sqrt((u - 1.0)*(u + 1.0));
+  if (!(sh > 0.0)) {
+    *gx = *gy = 0.0;
+    return;
+  }
+  *gx = (w*x/q - ax) / (s*sh);
+  *gy = (w*y/q - ay) / (s*sh);
+}
+
+void conxk_distmb_grad(double m, double b, double x, double y,
+                       double *d, double *gx, double *gy)
+/* Sets *d to the distance from (x, y) to the line y=mx+b (or x=m if b is
+   KINFINITY) in the Klein disk and (*gx, *gy) to its gradient, which on
+   the line is the gradient from the side toward which mx+b-y increases.
+
+   A line ex + fy + g = 0 is the set of points of the hyperboloid
+   orthogonal to the spacelike (e, f, -g), and so, with q = 1 - |X|^2 and
+   t = (ex + fy + g)/sqrt(q(e^2 + f^2 - g^2)), sinh d = |t|. */
+{
+  double e, f, g, L, q, r, t, s, c;
+
+  assert(d != NULL); assert(gx != NULL); assert(gy != NULL);
+  conxk_polarmb(m, b, &e, &f, &g);
+  L = e*x + f*y + g;
+  q = 1.0 - sqr(x) - sqr(y);
+  r = sqrt(q * (sqr(e) + sqr(f) - sqr(g)));
+  t = L/r;
+  s = (t < 0.0) ? -1.0 : 1.0;
+  c = sqrt(1.0 + sqr(t));
+  *d = log(myabs(t) + c); /* |asinh(t)|, which not every libm has */
+  r *= s * c;
+  *gx = (e + L*x/q) / r;
+  *gy = (f + L*y/q) / r;
+}
+
+/*********************************************************************
+  The hyperboloid model is the sheet T^2 - X^2 - Y^2 = 1, T > 0, with
+  the Minkowski product <a, b> = a0 b0 + a1 b1 - a2 b2; we write its
+  points as (X, Y, T).  The distance between two of them is
+  acosh(-<a, b>).  A line is the set of points orthogonal to its pole n,
+  which is spacelike, and if <n, n> = 1, a point's distance from the line
+  is |asinh(<a, n>)|.  Each of the three models is a projection of it.
+**********************************************************************/
+
+int conxhm_toh(ConxModlType modl, double x, double y, double *h)
+/* Sets h to the point of the hyperboloid that is (x, y) in the modl model.
+   We go there directly rather than by way of the Klein disk, so points
+   near the boundary of a Poincare model keep more of their precision.
+   Returns zero, leaving h useless, if (x, y) is not strictly inside. */
+{
+  double s, t;
+
+  assert(h != NULL);
+  switch (modl) {
+  case CONX_KLEIN_DISK:
+    t = 1.0/sqrt(1.0 - sqr(x) - sqr(y));
+    h[0] = x*t; h[1] = y*t; h[2] = t;
+    break;
+  case CONX_POINCARE_DISK:
+    s = sqr(x) + sqr(y);
+    t = 1.0/(1.0 - s);
+    h[0] = 2.0*x*t; h[1] = 2.0*y*t; h[2] = (1.0 + s)*t;
+    break;
+  default:
+    assert(modl == CONX_POINCARE_UHP);
+    s = sqr(x) + sqr(y);
+    t = 0.5/y;
+    h[0] = 2.0*x*t; h[1] = (s - 1.0)*t; h[2] = (s + 1.0)*t;
+  }
+  return (1.0/h[2] > 0.0); /* T is positive and finite */
+}
+
+void conxhm_fromh(const double *h, ConxModlType modl, double *x, double *y)
+/* Sets (*x, *y) to the point h of the hyperboloid in the modl model. */
+{
+  double d;
+
+  assert(h != NULL); assert(x != NULL); assert(y != NULL);
+  switch (modl) {
+  case CONX_KLEIN_DISK:
+    d = h[2];
+    break;
+  case CONX_POINCARE_DISK:
+    d = 1.0 + h[2];
+    break;
+  default:
+    assert(modl == CONX_POINCARE_UHP);
+    d = h[2] - h[1];
+    *x = h[0]/d;
+    *y = 1.0/d;
+    return;
+  }
+  *x = h[0]/d;
+  *y = h[1]/d;
+}
+
+void conxhm_toh_batch(ConxModlType modl, const double *x, const double *y,
+                      double *X, double *Y, double *T, size_t n)
+/* Sets (X[i], Y[i], T[i]) to the point of the hyperboloid that is
+   (x[i], y[i]) in the modl model just as conxhm_toh does. */
+{
+  size_t i = 0;
+  double h[3];
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec a, b, s, t, one = VSET1(1.0), two = VSET1(2.0), half = VSET1(0.5);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(x+i);
+    b = VLOAD(y+i);
+    if (modl == CONX_KLEIN_DISK) {
+      t = VDIV(one, VSQRT(VSUB(VSUB(one, VMUL(a, a)), VMUL(b, b))));
+      VSTORE(X+i, VMUL(a, t));
+      VSTORE(Y+i, VMUL(b, t));
+      VSTORE(T+i, t);
+    } else if (modl == CONX_POINCARE_DISK) {
+      s = VADD(VMUL(a, a), VMUL(b, b));
+      t = VDIV(one, VSUB(one, s));
+      VSTORE(X+i, VMUL(VMUL(two, a), t));
+      VSTORE(Y+i, VMUL(VMUL(two, b), t));
+      VSTORE(T+i, VMUL(VADD(one, s), t));
+    } else {
+      s = VADD(VMUL(a, a), VMUL(b, b));
+      t = VDIV(half, b);
+      VSTORE(X+i, VMUL(VMUL(two, a), t));
+      VSTORE(Y+i, VMUL(VSUB(s, one), t));
+      VSTORE(T+i, VMUL(VADD(s, one), t));
     }
-    
-    d2=conxk_distAB(midl, X); 
-    d3=conxk_distAB(midr, X);
-  } while (myabs(t)>computol);
+  }
+#endif
+  for (; i < n; i++) {
+    (void) conxhm_toh(modl, x[i], y[i], h);
+    X[i] = h[0]; Y[i] = h[1]; T[i] = h[2];
+  }
+}
 
-  A->x=(left.x+right.x)/2.0;
+static double conxh_dist_near(const double *a, double x, double y, double t)
+/* Returns the distance between a and (x, y, t) on the hyperboloid as
+   2 asinh(|a - (x, y, t)|/2), which, unlike acosh(-<a, b>), keeps its
+   precision when the points are close together. */
+{
+  double q = sqr(a[0] - x) + sqr(a[1] - y) - sqr(a[2] - t);
 
-  if (vert) {
-    A->y=A->x;
-    A->x=m;
-  } else {
-    A->y=m*A->x+b;
+  return 2.0*conxhm_asinh(0.5*sqrt((q > 0.0) ? q : 0.0));
+}
+
+double conxh_dist(const double *a, const double *b)
+/* Returns the distance between the points a and b of the hyperboloid. */
+{
+  double u = a[2]*b[2] - a[0]*b[0] - a[1]*b[1];
+
+  if (u > 2.0) return acosh(u);
+  return conxh_dist_near(a, b[0], b[1], b[2]);
+}
+
+void conxh_dist_batch(const double *a, const double *X, const double *Y,
+                      const double *T, double *d, size_t n)
+/* Sets d[i] to conxh_dist(a, (X[i], Y[i], T[i])) for 0 <= i < n. */
+{
+  size_t i = 0;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec ax = VSET1(a[0]), ay = VSET1(a[1]), at = VSET1(a[2]);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    VSTORE(d+i, VSUB(VSUB(VMUL(at, VLOAD(T+i)), VMUL(ax, VLOAD(X+i))),
+                     VMUL(ay, VLOAD(Y+i))));
+  }
+#endif
+  for (; i < n; i++)
+    d[i] = a[2]*T[i] - a[0]*X[i] - a[1]*Y[i];
+  for (i = 0; i < n; i++) {
+    if (d[i] > 2.0)
+      d[i] = acosh(d[i]);
+    else
+      d[i] = conxh_dist_near(a, X[i], Y[i], T[i]);
   }
 }
 
-double conxk_distFrommbX(double m, double b, Pt X, double computol)
+void conxh_dist_clamp_batch(const double *a, const double *X,
+                            const double *Y, const double *T, double *d,
+                            size_t n, double lo, double hi)
+/* Sets d[i] to conxh_dist(a, (X[i], Y[i], T[i])) clamped to [lo, hi] for
+   0 <= i < n.  The cosh of the distance is compared with cosh(lo) and
+   cosh(hi) first, so only the points whose distances are strictly between
+   cost an acosh, and those get exactly what conxh_dist_batch gives.  At
+   the ends, the comparison may decide differently than rounding acosh's
+   answer would. */
+{
+  double ulo = (lo > 0.0) ? cosh(lo) : 0.0;
+  double uhi = (hi > 0.0) ? cosh(hi) : 0.0;
+  size_t i = 0;
+
+  assert(lo <= hi);
+#if CONX_VEC_WIDTH > 1
+  {
+    ConxVec ax = VSET1(a[0]), ay = VSET1(a[1]), at = VSET1(a[2]);
+
+    for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+      VSTORE(d+i, VSUB(VSUB(VMUL(at, VLOAD(T+i)), VMUL(ax, VLOAD(X+i))),
+                       VMUL(ay, VLOAD(Y+i))));
+    }
+  }
+#endif
+  for (; i < n; i++)
+    d[i] = a[2]*T[i] - a[0]*X[i] - a[1]*Y[i];
+  for (i = 0; i < n; i++) {
+    if (d[i] <= ulo)
+      d[i] = lo;
+    else if (d[i] >= uhi)
+      d[i] = hi;
+    else if (d[i] > 2.0)
+      d[i] = acosh(d[i]);
+    else
+      d[i] = conxh_dist_near(a, X[i], Y[i], T[i]);
+  }
+}
+
+int conxh_pole(const double *a, const double *b, double *n)
+/* Sets n to the pole, with <n, n> = 1, of the line through a and b.  Each
+   of a and b is a point of the hyperboloid or, if it is at infinity, its
+   Klein disk coordinates with 1 appended.  Returns zero if the two are
+   one point. */
+{
+  double c[3], l;
+
+  assert(a != NULL); assert(b != NULL); assert(n != NULL);
+  /* The cross product is orthogonal to a and b in the Euclidean sense, so
+     with its last component negated it is in the Minkowski sense. */
+  c[0] = a[1]*b[2] - a[2]*b[1];
+  c[1] = a[2]*b[0] - a[0]*b[2];
+  c[2] = a[1]*b[0] - a[0]*b[1];
+  l = sqr(c[0]) + sqr(c[1]) - sqr(c[2]);
+  if (!(l > 0.0)) return 0;
+  l = sqrt(l);
+  n[0] = c[0]/l; n[1] = c[1]/l; n[2] = c[2]/l;
+  return 1;
+}
+
+int conxk_polemb(double m, double b, double *n)
+/* Sets n to the pole, with <n, n> = 1, of the line y=mx+b (or x=m if b is
+   KINFINITY) of the Klein disk.  Returns zero if the line misses the
+   disk. */
 {
-  Pt Near;
+  double e, f, g, l;
+
+  assert(n != NULL);
+  conxk_polarmb(m, b, &e, &f, &g);
+  l = sqr(e) + sqr(f) - sqr(g);
+  if (!(l > 0.0)) return 0;
+  l = sqrt(l);
+  n[0] = e/l; n[1] = f/l; n[2] = -g/l;
+  return 1;
+}
 
-  conxk_getPtNearXonmb(X, m, b, &Near, computol);
-  return conxk_distAB(Near, X);
+double conxh_distline(const double *n, const double *h)
+/* Returns the distance from the point h of the hyperboloid to the line
+   whose pole is n, where <n, n> = 1. */
+{
+  return myabs(conxhm_asinh(h[0]*n[0] + h[1]*n[1] - h[2]*n[2]));
+}
+
+int conxhm_tok_jacobian(ConxModlType modl, double x, double y,
+                        double *kx, double *ky, double J[4])
+/* Sets (*kx, *ky) to the Klein coordinates of the point (x, y) of the modl
+   model and J to the Jacobian of that map at (x, y), i.e. d(kx)/dx,
+   d(kx)/dy, d(ky)/dx, d(ky)/dy, so that a gradient (gx, gy) with respect
+   to Klein coordinates is (J[0]gx + J[2]gy, J[1]gx + J[3]gy) with respect
+   to modl's.  Returns zero if (x, y) is not strictly inside the model. */
+{
+  double S = sqr(x) + sqr(y), t = 1.0 + S;
+
+  assert(kx != NULL); assert(ky != NULL); assert(J != NULL);
+  switch (modl) {
+  case CONX_KLEIN_DISK:
+    *kx = x; *ky = y;
+    J[0] = J[3] = 1.0;
+    J[1] = J[2] = 0.0;
+    break;
+  case CONX_POINCARE_DISK:
+    *kx = 2.0*x/t; *ky = 2.0*y/t;
+    J[0] = 2.0/t - 4.0*x*x/sqr(t);
+    J[1] = J[2] = -4.0*x*y/sqr(t);
+    J[3] = 2.0/t - 4.0*y*y/sqr(t);
+    break;
+  default:
+    assert(modl == CONX_POINCARE_UHP);
+    if (!(y > 0.0)) return 0;
+    *kx = 2.0*x/t; *ky = (S - 1.0)/t;
+    J[0] = 2.0/t - 4.0*x*x/sqr(t);
+    J[1] = -4.0*x*y/sqr(t);
+    J[2] = 4.0*x/sqr(t);
+    J[3] = 4.0*y/sqr(t);
+  }
+  return (sqr(*kx) + sqr(*ky) < 1.0);
 }
 
 void conxhm_getendptsc(double cx, double cy, Pt *enda, Pt *endb)
@@ -312,15 +715,24 @@ http://riceinfo.rice.edu/projects/NonEuclid/technical.html */
 }
 
 double conxpd_distFromcX(double cx, double cy, Pt X, double computol)
+/* Returns the distance from X to the Poincare disk line whose circle has
+   center (cx, cy), or, if that line is a diameter, that goes through
+   (cx, cy) as conxhm_getendptsc() has it.  With q = 1 - |X|^2, sinh d is
+   | |X - c|^2 - r^2 | / (rq) for the circle of radius r, and 2|X.u|/q for
+   the diameter with unit normal u.  computol is not used. */
 {
-  Pt kendb;
-  double m, b;
-  
-  
-  conxhm_getmbfromc(cx, cy, &m, &b);
-  conxhm_pdtokAB(X, &X);
-  conxk_getPtNearXonmb(X, m, b, &kendb, computol);
-  return conxk_distAB(X, kendb); 
+  double r, q, s;
+
+  q = 1.0 - sqr(X.x) - sqr(X.y);
+  r = conxpd_getr(cx, cy);
+  if (r != DIAMETER) {
+    return myabs(conxhm_asinh((sqr(X.x - cx) + sqr(X.y - cy) - sqr(r))
+                              / (r*q)));
+  }
+  if (myabs(cx) <= VERTICALNESS)
+    return myabs(conxhm_asinh(2.0*X.x/q));
+  s = cy/cx;
+  return myabs(conxhm_asinh(2.0*(s*X.x - X.y) / (sqrt(1.0 + sqr(s))*q)));
 }
 
 void conxp_getPtNearXonar(Pt X, double a, double r, Pt *A, double computol)
@@ -339,10 +751,15 @@ void conxp_getPtNearXonar(Pt X, double a, double r, Pt *A, double computol)
 
 
 double conxp_distFromarX(double a, double r, Pt X, double computol)
+/* Returns the distance from X to the Poincare UHP line that is the
+   semicircle of center (a, 0) and radius r or, if r is TYPEI, the vertical
+   line x=a.  sinh d is |(x-a)^2 + y^2 - r^2| / (2ry) for the semicircle
+   and |x-a|/y for the vertical line.  computol is not used. */
 {
-  Pt A; /* the point on the line nearest X */
-  conxp_getPtNearXonar(X, a, r, &A, computol);
-  return conxp_distAB(X,A);
+  if (r == TYPEI)
+    return myabs(conxhm_asinh((X.x - a)/X.y));
+  return myabs(conxhm_asinh((sqr(X.x - a) + sqr(X.y) - sqr(r))
+                            / (2.0*r*X.y)));
 }
 
 
@@ -388,6 +805,138 @@ void conxhm_pdtok(double x, double y, double *u, double *v)
 /*  if (loglevel > 1000) fprintf(stderr, "\n%f %f = u v %f %f = x y", x, y, *u, *v); fflush(stderr);  */
 }
 
+void conxhm_ptok_batch(const double *x, const double *y, double *u,
+                       double *v, size_t n)
+/* Converts the n Poincare UHP points (x[i], y[i]) to the Beltrami-Klein
+   disk points (u[i], v[i]) just as conxhm_ptok does.  u and v may be x
+   and y. */
+{
+  size_t i = 0;
+  double sumsqrs, t;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec a, b, s, den, one = VSET1(1.0), two = VSET1(2.0);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(x+i);
+    b = VLOAD(y+i);
+    s = VADD(VMUL(a, a), VMUL(b, b));
+    den = VADD(one, s);
+    VSTORE(u+i, VDIV(VMUL(two, a), den));
+    VSTORE(v+i, VDIV(VSUB(s, one), den));
+  }
+#endif
+  for (; i < n; i++) {
+    sumsqrs=sqr(x[i])+sqr(y[i]);
+    t=2.0*x[i]/(1.0+sumsqrs);
+    v[i]=(sumsqrs-1.0)/(1.0+sumsqrs);
+    u[i]=t;
+  }
+}
+
+void conxhm_pdtok_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n)
+/* Converts the n Poincare disk points (x[i], y[i]) to the Beltrami-Klein
+   disk points (u[i], v[i]) just as conxhm_pdtok does.  u and v may be x
+   and y. */
+{
+  size_t i = 0;
+  double temp, t;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec a, b, den, one = VSET1(1.0), two = VSET1(2.0);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(x+i);
+    b = VLOAD(y+i);
+    den = VADD(VADD(one, VMUL(a, a)), VMUL(b, b));
+    VSTORE(u+i, VDIV(VMUL(two, a), den));
+    VSTORE(v+i, VDIV(VMUL(two, b), den));
+  }
+#endif
+  for (; i < n; i++) {
+    temp=1.0+sqr(x[i])+sqr(y[i]);
+    t=2.0*x[i]/temp;
+    v[i]=2.0*y[i]/temp;
+    u[i]=t;
+  }
+}
+
+void conxhm_ktop_batch(const double *x, const double *y, double *u,
+                       double *v, size_t n)
+/* Converts the n Beltrami-Klein disk points (x[i], y[i]) to the Poincare
+   UHP points (u[i], v[i]) just as conxhm_ktop does.  u and v may be x
+   and y. */
+{
+  size_t i = 0;
+  double t;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec a, b, den, one = VSET1(1.0);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(x+i);
+    b = VLOAD(y+i);
+    den = VSUB(one, b);
+    VSTORE(u+i, VDIV(a, den));
+    VSTORE(v+i, VDIV(VSQRT(VSUB(VSUB(one, VMUL(a, a)), VMUL(b, b))), den));
+  }
+#endif
+  for (; i < n; i++) {
+    t=x[i]/(1.0-y[i]);
+    v[i]=sqrt(1.0-sqr(x[i])-sqr(y[i]))/(1.0-y[i]);
+    u[i]=t;
+  }
+}
+
+void conxhm_ktopd_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n)
+/* Converts the n Beltrami-Klein disk points (x[i], y[i]) to the Poincare
+   disk points (u[i], v[i]) just as conxhm_ktopd does.  u and v may be x
+   and y. */
+{
+  size_t i = 0;
+  double temp;
+
+#if CONX_VEC_WIDTH > 1
+  ConxVec a, b, den, one = VSET1(1.0);
+
+  for (; i + CONX_VEC_WIDTH <= n; i += CONX_VEC_WIDTH) {
+    a = VLOAD(x+i);
+    b = VLOAD(y+i);
+    den = VADD(one,
+               VSQRT(VABS(VSUB(VSUB(one, VMUL(a, a)), VMUL(b, b)))));
+    VSTORE(u+i, VDIV(a, den));
+    VSTORE(v+i, VDIV(b, den));
+  }
+#endif
+  for (; i < n; i++) {
+    temp=1.0+sqrt(myabs(1.0-sqr(x[i])-sqr(y[i])));
+    u[i]=x[i]/temp;
+    v[i]=y[i]/temp;
+  }
+}
+
+void conxhm_pdtop_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n)
+/* Converts the n Poincare disk points (x[i], y[i]) to the Poincare UHP
+   points (u[i], v[i]) just as conxhm_pdtop does, i.e. by way of the
+   Klein disk.  u and v may be x and y. */
+{
+  conxhm_pdtok_batch(x, y, u, v, n);
+  conxhm_ktop_batch(u, v, u, v, n);
+}
+
+void conxhm_ptopd_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n)
+/* Converts the n Poincare UHP points (x[i], y[i]) to the Poincare disk
+   points (u[i], v[i]) just as conxhm_ptopd does.  u and v may be x
+   and y. */
+{
+  conxhm_ptok_batch(x, y, u, v, n);
+  conxhm_ktopd_batch(u, v, u, v, n);
+}
+
 void conxhm_pdtop(double x, double y, double *u, double *v)
 /* see millman/parker p. 304 */
 {
@@ -603,6 +1152,7 @@ void conxpd_getCenterAndRadius(double x1, double y1, double x2, double y2,
     *rad=DIAMETER; 
     if (myabs(x2-x1)>VERTICALNESS) {
       m=(y2-y1)/(x2-x1);
+      *cx=0.6;
       *cy=0.6*m;
       if (myabs(*cy)>=0.8) {     /* if (.6, y) not inside the unit circle */
 	*cx=0.79/m;
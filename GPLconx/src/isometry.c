@@ -0,0 +1,194 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Isometries of the hyperbolic plane, i.e. the hyperbolic translations and
+  rotations with which a canvas moves its view.
+
+  An isometry is an element of SU(1,1), a 2x2 complex matrix
+  [[a, b], [conj(b), conj(a)]] with |a|^2 - |b|^2 = 1, that acts on the
+  Poincare disk as the Mobius transformation
+  z -> (a z + b) / (conj(b) z + conj(a)).  On the hyperboloid, and so on
+  the Klein disk, which is its projection from the origin, the same
+  isometry is a Lorentz matrix; see conx_isom_lorentz().  On the Poincare
+  UHP we go by way of the Poincare disk.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <math.h>
+
+#include "viewer.h"
+#include "util.h"
+
+void conx_isom_identity(ConxIsometry *g)
+{
+  assert(g != NULL);
+  g->ar = 1.0; g->ai = 0.0;
+  g->br = 0.0; g->bi = 0.0;
+}
+
+void conx_isom_rotation(ConxIsometry *g, double theta)
+/* Sets *g to the rotation by theta radians, counterclockwise, about the
+   origin of the Poincare disk. */
+{
+  assert(g != NULL);
+  g->ar = cos(theta / 2.0); g->ai = sin(theta / 2.0);
+  g->br = 0.0; g->bi = 0.0;
+}
+
+int conx_isom_translation(ConxIsometry *g, double px, double py)
+/* Sets *g to the translation that takes the origin of the Poincare disk to
+   (px, py) along the line through them.  Returns zero, leaving *g alone,
+   if (px, py) is not strictly inside the disk. */
+{
+  double s = sqr(px) + sqr(py);
+
+  assert(g != NULL);
+  if (!(s < 1.0)) return 0;
+  s = 1.0 / sqrt(1.0 - s);
+  g->ar = s; g->ai = 0.0;
+  g->br = px * s; g->bi = py * s;
+  return 1;
+}
+
+void conx_isom_compose(const ConxIsometry *g, const ConxIsometry *h,
+                       ConxIsometry *gh)
+/* Sets *gh to the isometry that applies *h and then *g.  gh may be g or
+   h.  We scale the result back onto SU(1,1) so that rounding errors do not
+   build up as a user drags the view about. */
+{
+  double ar, ai, br, bi, s;
+
+  assert(g != NULL); assert(h != NULL); assert(gh != NULL);
+  /* [[a, b], [b~, a~]] [[c, d], [d~, c~]] has a = ac + bd~, b = ad + bc~. */
+  ar = g->ar*h->ar - g->ai*h->ai + g->br*h->br + g->bi*h->bi;
+  ai = g->ar*h->ai + g->ai*h->ar + g->bi*h->br - g->br*h->bi;
+  br = g->ar*h->br - g->ai*h->bi + g->br*h->ar + g->bi*h->ai;
+  bi = g->ar*h->bi + g->ai*h->br + g->bi*h->ar - g->br*h->ai;
+  s = sqr(ar) + sqr(ai) - sqr(br) - sqr(bi);
+  assert(s > 0.0);
+  s = 1.0 / sqrt(s);
+  gh->ar = ar * s; gh->ai = ai * s;
+  gh->br = br * s; gh->bi = bi * s;
+}
+
+void conx_isom_inverse(const ConxIsometry *g, ConxIsometry *gi)
+/* Sets *gi to the inverse of *g.  gi may be g. */
+{
+  assert(g != NULL); assert(gi != NULL);
+  gi->ar = g->ar; gi->ai = -g->ai;
+  gi->br = -g->br; gi->bi = -g->bi;
+}
+
+int conx_isom_is_identity(const ConxIsometry *g)
+/* Returns nonzero if *g moves no point.  -1 acts as 1 does. */
+{
+  assert(g != NULL);
+  return (g->ai == 0.0 && g->br == 0.0 && g->bi == 0.0);
+}
+
+void conx_isom_lorentz(const ConxIsometry *g, double M[9])
+/* Sets M, row by row, to the Lorentz matrix that moves the point (X, Y, T)
+   of the hyperboloid as *g moves the Poincare disk.  With w = X + iY,
+   the point is the Hermitian matrix (1/2)[[T, w], [conj(w), T]], on which
+   *g acts by conjugation, so w' = a^2 w + b^2 conj(w) + 2abT and
+   T' = (|a|^2 + |b|^2) T + 2 Re(a conj(b) w). */
+{
+  double a2r, a2i, b2r, b2i, abr, abi, cr, ci;
+
+  assert(g != NULL); assert(M != NULL);
+  a2r = sqr(g->ar) - sqr(g->ai); a2i = 2.0 * g->ar * g->ai;
+  b2r = sqr(g->br) - sqr(g->bi); b2i = 2.0 * g->br * g->bi;
+  abr = g->ar * g->br - g->ai * g->bi; abi = g->ar * g->bi + g->ai * g->br;
+  cr = g->ar * g->br + g->ai * g->bi; ci = g->ai * g->br - g->ar * g->bi;
+  M[0] = a2r + b2r; M[1] = b2i - a2i; M[2] = 2.0 * abr;
+  M[3] = a2i + b2i; M[4] = a2r - b2r; M[5] = 2.0 * abi;
+  M[6] = 2.0 * cr;  M[7] = -2.0 * ci;
+  M[8] = sqr(g->ar) + sqr(g->ai) + sqr(g->br) + sqr(g->bi);
+}
+
+void conx_isom_apply_pts(const ConxIsometry *g, ConxModlType modl,
+                         const Pt *in, Pt *out, size_t n)
+/* Sets out[i] to the image under *g of the point in[i] of the modl model
+   for 0 <= i < n.  out may be in.  This is how a canvas moves a cached
+   scene, so there are no calls per point. */
+{
+#define ISOM_CHUNK 128
+  double M[9], x, y, w, u, v, d, xs[ISOM_CHUNK], ys[ISOM_CHUNK];
+  Pt P[ISOM_CHUNK];
+  size_t i, j, m;
+
+  assert(g != NULL);
+  assert(n == 0 || (in != NULL && out != NULL));
+  switch (modl) {
+  case CONX_KLEIN_DISK:
+    /* The Klein disk is projective, so (x, y, 1) needs no normalizing. */
+    conx_isom_lorentz(g, M);
+    for (i = 0; i < n; i++) {
+      x = in[i].x; y = in[i].y;
+      w = M[6]*x + M[7]*y + M[8];
+      out[i].x = (M[0]*x + M[1]*y + M[2]) / w;
+      out[i].y = (M[3]*x + M[4]*y + M[5]) / w;
+    }
+    break;
+  case CONX_POINCARE_DISK:
+    for (i = 0; i < n; i++) {
+      x = in[i].x; y = in[i].y;
+      /* (a z + b) / (conj(b) z + conj(a)) */
+      u = g->ar*x - g->ai*y + g->br;
+      v = g->ar*y + g->ai*x + g->bi;
+      w = g->br*x + g->bi*y + g->ar;
+      d = g->br*y - g->bi*x - g->ai;
+      x = sqr(w) + sqr(d);
+      out[i].x = (u*w + v*d) / x;
+      out[i].y = (v*w - u*d) / x;
+    }
+    break;
+  default:
+    assert(modl == CONX_POINCARE_UHP);
+    for (i = 0; i < n; i += m) {
+      m = n - i;
+      if (m > ISOM_CHUNK) m = ISOM_CHUNK;
+      for (j = 0; j < m; j++) {
+        xs[j] = in[i+j].x;
+        ys[j] = in[i+j].y;
+      }
+      conxhm_ptopd_batch(xs, ys, xs, ys, m);
+      for (j = 0; j < m; j++) {
+        P[j].x = xs[j];
+        P[j].y = ys[j];
+      }
+      conx_isom_apply_pts(g, CONX_POINCARE_DISK, P, P, m);
+      for (j = 0; j < m; j++) {
+        xs[j] = P[j].x;
+        ys[j] = P[j].y;
+      }
+      conxhm_pdtop_batch(xs, ys, xs, ys, m);
+      for (j = 0; j < m; j++) {
+        out[i+j].x = xs[j];
+        out[i+j].y = ys[j];
+      }
+    }
+  }
+#undef ISOM_CHUNK
+}
@@ -0,0 +1,512 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Templates for the Bresenham and LONGWAY methods.  conx_bresenham_batch
+  and conx_lattice_longway_sink call the metric, the continuation
+  predicate, and the sink through function pointers, so nothing inlines
+  across those calls.  The templates here do what those functions do,
+  point for point, but the metric, predicate, and sink are template
+  parameters, so that the compiler sees through them.  Each is a class
+  with these members:
+
+    metric:    void operator()(const double *x, const double *y,
+                               double *f, size_t n)
+               as a ConxBatchMetric.
+    predicate: int operator()(Pt middle, Pt oldmiddle)
+               as a ConxContinueFunc.
+    sink:      void operator()(double x, double y) to draw a point, and
+               void flush() to finish a batch of them.
+
+  CConxArtistMetric<A> is the metric of an artist whose class is A;
+  CConxHoistedMetric<A, M> is that of a line-based artist in the model M.
+  conxWithArtistMetric() finds A (and M) from a CConxSimpleArtist.
+  CConxThreadMetrics<M> hands copies of such a metric to the C functions
+  that run several threads, so that those avoid the virtual calls too.
+
+  The C functions stay for gconx and tconx, which are C.  The two share
+  the memo of bresint.h, so they draw the same points.
+*/
+
+#ifndef GPLCONX_KERNELS_CXX_H
+#define GPLCONX_KERNELS_CXX_H 1
+
+#include <assert.h>
+
+#include "h_all.hh"
+#include "bresint.h"
+
+//////////////////////////////////////////////////////////////////////////////
+// Calls a ConxBatchMetric through its pointer.
+class CConxBatchMetricCall {
+public:
+  CConxBatchMetricCall(ConxBatchMetric *f, void *a) : func(f), fArg(a)
+  {
+    assert(f != NULL);
+  }
+  void operator()(const double *x, const double *y, double *f, size_t n)
+  {
+    (*func)(x, y, f, n, fArg);
+  }
+
+private:
+  ConxBatchMetric *func;
+  void *fArg;
+}; // class CConxBatchMetricCall
+
+//////////////////////////////////////////////////////////////////////////////
+// Calls a ConxContinueFunc through its pointer.
+class CConxContinueCall {
+public:
+  CConxContinueCall(ConxContinueFunc *f, void *a) : func(f), kArg(a)
+  {
+    assert(f != NULL);
+  }
+  int operator()(Pt middle, Pt oldmiddle)
+  {
+    return (*func)(middle, oldmiddle, kArg);
+  }
+
+private:
+  ConxContinueFunc *func;
+  void *kArg;
+}; // class CConxContinueCall
+
+//////////////////////////////////////////////////////////////////////////////
+// Draws points into a ConxVertexSink, which hands them on in batches.
+class CConxSinkCall {
+public:
+  CConxSinkCall(ConxVertexSink *s) : sink(s) { assert(s != NULL); }
+  void operator()(double x, double y) { CONX_SINK_VERTEX(sink, x, y); }
+  void flush() { conx_sink_flush(sink); }
+
+private:
+  ConxVertexSink *sink;
+}; // class CConxSinkCall
+
+//////////////////////////////////////////////////////////////////////////////
+// Keeps going while a point is in the visible part of the model and we
+// are still moving, which is what a canvas wants of a Bresenham trace.
+class CConxViewKeepGoing {
+public:
+  CConxViewKeepGoing(ConxModlType m, double x0, double x1, double y0,
+                     double y1)
+    : modl(m), xmin(x0), xmax(x1), ymin(y0), ymax(y1) { }
+  int operator()(Pt middle, Pt oldmiddle) const
+  {
+    return (((modl != CONX_POINCARE_UHP)
+             ? (sqr(middle.x) + sqr(middle.y) < 1.0)
+             /* DLC what about xmin and xmax?  We can save time but may
+                have to reenter if we treat them correctly, the same
+                troubles as in the Poincare UHP. */
+             : ((middle.x < xmax) && (middle.x > xmin)
+                && (middle.y < ymax) && (middle.y > ymin)))
+            && (myabs(middle.x - oldmiddle.x) + myabs(middle.y - oldmiddle.y)
+                > ARBITRARILYSMALL));
+  }
+
+private:
+  ConxModlType modl;
+  double xmin, xmax, ymin, ymax;
+}; // class CConxViewKeepGoing
+
+//////////////////////////////////////////////////////////////////////////////
+// The defining function of an artist of class A in the modl model, called
+// without a virtual function call.  This suits artists that override
+// definingFunctions(); for a line-based artist, whose definingFunctions()
+// would call the virtual definingFunction() per point, use
+// CConxHoistedMetric instead.  With CONX_COMPARE and a positive tolerance
+// t, the metric is A's thresholdFunctions() instead.
+template <class A>
+class CConxArtistMetric {
+public:
+  CConxArtistMetric(const A &a, ConxModlType m, ConxPrecision p, double t)
+    : artist(a), modl(m), prec(p), tol(t) { }
+  void operator()(const double *x, const double *y, double *f, size_t n)
+  {
+    if (prec == CONX_COMPARE && tol > 0.0)
+      artist.A::thresholdFunctions(x, y, n, modl, tol, f, X);
+    else
+      artist.A::definingFunctions(x, y, n, modl, f, X, prec);
+  }
+
+private:
+  const A &artist;
+  ConxModlType modl;
+  ConxPrecision prec;
+  double tol;
+  CConxPoint X;
+}; // class CConxArtistMetric
+
+//////////////////////////////////////////////////////////////////////////////
+// The parameters of a line, an equidistant curve, or a parabola that
+// CConxHoistedMetric finds once per draw: the line's pole, the focus on
+// the hyperboloid, and the equidistant curve's distance.
+struct ConxHoistedLine {
+  double n[3], a[3], s;
+};
+
+inline Boole conxHoist(const CConxLine &L, ConxHoistedLine &p)
+{
+  p.s = 0.0;
+  return L.getPole(p.n);
+}
+
+inline Boole conxHoist(const CConxEqDistCurve &E, ConxHoistedLine &p)
+{
+  p.s = E.getDistance();
+  return E.getLine().getPole(p.n);
+}
+
+inline Boole conxHoist(const CConxParabola &P, ConxHoistedLine &p)
+{
+  p.s = 0.0;
+  return (P.getLine().getPole(p.n) && !P.getFocus().isAtInfinity()
+          && P.getFocus().getHyperboloid(p.a));
+}
+
+// The defining functions at the point h of the hyperboloid, which is
+// not at infinity, as CConxPoint::distanceFrom() computes them
+inline double conxHoistedFunction(const CConxLine &, const ConxHoistedLine &p,
+                                  const double *h)
+{
+  return conxh_distline(p.n, h);
+}
+
+inline double conxHoistedFunction(const CConxEqDistCurve &,
+                                  const ConxHoistedLine &p, const double *h)
+{
+  return conxh_distline(p.n, h) - p.s;
+}
+
+inline double conxHoistedFunction(const CConxParabola &,
+                                  const ConxHoistedLine &p, const double *h)
+{
+  return conxh_dist(p.a, h) - conxh_distline(p.n, h);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// The defining function of a line, an equidistant curve, or a parabola A
+// in the model M, with conxHoist()'s parameters found when the metric is
+// made and the model known at compile time.  A point then
+// costs conxhm_toh() and the distance formulas, with no CConxPoint to set
+// and no validity bits to test, and gets exactly what definingFunction()
+// gives.  Points at infinity, and artists whose line misses the disk or
+// whose focus is at infinity, go through definingFunction().
+template <class A, ConxModlType M>
+class CConxHoistedMetric {
+public:
+  CConxHoistedMetric(const A &a, ConxPrecision p, double t)
+    : artist(a) { hoisted = conxHoist(a, params); }
+  void operator()(const double *x, const double *y, double *f, size_t n)
+  {
+    double h[3], yi;
+    for (size_t i = 0; i < n; i++) {
+      yi = y[i];
+      if (M == CONX_POINCARE_UHP && yi < 0.0) yi = 0.0; // as setPoint()
+      // CConxPoint::isAtInfinity(x[i], yi, M, EQUALITY_TOL)
+      if (hoisted
+          && ((M == CONX_POINCARE_UHP)
+              ? !(yi <= EQUALITY_TOL)
+              : !(sqr(x[i]) + sqr(yi) >= sqr(1.0 - EQUALITY_TOL)))
+          && conxhm_toh(M, x[i], yi, h)) {
+        f[i] = conxHoistedFunction(artist, params, h);
+      } else {
+        X.setPoint(x[i], y[i], M);
+        f[i] = artist.A::definingFunction(X);
+      }
+    }
+  }
+
+private:
+  const A &artist;
+  ConxHoistedLine params;
+  Boole hoisted;
+  CConxPoint X;
+}; // class CConxHoistedMetric
+
+//////////////////////////////////////////////////////////////////////////////
+// A copy of the metric m for each of n threads, and a ConxBatchMetric that
+// calls the copy it is given, for the C functions that run threads.  The
+// copies are made here, on the calling thread, because CConxObject's
+// constructors are not thread-safe.
+template <class M>
+class CConxThreadMetrics {
+public:
+  CConxThreadMetrics(const M &m, size_t n) : nthreads(n)
+  {
+    metrics = new M *[n];
+    args = new void *[n];
+    if (metrics == NULL || args == NULL) OOM();
+    for (size_t i = 0; i < n; i++) {
+      metrics[i] = new M(m);
+      if (metrics[i] == NULL) OOM();
+      args[i] = metrics[i];
+    }
+  }
+  ~CConxThreadMetrics()
+  {
+    for (size_t i = 0; i < nthreads; i++) delete metrics[i];
+    delete [] metrics;
+    delete [] args;
+  }
+  static void call(const double *x, const double *y, double *f, size_t n,
+                   void *m)
+  {
+    (*(M *) m)(x, y, f, n);
+  }
+  void **getArgs() const { return args; }
+
+private:
+  CConxThreadMetrics(const CConxThreadMetrics &);
+  CConxThreadMetrics &operator=(const CConxThreadMetrics &);
+
+private:
+  M **metrics;
+  void **args;
+  size_t nthreads;
+}; // class CConxThreadMetrics
+
+// Calls k.run(m), where m is sa's metric in the modl model as one of the
+// classes above, instantiated for sa's class.  Returns FALSE, having done
+// nothing, if sa's class is not one we know.  Give the LONGWAY tolerance
+// as tol if k only compares the metric with it.
+template <class Kernel>
+Boole conxWithArtistMetric(const CConxSimpleArtist &sa, ConxModlType modl,
+                           ConxPrecision prec, Kernel &k, double tol = 0.0)
+{
+#define CONX_RUN_KERNEL(Metric, Me) \
+  { Metric< Me > m((const Me &) sa, modl, prec, tol); k.run(m); return TRUE; }
+#define CONX_RUN_HOISTED_IN(Me, M) \
+  { CConxHoistedMetric< Me, M > m((const Me &) sa, prec, tol); \
+    k.run(m); return TRUE; }
+#define CONX_RUN_HOISTED(Me) \
+  switch (modl) { \
+  case CONX_KLEIN_DISK: CONX_RUN_HOISTED_IN(Me, CONX_KLEIN_DISK); \
+  case CONX_POINCARE_DISK: CONX_RUN_HOISTED_IN(Me, CONX_POINCARE_DISK); \
+  default: CONX_RUN_HOISTED_IN(Me, CONX_POINCARE_UHP); \
+  }
+  switch (sa.getSAType()) {
+  case CConxSimpleArtist::SA_POINT:
+    CONX_RUN_KERNEL(CConxArtistMetric, CConxPoint);
+  case CConxSimpleArtist::SA_CIRCLE:
+    CONX_RUN_KERNEL(CConxArtistMetric, CConxCircle);
+  case CConxSimpleArtist::SA_HYPELLIPSE:
+    CONX_RUN_KERNEL(CConxArtistMetric, CConxHypEllipse);
+  case CConxSimpleArtist::SA_LINE:
+    CONX_RUN_HOISTED(CConxLine);
+  case CConxSimpleArtist::SA_EQDISTCURVE:
+    CONX_RUN_HOISTED(CConxEqDistCurve);
+  case CConxSimpleArtist::SA_PARABOLA:
+    CONX_RUN_HOISTED(CConxParabola);
+  default:
+    return FALSE;
+  }
+#undef CONX_RUN_HOISTED
+#undef CONX_RUN_HOISTED_IN
+#undef CONX_RUN_KERNEL
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// A metric M with a memo in front of it, as conx_bresenham gives its
+// tracer: M is called once for all the points of a call that are not
+// already in the memo.
+template <class M>
+class CConxBresMemoMetric {
+public:
+  CConxBresMemoMetric(M &f, BresMemo *m) : func(f), memo(m) { }
+  void operator()(const double *x, const double *y, double *f, size_t n)
+  {
+    double mx[NUM_DIRECS], my[NUM_DIRECS], mf[NUM_DIRECS];
+    long mi[NUM_DIRECS], mj[NUM_DIRECS];
+    size_t which[NUM_DIRECS], k, c, misses;
+
+    for (c = 0; c < n; c += NUM_DIRECS) {
+      misses = 0;
+      for (k = c; k < n && k < c + NUM_DIRECS; k++) {
+        if (!conx_bres_memo_lookup(memo, x[k], y[k], &f[k],
+                                   &mi[misses], &mj[misses])) {
+          mx[misses] = x[k];
+          my[misses] = y[k];
+          which[misses++] = k;
+        }
+      }
+      if (misses == 0) continue;
+      func(mx, my, mf, misses);
+      for (k = 0; k < misses; k++) {
+        f[which[k]] = mf[k];
+        conx_bres_memo_store(memo, mi[k], mj[k], mf[k]);
+      }
+    }
+  }
+  BresMemo *getMemo() const { return memo; }
+
+private:
+  M &func;
+  BresMemo *memo;
+}; // class CConxBresMemoMetric
+
+// Sets f[i] to the absolute value of func at the point adjacent to at in
+// the dirs[i] direction, 0 <= i < n <= NUM_DIRECS, as funcs_in_directions
+// does.
+template <class M>
+inline void conxBresDirections(Pt at, const ConxDirection *dirs, size_t n,
+                               double dw, double dh, M &func, double *f)
+{
+  double x[NUM_DIRECS], y[NUM_DIRECS];
+  Pt adjacent;
+  size_t i;
+
+  assert(n <= NUM_DIRECS);
+  for (i = 0; i < n; i++) {
+    adjacent = at;
+    MOVE_POINT(&adjacent, dirs[i], dw, dh);
+    x[i] = adjacent.x;
+    y[i] = adjacent.y;
+  }
+  func(x, y, f, n);
+  for (i = 0; i < n; i++)
+    f[i] = myabs(f[i]);
+}
+
+// Returns the direction in which to leave LB, as conx_startpoint does.
+template <class M>
+ConxDirection conxBresStart(Pt LB, double dw, double dh, M &func)
+{
+  double f[NUM_DIRECS];
+  ConxDirection dir, bestdir, dirs[NUM_DIRECS];
+
+  for (dir = (ConxDirection) 0; dir < (ConxDirection) NUM_DIRECS;
+       dir = (ConxDirection)(1 + (int) dir))
+    dirs[dir] = dir;
+  conxBresDirections(LB, dirs, NUM_DIRECS, dw, dh, func, f);
+  bestdir = (ConxDirection) 0;
+  for (dir = (ConxDirection) 1; dir < (ConxDirection) NUM_DIRECS;
+       dir = (ConxDirection)(1 + (int) dir)) {
+    if (f[dir] < f[bestdir]) bestdir = dir;
+  }
+  return bestdir;
+}
+
+// Does what conx_bres_trace_sink does.  If memo is not NULL, func must
+// be its CConxBresMemoMetric, and we stop where the curve closes up.
+template <class M, class K, class S>
+void conxBresTrace(Pt middle, ConxDirection last, double dw, double dh,
+                   M &func, K &keepgoing, S &sink, BresMemo *memo)
+{
+  double next[NUM_DIRECS], f[3];
+  Pt oldmiddle = middle;
+  int count = 0, i, left = 0;
+  ConxDirection directions[3];
+
+  if (memo != NULL) {
+    ++memo->direction;
+    conx_bres_memo_emit(memo, middle);
+  }
+  sink(middle.x, middle.y);
+  do {
+    FILL_DIRECTIONS3(last, directions);
+    conxBresDirections(middle, directions, 3, dw, dh, func, f);
+    for (i = 0; i < 3; i++)
+      next[directions[i]] = f[i];
+    ALT_GET_MINDIR3(&last, next, directions);
+    MOVE_POINT(&middle, last, dw, dh);
+    if (memo != NULL) {
+      if (conx_bres_memo_closes(memo, middle, &left)) break;
+      conx_bres_memo_emit(memo, middle);
+    }
+    sink(middle.x, middle.y);
+  } while (keepgoing(middle, oldmiddle) && (++count <= CONX_BRES_MAX_MOVES));
+  sink.flush();
+}
+
+// Traces the branch through memo->origin both ways, as conx_bresenham
+// does.
+template <class M, class K, class S>
+void conxBresBranch(BresMemo *memo, M &func, K &keepgoing, S &sink)
+{
+  CConxBresMemoMetric< M > m(func, memo);
+  Pt middle = memo->origin;
+  double dw = memo->dw, dh = memo->dh;
+  ConxDirection last = conxBresStart(middle, dw, dh, m);
+
+  MOVE_POINT(&middle, last, dw, dh);
+  conxBresTrace(middle, last, dw, dh, m, keepgoing, sink, memo);
+  last = conx_compass_opposite(last);
+  MOVE_POINT(&middle, last, dw, dh);
+  conxBresTrace(middle, last, dw, dh, m, keepgoing, sink, memo);
+}
+
+// Draws into sink what conx_bresenham_batch(LB, RB, ...) would draw with
+// conx_bres_trace_sink as its tracer.  If stats is not NULL, sets *stats
+// as conx_bresenham_batch does.
+template <class M, class K, class S>
+void conxBresenham(Pt LB, Pt RB, double dw, double dh, M &func,
+                   K &keepgoing, S &sink, ConxBresStats *stats)
+{
+  ConxBresStats ignored;
+  BresMemo left, right;
+
+  assert(dw != 0.0); assert(dh != 0.0);
+  if (stats == NULL) stats = &ignored;
+  stats->hits = stats->emitted = stats->unique = 0;
+  conx_bres_memo_init(&left, NULL, NULL, LB, dw, dh);
+  conxBresBranch(&left, func, keepgoing, sink);
+  conx_bres_memo_stats(&left, stats);
+  if (((RB.x != LB.x) || (RB.y != LB.y))
+      && !conx_bres_memo_drawn(&left, RB)) {
+    conx_bres_memo_init(&right, NULL, NULL, RB, dw, dh);
+    conxBresBranch(&right, func, keepgoing, sink);
+    conx_bres_memo_stats(&right, stats);
+    conx_bres_memo_free(&right);
+  }
+  conx_bres_memo_free(&left);
+}
+
+// Draws into sink, and flushes it, each point of L at which func comes
+// within tlrance of zero, as conx_lattice_longway_sink does with one
+// thread, but a column at a time rather than all of L at once.
+template <class M, class S>
+void conxLatticeLongway(M &func, double tlrance, const ConxLattice &L,
+                        S &sink)
+{
+#define CONX_LONGWAY_BATCH 128
+  double xs[CONX_LONGWAY_BATCH], f[CONX_LONGWAY_BATCH];
+  const double *x, *y;
+  size_t i, j, k, n, t;
+
+  for (i = 0; i < L.ncols; i++) {
+    for (j = 0; j < CONX_LONGWAY_BATCH; j++) xs[j] = L.xs[i];
+    for (j = 0; j < L.count[i]; j += n) {
+      n = L.count[i] - j;
+      if (n > CONX_LONGWAY_BATCH) n = CONX_LONGWAY_BATCH;
+      k = L.start[i] + j;
+      x = (L.kx != NULL) ? L.kx + k : xs;
+      y = (L.ky != NULL) ? L.ky + k : L.ys + k;
+      func(x, y, f, n);
+      for (t = 0; t < n; t++) {
+        if (myabs(f[t]) < tlrance) sink(L.xs[i], L.ys[k + t]);
+      }
+    }
+  }
+  sink.flush();
+#undef CONX_LONGWAY_BATCH
+}
+
+#endif // GPLCONX_KERNELS_CXX_H
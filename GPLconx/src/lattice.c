@@ -0,0 +1,451 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  The lattice of points that the LONGWAY method visits.  In the disks,
+  the lattice covers only the part of the viz area inside the unit disk,
+  so zooming in makes for less work.  The whole lattice can be stored so
+  that the drawing engines that do not visit each point in turn can still
+  visit exactly the same points.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#include "viewer.h"
+#include "util.h"
+
+/* lattice_sweep hands out this many adjacent columns at a time. */
+#define LATTICE_TILE_COLUMNS 8
+
+/* The field is evaluated at up to this many points of a column at once. */
+#define LATTICE_BATCH 128
+
+static size_t lattice_range(double lo, double hi, double origin,
+                            double delta, size_t *k0)
+/* Returns the number of k >= 0 such that lo <= origin + k*delta <= hi,
+   and sets *k0 to the least such k.  origin must not exceed lo. */
+{
+  double a, b;
+
+  *k0 = 0;
+  if (!(delta > 0.0) || !(lo <= hi) || hi < origin) return 0;
+  a = ceil((lo - origin) / delta);
+  b = floor((hi - origin) / delta);
+  /* Rounding could put the ends a step outside of [lo, hi]. */
+  while (a <= b && CONX_LATTICE_COORD(origin, delta, a) < lo) a += 1.0;
+  while (a <= b && CONX_LATTICE_COORD(origin, delta, b) > hi) b -= 1.0;
+  if (b < a) return 0;
+  *k0 = (size_t) a;
+  return (size_t) (b - a) + 1;
+}
+
+size_t conx_lattice_columns(ConxModlType modl, double delta_x,
+                            double x_min, double x_max, size_t *i0)
+/* The LONGWAY method scans the columns with abscissae
+   CONX_LATTICE_COORD(x_min, delta_x, i) for *i0 <= i < *i0 + n, where n is
+   the return value.  In the disks, only the columns that meet the unit
+   disk are scanned, so a zoomed-in view scans fewer columns. */
+{
+  if (modl != CONX_POINCARE_UHP)
+    return lattice_range((x_min > -1.0) ? x_min : -1.0,
+                         (x_max < 1.0) ? x_max : 1.0, x_min, delta_x, i0);
+  return lattice_range(x_min, x_max, x_min, delta_x, i0);
+}
+
+size_t conx_lattice_column(ConxModlType modl, double x, double delta_y,
+                           double y_min, double y_max, size_t *j0)
+/* The LONGWAY method scans the points of the column with abscissa x that
+   have ordinates CONX_LATTICE_COORD(y_min, delta_y, j) for
+   *j0 <= j < *j0 + n, where n is the return value.  In the disks, these
+   are the points of the viz area that are in the closed unit disk. */
+{
+  double h;
+
+  if (modl != CONX_POINCARE_UHP) {
+    h = 1.0 - sqr(x);
+    if (h < 0.0) {
+      *j0 = 0;
+      return 0;
+    }
+    h = sqrt(h);
+    return lattice_range((y_min > -h) ? y_min : -h, (y_max < h) ? y_max : h,
+                         y_min, delta_y, j0);
+  }
+  return lattice_range(y_min, y_max, y_min, delta_y, j0);
+}
+
+void conx_lattice_build(ConxLattice *L, ConxModlType modl,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max)
+/* Fills in *L with the points that conx_longway_batch would visit given
+   the same arguments.  You must call conx_lattice_free(L) later.
+*/
+{
+  size_t i, i0, j, j0, m, n = 0, ysz = 0;
+  double x;
+
+  L->xs = L->ys = L->kx = L->ky = NULL;
+  L->start = L->count = NULL;
+  L->maxcount = 0;
+  L->ncols = conx_lattice_columns(modl, delta_x, x_min, x_max, &i0);
+  if (L->ncols == 0) return;
+  L->xs = (double *) malloc(L->ncols * sizeof(double));
+  L->start = (size_t *) malloc(L->ncols * sizeof(size_t));
+  L->count = (size_t *) malloc(L->ncols * sizeof(size_t));
+  CHECK_OOM(L->xs, "conx_lattice_build");
+  CHECK_OOM(L->start, "conx_lattice_build");
+  CHECK_OOM(L->count, "conx_lattice_build");
+  for (i = 0; i < L->ncols; i++) {
+    x = L->xs[i] = CONX_LATTICE_COORD(x_min, delta_x, i0 + i);
+    m = conx_lattice_column(modl, x, delta_y, y_min, y_max, &j0);
+    if (n + m > ysz) {
+      ysz = (2 * ysz > n + m) ? 2 * ysz : n + m + 1024;
+      L->ys = (double *) realloc(L->ys, ysz * sizeof(double));
+      CHECK_OOM(L->ys, "conx_lattice_build");
+    }
+    L->start[i] = n;
+    L->count[i] = m;
+    for (j = 0; j < m; j++)
+      L->ys[n++] = CONX_LATTICE_COORD(y_min, delta_y, j0 + j);
+    if (m > L->maxcount) L->maxcount = m;
+  }
+}
+
+void conx_lattice_free(ConxLattice *L)
+{
+  if (L->xs != NULL) free(L->xs);
+  if (L->ys != NULL) free(L->ys);
+  if (L->start != NULL) free(L->start);
+  if (L->count != NULL) free(L->count);
+  if (L->kx != NULL) free(L->kx);
+  if (L->ky != NULL) free(L->ky);
+  L->xs = L->ys = L->kx = L->ky = NULL;
+  L->start = L->count = NULL;
+  L->ncols = L->maxcount = 0;
+}
+
+size_t conx_lattice_size(const ConxLattice *L)
+/* Returns the number of points in the lattice. */
+{
+  if (L->ncols == 0) return 0;
+  return L->start[L->ncols-1] + L->count[L->ncols-1];
+}
+
+void conx_lattice_klein(ConxLattice *L, ConxModlType modl)
+/* Computes the Klein disk coordinates of each point of L, a lattice in the
+   modl model.  After this, L->kx and L->ky are not NULL.  In the UHP, a
+   point with negative ordinate is treated as CConxPoint::setPoint treats
+   it, i.e. as a point on the boundary. */
+{
+  size_t i, k, n = conx_lattice_size(L);
+
+  if (L->kx != NULL) free(L->kx);
+  if (L->ky != NULL) free(L->ky);
+  L->kx = (double *) malloc((n + 1) * sizeof(double));
+  L->ky = (double *) malloc((n + 1) * sizeof(double));
+  CHECK_OOM(L->kx, "conx_lattice_klein");
+  CHECK_OOM(L->ky, "conx_lattice_klein");
+  for (i = 0; i < L->ncols; i++) {
+    for (k = L->start[i]; k < L->start[i] + L->count[i]; k++) {
+      L->kx[k] = L->xs[i];
+      L->ky[k] = L->ys[k];
+      if (modl == CONX_POINCARE_UHP && L->ky[k] < 0.0) L->ky[k] = 0.0;
+    }
+  }
+  if (modl == CONX_POINCARE_UHP)
+    conxhm_ptok_batch(L->kx, L->ky, L->kx, L->ky, n);
+  else if (modl == CONX_POINCARE_DISK)
+    conxhm_pdtok_batch(L->kx, L->ky, L->kx, L->ky, n);
+}
+
+static void lattice_sample_column(ConxBatchMetric *field,
+                                  ConxBatchMetricF *fieldf, void *fieldArg,
+                                  const ConxLattice *L, size_t i, double *g,
+                                  float *gf)
+/* Samples column i into g with *field or, if g is NULL, into gf with
+   *fieldf. */
+{
+  double xs[LATTICE_BATCH];
+  size_t j, n, k = L->start[i];
+
+  if (L->kx != NULL) {
+    if (g != NULL)
+      (*field)(L->kx + k, L->ky + k, g + k, L->count[i], fieldArg);
+    else
+      (*fieldf)(L->kx + k, L->ky + k, gf + k, L->count[i], fieldArg);
+    return;
+  }
+  for (j = 0; j < LATTICE_BATCH; j++) xs[j] = L->xs[i];
+  for (j = 0; j < L->count[i]; j += n) {
+    n = L->count[i] - j;
+    if (n > LATTICE_BATCH) n = LATTICE_BATCH;
+    if (g != NULL)
+      (*field)(xs, L->ys + k + j, g + k + j, n, fieldArg);
+    else
+      (*fieldf)(xs, L->ys + k + j, gf + k + j, n, fieldArg);
+  }
+}
+
+/* Does something to column i of a lattice.  job is shared by all threads;
+   arg is the calling thread's own. */
+typedef void (LatticeColumnFunc)(void *job, void *arg, size_t i);
+
+#ifdef HAVE_PTHREAD_H
+typedef struct LatticeSweep {
+  LatticeColumnFunc *column;
+  void *job;
+  size_t ncols;
+  size_t next;               /* the next column nobody has claimed */
+  pthread_mutex_t lock;      /* guards next */
+} LatticeSweep;
+
+typedef struct LatticeWorker {
+  LatticeSweep *s;
+  void *arg;
+} LatticeWorker;
+
+static void *lattice_worker(void *ww)
+{
+  LatticeWorker *w = (LatticeWorker *) ww;
+  LatticeSweep *s = w->s;
+  size_t i, first, last;
+
+  for (;;) {
+    pthread_mutex_lock(&s->lock);
+    first = s->next;
+    s->next += LATTICE_TILE_COLUMNS;
+    pthread_mutex_unlock(&s->lock);
+    if (first >= s->ncols) break;
+    last = first + LATTICE_TILE_COLUMNS;
+    if (last > s->ncols) last = s->ncols;
+    for (i = first; i < last; i++)
+      (*s->column)(s->job, w->arg, i);
+  }
+  return NULL;
+}
+#endif /* HAVE_PTHREAD_H */
+
+static void lattice_sweep(LatticeColumnFunc *column, void *job, void **args,
+                          size_t nthreads, size_t ncols)
+/* Calls (*column)(job, args[k], i) for each column i < ncols, in order if
+   nthreads is 1.  Otherwise thread k takes groups of adjacent columns as
+   it finishes the last group. */
+{
+  size_t i;
+#ifdef HAVE_PTHREAD_H
+  LatticeSweep s;
+  LatticeWorker *w;
+  pthread_t *tids;
+  int *started;
+  size_t k;
+
+  if (nthreads > 1 && ncols > LATTICE_TILE_COLUMNS) {
+    s.column = column;
+    s.job = job;
+    s.ncols = ncols;
+    s.next = 0;
+    pthread_mutex_init(&s.lock, NULL);
+    w = (LatticeWorker *) malloc(nthreads * sizeof(LatticeWorker));
+    tids = (pthread_t *) malloc(nthreads * sizeof(pthread_t));
+    started = (int *) malloc(nthreads * sizeof(int));
+    CHECK_OOM(w, "lattice_sweep");
+    CHECK_OOM(tids, "lattice_sweep");
+    CHECK_OOM(started, "lattice_sweep");
+    /* This thread is worker 0. */
+    for (k = 0; k < nthreads; k++) {
+      w[k].s = &s;
+      w[k].arg = args[k];
+      started[k] = (k > 0
+                    && pthread_create(&tids[k], NULL, lattice_worker,
+                                      &w[k]) == 0);
+    }
+    (void) lattice_worker(&w[0]);
+    for (k = 1; k < nthreads; k++)
+      if (started[k]) pthread_join(tids[k], NULL);
+    pthread_mutex_destroy(&s.lock);
+    free(started);
+    free(tids);
+    free(w);
+    return;
+  }
+#endif
+  for (i = 0; i < ncols; i++)
+    (*column)(job, args[0], i);
+}
+
+typedef struct LatticeSampler {
+  ConxBatchMetric *field;
+  ConxBatchMetricF *fieldf;
+  const ConxLattice *L;
+  double *g;
+  float *gf;
+} LatticeSampler;
+
+static void lattice_sampler_column(void *job, void *fieldArg, size_t i)
+{
+  LatticeSampler *s = (LatticeSampler *) job;
+  lattice_sample_column(s->field, s->fieldf, fieldArg, s->L, i, s->g, s->gf);
+}
+
+void conx_lattice_sample(ConxBatchMetric *field, void **fieldArgs,
+                         size_t nthreads, const ConxLattice *L, double *g)
+/* Sets g[k] to *field at the lattice point with ordinate L->ys[k], using up
+   to nthreads threads.  Thread k calls *field with fieldArgs[k], so *field
+   must not share any writable state between two different fieldArgs.  If
+   L has Klein coordinates, *field is given those rather than the model
+   coordinates. */
+{
+  LatticeSampler s;
+
+  s.field = field;
+  s.fieldf = NULL;
+  s.L = L;
+  s.g = g;
+  s.gf = NULL;
+  lattice_sweep(lattice_sampler_column, &s, fieldArgs, nthreads, L->ncols);
+}
+
+void conx_lattice_samplef(ConxBatchMetricF *field, void **fieldArgs,
+                          size_t nthreads, const ConxLattice *L, float *g)
+/* Like conx_lattice_sample, but for a field that is only wanted in single
+   precision.  No double-precision raster is ever built. */
+{
+  LatticeSampler s;
+
+  s.field = NULL;
+  s.fieldf = field;
+  s.L = L;
+  s.g = NULL;
+  s.gf = g;
+  lattice_sweep(lattice_sampler_column, &s, fieldArgs, nthreads, L->ncols);
+}
+
+typedef struct LatticeFusion {
+  ConxBatchMetric *test;
+  size_t ntests;
+  const double *tlrances;
+  const ConxLattice *L;
+  char **hits;
+} LatticeFusion;
+
+static void lattice_fusion_column(void *job, void *arg, size_t i)
+/* arg is the calling thread's ntests testArgs. */
+{
+  LatticeFusion *u = (LatticeFusion *) job;
+  void **testArgs = (void **) arg;
+  const ConxLattice *L = u->L;
+  double xs[LATTICE_BATCH], f[LATTICE_BATCH];
+  const double *x, *y;
+  size_t a, j, t, n, k;
+
+  for (j = 0; j < LATTICE_BATCH; j++) xs[j] = L->xs[i];
+  for (j = 0; j < L->count[i]; j += n) {
+    n = L->count[i] - j;
+    if (n > LATTICE_BATCH) n = LATTICE_BATCH;
+    k = L->start[i] + j;
+    x = (L->kx != NULL) ? L->kx + k : xs;
+    y = (L->ky != NULL) ? L->ky + k : L->ys + k;
+    /* Every test sees this batch while it is still in the cache. */
+    for (a = 0; a < u->ntests; a++) {
+      (*u->test)(x, y, f, n, testArgs[a]);
+      for (t = 0; t < n; t++)
+        u->hits[a][k + t] = (myabs(f[t]) < u->tlrances[a]);
+    }
+  }
+}
+
+void conx_lattice_longway_fused(ConxBatchMetric *test, void **testArgs,
+                                size_t ntests, size_t nthreads,
+                                const double *tlrances, const ConxLattice *L,
+                                char **hits)
+/* Does for ntests tests at once what conx_lattice_longway does for one,
+   in a single pass over L.  Test a is *test with the argument
+   testArgs[t*ntests + a] in thread t, and its tolerance is tlrances[a].
+   Rather than calling a ConxPointFunc, this sets hits[a][k] to 1 if test
+   a comes within tolerance of zero at the point with ordinate L->ys[k]
+   and to 0 otherwise, so that the caller can draw each test's points in
+   whatever order it likes. */
+{
+  LatticeFusion u;
+  void **args;
+  size_t t;
+
+  if (ntests == 0) return;
+  u.test = test;
+  u.ntests = ntests;
+  u.tlrances = tlrances;
+  u.L = L;
+  u.hits = hits;
+  args = (void **) malloc(nthreads * sizeof(void *));
+  CHECK_OOM(args, "conx_lattice_longway_fused");
+  for (t = 0; t < nthreads; t++)
+    args[t] = testArgs + t * ntests;
+  lattice_sweep(lattice_fusion_column, &u, args, nthreads, L->ncols);
+  free(args);
+}
+
+void conx_lattice_longway(ConxBatchMetric *test, void **testArgs,
+                          size_t nthreads, double tlrance,
+                          const ConxLattice *L,
+                          ConxPointFunc *pfunc, void *pArg)
+/* Like conx_lattice_longway_sink, but (*pfunc)(x,y,pArg) is called for
+   each point found. */
+{
+  Pt pts[CONX_SINK_SIZE];
+  ConxPointFuncAdapter a;
+  ConxVertexSink sink;
+
+  a.pfunc = pfunc;
+  a.pArg = pArg;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_points_of_batch, &a);
+  conx_lattice_longway_sink(test, testArgs, nthreads, tlrance, L, &sink);
+}
+
+void conx_lattice_longway_sink(ConxBatchMetric *test, void **testArgs,
+                               size_t nthreads, double tlrance,
+                               const ConxLattice *L, ConxVertexSink *sink)
+/* Puts into *sink each point (x, y) of L, in order, at which *test comes
+   within tlrance of zero, and flushes *sink.  *test is evaluated as
+   conx_lattice_sample evaluates *field.  Given the lattice that
+   conx_lattice_build makes, this finds what conx_longway_tiled does. */
+{
+  size_t i, k, n = conx_lattice_size(L);
+  double *f;
+
+  f = (double *) malloc((n + 1) * sizeof(double));
+  CHECK_OOM(f, "conx_lattice_longway");
+  conx_lattice_sample(test, testArgs, nthreads, L, f);
+  for (i = 0; i < L->ncols; i++) {
+    for (k = L->start[i]; k < L->start[i] + L->count[i]; k++) {
+      if (myabs(f[k]) < tlrance)
+        CONX_SINK_VERTEX(sink, L->xs[i], L->ys[k]);
+    }
+  }
+  conx_sink_flush(sink);
+  free(f);
+}
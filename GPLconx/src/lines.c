@@ -314,9 +314,25 @@ resembling a stop sign instead of a circle.
 @end conxdox
 */
 {
-  double t;
-
   /* DLC use gluCircle wherever possible as an option. */
+  Pt pts[CONX_SINK_SIZE];
+  ConxPointFuncAdapter a;
+  ConxVertexSink sink;
+
+  a.pfunc = pfunc;
+  a.pArg = pArg;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_points_of_batch, &a);
+  conx_draw_arc_sink(x, y, r, theta_1, theta_2, tstp, converter, &sink);
+}
+
+void conx_draw_arc_sink(double x, double y, double r, double theta_1,
+                        double theta_2, double tstp,
+                        ConxPoint2DConverterFunc *converter,
+                        ConxVertexSink *sink)
+/* Like conx_draw_arc, but the points go into *sink, which we flush before
+   returning. */
+{
+  double t;
 
   /* Two for loops are necessary to avoid numerous tests of the `if'
      statement.
@@ -325,12 +341,13 @@ resembling a stop sign instead of a circle.
     for (t=theta_1; t<=theta_2; t+=tstp) {
       double px, py;
       (*converter)(x+r*cos(t), y+r*sin(t), &px, &py);
-      (*pfunc)(px, py, pArg);
+      CONX_SINK_VERTEX(sink, px, py);
     }
   } else {
     for (t=theta_1; t<=theta_2; t+=tstp) {
-      (*pfunc)(x+r*cos(t), y+r*sin(t), pArg);
+      CONX_SINK_VERTEX(sink, x+r*cos(t), y+r*sin(t));
     }
   }
+  conx_sink_flush(sink);
 }
 
@@ -22,40 +22,230 @@
 #endif
 
 #include <math.h>
+#include <stdlib.h>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
 
 #include "viewer.h"
 #include "point.h"
+#include "util.h"
+
+/* The tiled scan hands out this many adjacent columns at a time. */
+#define LONGWAY_TILE_COLUMNS 8
+
+/* The metric is evaluated at up to this many points of a column at once. */
+#define LONGWAY_BATCH 128
+
+static void longway_column(ConxBatchMetric *test, void *testArg,
+                           ConxModlType modl, double tlrance, double x,
+                           double delta_y, double y_min, double y_max,
+                           ConxVertexSink *sink)
+/* Scans the column of the viz area with abscissa x.  Both
+   conx_longway_sink and conx_longway_tiled use this, so they visit
+   exactly the same points. */
+{
+  double xs[LONGWAY_BATCH], ys[LONGWAY_BATCH], f[LONGWAY_BATCH];
+  size_t i, j, j0, m, n;
+
+  m = conx_lattice_column(modl, x, delta_y, y_min, y_max, &j0);
+  for (i = 0; i < LONGWAY_BATCH; i++) xs[i] = x;
+  for (j = 0; j < m; j += n) {
+    n = m - j;
+    if (n > LONGWAY_BATCH) n = LONGWAY_BATCH;
+    for (i = 0; i < n; i++)
+      ys[i] = CONX_LATTICE_COORD(y_min, delta_y, j0 + j + i);
+    (*test)(xs, ys, f, n, testArg);
+    for (i = 0; i < n; i++) {
+      if (myabs(f[i]) < tlrance)
+        CONX_SINK_VERTEX(sink, x, ys[i]);
+    }
+  }
+}
+
+void conx_longway_sink(ConxBatchMetric *test, void *testArg,
+                       ConxModlType modl, double tlrance,
+                       double delta_x, double delta_y,
+                       double x_min, double x_max,
+                       double y_min, double y_max,
+                       ConxVertexSink *sink)
+/* This allows you to find those points in the viz area that come within
+   tlrance of being zeroes of the function *test.  When one is found, it
+   goes into *sink, which we flush before returning.  *test is given a
+   column of the viz area, or a good part of one, at a time.  In the disks,
+   only the points of the viz area that are in the unit disk are visited;
+   see lattice.c.
+*/
+{
+  size_t i, i0, n;
+
+  n = conx_lattice_columns(modl, delta_x, x_min, x_max, &i0);
+  for (i = 0; i < n; i++)
+    longway_column(test, testArg, modl, tlrance,
+                   CONX_LATTICE_COORD(x_min, delta_x, i0 + i),
+                   delta_y, y_min, y_max, sink);
+  conx_sink_flush(sink);
+}
+
+void conx_longway_batch(ConxBatchMetric *test, void *testArg,
+                        ConxModlType modl, double tlrance,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max,
+                        ConxPointFunc *pfunc, void *pArg)
+/* Like conx_longway_sink, but (*pfunc)(x,y,pArg) is called for each point
+   found. */
+{
+  Pt pts[CONX_SINK_SIZE];
+  ConxPointFuncAdapter a;
+  ConxVertexSink sink;
+
+  a.pfunc = pfunc;
+  a.pArg = pArg;
+  conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_points_of_batch, &a);
+  conx_longway_sink(test, testArg, modl, tlrance, delta_x, delta_y,
+                    x_min, x_max, y_min, y_max, &sink);
+}
 
 void conx_longway(ConxMetric *test, void *testArg, ConxModlType modl,
                   double tlrance, double delta_x, double delta_y,
                   double x_min, double x_max, double y_min, double y_max,
                   ConxPointFunc *pfunc, void *pArg)
-/* This allows you to find those points in the viz area that come within
-   tlrance of being zeroes of the function *test.  When one is found,
-   (*pfunc)(x,y,pArg) is called.
-*/
+/* Like conx_longway_batch, but *test is given one point at a time. */
 {
-  Pt X;
-
-  if (modl==CONX_POINCARE_UHP) {
-    for (X.x = x_min; X.x <= x_max; X.x += delta_x) {
-      for (X.y = y_min; X.y <= y_max; X.y += delta_y) {
-        if (myabs((*test)(X, testArg)) < tlrance)
-          (*pfunc)(X.x, X.y, pArg);
-      }
-    }
-  } else {
-    /* test against xmin and xmax, right, or at most the unit circle,
-       for a speedup and reduce of redundancy? DLC */
-    for (X.x = -1.0; X.x <= 1.0; X.x += delta_x) {
-      for (X.y = -1.0*sqrt(1.0-sqr(X.x));
-           /* X.y <= sqrt(1.0-sqr(X.x)) is the same as but slower than: */
-           ((X.y <= 0) || (sqr(X.y) <= 1.0-sqr(X.x)));
-           X.y += delta_y) {
-	if (myabs((*test)(X, testArg)) < tlrance)
-	  (*pfunc)(X.x, X.y, pArg);
-      }
-    }
+  ConxMetricAdapter a;
+
+  a.func = test;
+  a.fArg = testArg;
+  conx_longway_batch(conx_batch_of_metric, &a, modl, tlrance,
+                     delta_x, delta_y, x_min, x_max, y_min, y_max,
+                     pfunc, pArg);
+}
+
+#ifdef HAVE_PTHREAD_H
+typedef struct LongwayTiles {
+  ConxBatchMetric *test;
+  ConxModlType modl;
+  double tlrance, delta_x, delta_y, x_min, y_min, y_max;
+  size_t i0;                 /* the lattice index of the first column */
+  size_t ncols, ntiles;
+  ConxPtBuffer *hits;        /* ntiles buffers, one per tile */
+  size_t next;               /* the next tile nobody has claimed */
+  pthread_mutex_t lock;      /* guards next */
+} LongwayTiles;
+
+typedef struct LongwayWorker {
+  LongwayTiles *tiles;
+  void *testArg;
+} LongwayWorker;
+
+static void *longway_worker(void *ww)
+/* Claims tiles until there are none left, scanning each tile's columns
+   into that tile's own buffer.  Thus the points found do not depend on
+   which worker scanned which tile. */
+{
+  LongwayWorker *w = (LongwayWorker *) ww;
+  LongwayTiles *t = w->tiles;
+  Pt pts[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+  size_t tile, i, last;
+
+  for (;;) {
+    pthread_mutex_lock(&t->lock);
+    tile = t->next++;
+    pthread_mutex_unlock(&t->lock);
+    if (tile >= t->ntiles) break;
+    last = (tile + 1) * LONGWAY_TILE_COLUMNS;
+    if (last > t->ncols) last = t->ncols;
+    conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_ptbuf_extend,
+                   &t->hits[tile]);
+    for (i = tile * LONGWAY_TILE_COLUMNS; i < last; i++)
+      longway_column(t->test, w->testArg, t->modl, t->tlrance,
+                     CONX_LATTICE_COORD(t->x_min, t->delta_x, t->i0 + i),
+                     t->delta_y, t->y_min, t->y_max, &sink);
+    conx_sink_flush(&sink);
   }
+  return NULL;
 }
+#endif /* HAVE_PTHREAD_H */
 
+void conx_longway_tiled(ConxBatchMetric *test, void **testArgs,
+                        size_t nthreads,
+                        ConxModlType modl, double tlrance,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max,
+                        ConxPointFunc *pfunc, void *pArg)
+/* Like conx_longway_batch, but the columns of the viz area are split into
+   tiles that up to nthreads threads scan concurrently.  Thread k calls
+   *test with testArgs[k], so *test must not share any writable state
+   between two different testArgs.  pfunc is only called from the calling
+   thread, after the scan is complete, and it sees the same points in the
+   same order that conx_longway_batch would give it.
+
+   If nthreads is 1 or if threads are not available, this is the same as
+   conx_longway_batch(test, testArgs[0], ...).
+*/
+{
+#ifdef HAVE_PTHREAD_H
+  LongwayTiles t;
+  LongwayWorker *w;
+  pthread_t *tids;
+  int *started;
+  size_t k;
+
+  if (nthreads <= 1) {
+    conx_longway_batch(test, testArgs[0], modl, tlrance, delta_x, delta_y,
+                       x_min, x_max, y_min, y_max, pfunc, pArg);
+    return;
+  }
+  t.test = test;
+  t.modl = modl;
+  t.tlrance = tlrance;
+  t.delta_x = delta_x;
+  t.delta_y = delta_y;
+  t.x_min = x_min;
+  t.y_min = y_min;
+  t.y_max = y_max;
+  t.ncols = conx_lattice_columns(modl, delta_x, x_min, x_max, &t.i0);
+  t.ntiles = (t.ncols + LONGWAY_TILE_COLUMNS - 1) / LONGWAY_TILE_COLUMNS;
+  t.next = 0;
+  t.hits = (ConxPtBuffer *) malloc((t.ntiles + 1) * sizeof(ConxPtBuffer));
+  CHECK_OOM(t.hits, "conx_longway_tiled");
+  for (k = 0; k < t.ntiles; k++) conx_ptbuf_init(&t.hits[k]);
+  pthread_mutex_init(&t.lock, NULL);
+
+  w = (LongwayWorker *) malloc(nthreads * sizeof(LongwayWorker));
+  tids = (pthread_t *) malloc(nthreads * sizeof(pthread_t));
+  started = (int *) malloc(nthreads * sizeof(int));
+  CHECK_OOM(w, "conx_longway_tiled");
+  CHECK_OOM(tids, "conx_longway_tiled");
+  CHECK_OOM(started, "conx_longway_tiled");
+
+  /* This thread is worker 0.  If we cannot start a thread, the remaining
+     workers simply get more tiles. */
+  for (k = 0; k < nthreads; k++) {
+    w[k].tiles = &t;
+    w[k].testArg = testArgs[k];
+    started[k] = (k > 0
+                  && pthread_create(&tids[k], NULL, longway_worker,
+                                    &w[k]) == 0);
+  }
+  (void) longway_worker(&w[0]);
+  for (k = 1; k < nthreads; k++)
+    if (started[k]) pthread_join(tids[k], NULL);
+
+  pthread_mutex_destroy(&t.lock);
+  for (k = 0; k < t.ntiles; k++) {
+    conx_ptbuf_replay(&t.hits[k], pfunc, pArg);
+    conx_ptbuf_free(&t.hits[k]);
+  }
+  free(started);
+  free(tids);
+  free(w);
+  free(t.hits);
+#else
+  conx_longway_batch(test, testArgs[0], modl, tlrance, delta_x, delta_y,
+                     x_min, x_max, y_min, y_max, pfunc, pArg);
+#endif
+}
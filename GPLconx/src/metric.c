@@ -0,0 +1,48 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Glue between the one-point-at-a-time ConxMetric and the
+  many-points-at-a-time ConxBatchMetric.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+
+#include "viewer.h"
+
+void conx_batch_of_metric(const double *x, const double *y, double *f,
+                          size_t n, void *adapter)
+/* A ConxBatchMetric that calls a ConxMetric once per point.  adapter is a
+   ConxMetricAdapter *. */
+{
+  ConxMetricAdapter *a = (ConxMetricAdapter *) adapter;
+  Pt X;
+  size_t i;
+
+  assert(a != NULL); assert(a->func != NULL);
+  for (i = 0; i < n; i++) {
+    X.x = x[i];
+    X.y = y[i];
+    f[i] = (*a->func)(X, a->fArg);
+  }
+}
@@ -20,6 +20,8 @@
 #ifndef CONXV_POINT_H
 #define CONXV_POINT_H 1
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,6 +36,18 @@ typedef enum ConxModlType {
 } ConxModlType;
 /* poincare Upper Half plane, Beltrami-Klein disk, or poincare disk */
 
+/* How precisely the drawing engines evaluate defining functions.
+   CONX_FAST uses single precision except where cancellation would make
+   it decide the wrong pixels, i.e. near the boundary of the disk (or the
+   UHP's axis) and near the points from which distances are measured.
+   CONX_COMPARE is precise, but where a threshold is all that matters, as
+   in the LONGWAY method's |f| < tolerance, it compares cosh-distances
+   with the cosh of the threshold instead of taking acosh far from the
+   curve. */
+typedef enum ConxPrecision {
+  CONX_PRECISE, CONX_FAST, CONX_COMPARE
+} ConxPrecision;
+
 #define CONX_NUM_MODELS 3
 
 /* Add to this and to conxcln.c's array at the same time. */
@@ -183,14 +197,59 @@ typedef enum ConxColorEnum {
 
 typedef void (ConxBresenhamStarter) (Pt *, Pt *);
 typedef double (ConxMetric) (Pt, void *);
+
+/* A ConxMetric for many points at once: sets f[i] to the metric at
+   (x[i], y[i]) for 0 <= i < n.  The arrays do not overlap. */
+typedef void (ConxBatchMetric) (const double *x, const double *y, double *f,
+                                size_t n, void *);
+
+/* A ConxBatchMetric whose values are only wanted in single precision. */
+typedef void (ConxBatchMetricF) (const double *x, const double *y, float *f,
+                                 size_t n, void *);
+
+/* A ConxBatchMetric that also sets (gx[i], gy[i]) to the metric's gradient
+   at (x[i], y[i]). */
+typedef void (ConxBatchGradient) (const double *x, const double *y,
+                                  double *f, double *gx, double *gy,
+                                  size_t n, void *);
 typedef int (ConxContinueFunc) (Pt, Pt, void *);
 
 /* A function that converts (a, b) to (c, d), e.g. ptopd */
 typedef void (ConxPoint2DConverterFunc) (double, double, double *, double *);
 typedef void (ConxPointFunc) (double, double, void *);
+typedef void (ConxPolylineFunc) (const Pt *pts, size_t n, void *);
+
+/* Where a drawing engine puts the points it finds so that they are drawn
+   many at a time.  The caller supplies pts, which has room for sz points.
+   The engine appends points and, whenever pts is full and once more when
+   it is done, calls (*flush)(pts, n, fArg) and sets n to zero.  See
+   ptbuf.c. */
+typedef struct ConxVertexSink {
+  Pt *pts;
+  size_t n, sz;
+  ConxPolylineFunc *flush;
+  void *fArg;
+} ConxVertexSink;
+/* What conx_bresenham knows of the branch it is tracing, which it gives its
+   tracer to give conx_bres_trace.  See bresint.h. */
+typedef struct BresMemo ConxBresMemo;
 typedef void (ConxBresTraceFunc) (Pt middle, ConxDirection last, double dw, \
                                   double dh, ConxMetric *func, void *fArg, \
+                                  ConxBresMemo *memo, \
                                   ConxContinueFunc *keepgoing, void *kArg);
+typedef void (ConxBatchBresTraceFunc) (Pt middle, ConxDirection last, \
+                                       double dw, double dh, \
+                                       ConxBatchMetric *func, void *fArg, \
+                                       ConxBresMemo *memo, \
+                                       ConxContinueFunc *keepgoing, \
+                                       void *kArg);
+
+/* What conx_bresenham did: how many evaluations of the metric its memo
+   saved, how many points it drew, and how many of those were distinct
+   lattice points. */
+typedef struct ConxBresStats {
+  size_t hits, emitted, unique;
+} ConxBresStats;
 
 #ifdef __cplusplus
 }
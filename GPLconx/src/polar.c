@@ -0,0 +1,488 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Drawing a curve by solving for it along rays.  An ellipse, one branch of
+  a hyperbola, and a parabola are each star-shaped about a focus: each
+  geodesic ray from the focus crosses the curve at most once, and the
+  defining function, written suitably, is negative at the focus and does
+  not decrease along the ray.  So for each direction theta we bracket the
+  root in the distance rho from the focus and then close in on it by false
+  position.  All the rays of a pass are solved together, so that the
+  metric is called with many points at once.
+
+  Directions are added where the curve would stray more than a fraction
+  of a pixel from the chord between neighboring rays' points, judging by
+  how sharply the polyline turns at them, or where neighboring rays are
+  far apart on the screen.  Directions are also added where one ray hits
+  the curve and its neighbor misses it, which is where an open branch
+  goes off to infinity.  A new ray's search starts where its neighbors
+  crossed.  There is no start point to find and no walk from pixel to
+  pixel.  The output is polylines in the order of theta.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "viewer.h"
+#include "util.h"
+
+/* Rays in the first pass */
+#define POLAR_FIRST_RAYS 64
+
+/* We stop adding rays at this many. */
+#define POLAR_MAX_RAYS 65536
+
+/* Split the directions between neighboring rays if the curve strays
+   more than this many pixels from the chord between their points, or if
+   the chord is longer than this many pixels. */
+#define POLAR_SAGITTA 0.1
+#define POLAR_MAX_CHORD 8.0
+
+/* How finely, in radians, we find the directions in which an open branch
+   goes off to infinity */
+#define POLAR_MIN_DTHETA 1e-6
+
+/* The farthest we look along a ray.  Farther than this, a point is
+   within a double's rounding of the boundary in every model. */
+#define POLAR_RHO_MAX 40.0
+
+/* The first step out from the center along a ray with no neighbors to
+   go by, and the least step out from a neighbor's distance */
+#define POLAR_FIRST_STEP 0.25
+#define POLAR_MIN_STEP 1e-9
+
+/* A root is found when we have it within this many pixels. */
+#define POLAR_TOLERANCE 0.001
+
+/* False position iterations per root */
+#define POLAR_MAX_ITERATIONS 60
+
+/* Where a point rounds onto the boundary, the metric is infinite or NaN.
+   We take that to be beyond the curve, but a ray crosses the curve only
+   if the metric is finite and nonnegative somewhere along it. */
+#define POLAR_FINITE(f) ((f) == (f) && myabs(f) < HUGE_VAL)
+
+typedef struct Polar {
+  ConxBatchMetric *func;
+  void *fArg;
+  ConxContinueFunc *keepgoing;
+  void *kArg;
+  ConxModlType modl;
+  double F[3], e1[3], e2[3]; /* the center and a frame at it */
+  double fx, fy;             /* the center in the model */
+  double f0;                 /* the metric at F */
+  double pixel;              /* the smaller of a pixel's sides */
+  size_t evaluations;
+} Polar;
+
+static void polar_point(const Polar *p, double theta, double rho,
+                        double *x, double *y)
+/* Sets (*x, *y) to the point at distance rho from the center in direction
+   theta, in the canvas's model. */
+{
+  double h[3], c = cos(theta), s = sin(theta);
+  double ch = cosh(rho), sh = sinh(rho);
+  int k;
+
+  for (k = 0; k < 3; k++)
+    h[k] = ch * p->F[k] + sh * (c * p->e1[k] + s * p->e2[k]);
+  conxhm_fromh(h, p->modl, x, y);
+}
+
+static void polar_eval(Polar *p, const double *theta, const double *rho,
+                       const size_t *which, size_t n, double *x, double *y,
+                       double *f)
+/* Sets f[i] to the metric at distance rho[which[i]] in direction
+   theta[which[i]] for 0 <= i < n, with one call to the metric. */
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    polar_point(p, theta[which[i]], rho[which[i]], x + i, y + i);
+  (*p->func)(x, y, f, n, p->fArg);
+  p->evaluations += n;
+}
+
+static void polar_solve(Polar *p, const double *theta, const double *guess,
+                        const double *spread, size_t n, char *found,
+                        double *rho, double *px, double *py)
+/* Finds, for each of the n directions theta[i], where the ray crosses the
+   curve, setting found[i] to nonzero, rho[i] to its distance from the
+   center, and (px[i], py[i]) to that point in the canvas's model, or
+   found[i] to zero if the ray misses the curve.  If guess is not NULL, we
+   look first within about spread[i] of guess[i], which is where the
+   neighboring rays crossed. */
+{
+  double *lo, *hi, *flo, *fhi, *step, *xlo, *ylo, *xhi, *yhi, *x, *y, *f;
+  size_t *which, i, j, m;
+  char *side;
+  int k;
+
+  if (n == 0) return;
+  lo = (double *) malloc(12 * n * sizeof(double));
+  which = (size_t *) malloc(n * sizeof(size_t));
+  side = (char *) malloc(n);
+  CHECK_OOM(lo, "polar_solve");
+  CHECK_OOM(which, "polar_solve");
+  CHECK_OOM(side, "polar_solve");
+  hi = lo + n; flo = hi + n; fhi = flo + n; step = fhi + n;
+  xlo = step + n; ylo = xlo + n; xhi = ylo + n; yhi = xhi + n;
+  x = yhi + n; y = x + n; f = y + n;
+
+  /* Bracket each root between lo and hi.  Without a guess, we search
+     outward from the center with doubling steps.  With one, we search
+     from the guess, outward (side 1) or inward (side -1), with doubling
+     steps. */
+  for (i = 0; i < n; i++) {
+    lo[i] = 0.0; flo[i] = p->f0;
+    xlo[i] = p->fx; ylo[i] = p->fy;
+    found[i] = 0;
+    which[i] = i;
+    if (guess == NULL) {
+      side[i] = 1;
+      step[i] = POLAR_FIRST_STEP;
+      rho[i] = step[i];
+    } else {
+      side[i] = 0;
+      step[i] = greater(spread[i], POLAR_MIN_STEP * (1.0 + guess[i]));
+      rho[i] = guess[i];
+    }
+  }
+  m = n;
+  while (m > 0) {
+    polar_eval(p, theta, rho, which, m, x, y, f);
+    for (i = j = 0; j < m; j++) {
+      size_t r = which[j];
+      if (!(f[j] < 0.0)) {
+        hi[r] = rho[r]; fhi[r] = POLAR_FINITE(f[j]) ? f[j] : HUGE_VAL;
+        xhi[r] = x[j]; yhi[r] = y[j];
+        if (side[r] == 1) {
+          found[r] = 1;
+          continue;
+        }
+        side[r] = -1;
+      } else {
+        lo[r] = rho[r];
+        flo[r] = f[j];
+        xlo[r] = x[j]; ylo[r] = y[j];
+        if (side[r] == -1) {
+          found[r] = 1;
+          continue;
+        }
+        side[r] = 1;
+      }
+      rho[r] += side[r] * step[r];
+      step[r] *= 2.0;
+      if (rho[r] > POLAR_RHO_MAX) continue; /* a miss */
+      if (rho[r] <= 0.0) {
+        /* The center is inside. */
+        lo[r] = 0.0; flo[r] = p->f0;
+        xlo[r] = p->fx; ylo[r] = p->fy;
+        found[r] = 1;
+        continue;
+      }
+      which[i++] = r;
+    }
+    m = i;
+  }
+
+  /* The Illinois variant of false position, until the bracket is less
+     than POLAR_TOLERANCE pixels long on the screen */
+  for (i = m = 0; i < n; i++) {
+    side[i] = 0;
+    if (found[i]) which[m++] = i;
+  }
+  for (k = 0; k < POLAR_MAX_ITERATIONS && m > 0; k++) {
+    for (i = j = 0; j < m; j++) {
+      size_t r = which[j];
+      double t;
+      if (sqrt(sqr(xhi[r] - xlo[r]) + sqr(yhi[r] - ylo[r]))
+          < POLAR_TOLERANCE * p->pixel
+          || !(hi[r] - lo[r] > 1e-13 * (1.0 + hi[r])))
+        continue;
+      t = (fhi[r] < HUGE_VAL && flo[r] > -HUGE_VAL)
+        ? hi[r] - fhi[r] * (hi[r] - lo[r]) / (fhi[r] - flo[r]) : lo[r];
+      rho[r] = (t > lo[r] && t < hi[r]) ? t : (lo[r] + hi[r]) / 2.0;
+      which[i++] = r;
+    }
+    m = i;
+    if (m == 0) break;
+    polar_eval(p, theta, rho, which, m, x, y, f);
+    for (j = 0; j < m; j++) {
+      size_t r = which[j];
+      if (!POLAR_FINITE(f[j])) {
+        hi[r] = rho[r]; fhi[r] = HUGE_VAL; /* bisect */
+        xhi[r] = x[j]; yhi[r] = y[j];
+        side[r] = 0;
+      } else if (f[j] >= 0.0) {
+        hi[r] = rho[r]; fhi[r] = f[j];
+        xhi[r] = x[j]; yhi[r] = y[j];
+        if (side[r] == 1) flo[r] /= 2.0;
+        side[r] = 1;
+      } else {
+        lo[r] = rho[r]; flo[r] = f[j];
+        xlo[r] = x[j]; ylo[r] = y[j];
+        if (side[r] == -1 && fhi[r] < HUGE_VAL) fhi[r] /= 2.0;
+        side[r] = -1;
+      }
+    }
+  }
+  for (i = 0; i < n; i++) {
+    if (found[i] && !(fhi[i] < HUGE_VAL))
+      found[i] = 0; /* The metric blew up before it reached zero. */
+    if (found[i]) {
+      rho[i] = (lo[i] + hi[i]) / 2.0;
+      polar_point(p, theta[i], rho[i], px + i, py + i);
+    }
+  }
+  free(side);
+  free(which);
+  free(lo);
+}
+
+static int polar_visible(const Polar *p, const double *px,
+                         const double *py, size_t i, size_t j)
+/* Returns nonzero if the curve between rays i and j is worth refining. */
+{
+  Pt P, Q;
+
+  P.x = px[i];
+  P.y = py[i];
+  Q.x = px[j];
+  Q.y = py[j];
+  return (*p->keepgoing)(P, Q, p->kArg);
+}
+
+static double polar_turn(const double *px, const double *py,
+                         size_t a, size_t b, size_t c)
+/* Returns the angle through which the polyline a, b, c turns at b. */
+{
+  double ux = px[b] - px[a], uy = py[b] - py[a];
+  double vx = px[c] - px[b], vy = py[c] - py[b];
+
+  return atan2(myabs(ux * vy - uy * vx), ux * vx + uy * vy);
+}
+
+static int polar_split(const Polar *p, const double *theta,
+                       const char *found, const double *px,
+                       const double *py, size_t n, size_t i)
+/* Returns nonzero if we need a ray between ray i and the next. */
+{
+  double d, chord, phi;
+  size_t j = (i + 1) % n, h = (i + n - 1) % n, k = (j + 1) % n;
+  int turns = 0;
+
+  d = theta[j] - theta[i];
+  if (j == 0) d += 2.0 * M_PI;
+  if (d <= POLAR_MIN_DTHETA) return 0;
+  if (found[i] != found[j]) {
+    /* The branch goes off to infinity in between, we cannot say where,
+       and it takes only a few rays to find out. */
+    return 1;
+  }
+  if (!found[i] || !polar_visible(p, px, py, i, j)) return 0;
+  chord = sqrt(sqr(px[j] - px[i]) + sqr(py[j] - py[i]));
+  if (chord > POLAR_MAX_CHORD * p->pixel) return 1;
+
+  /* The curve turns through about phi between the two, as it does at
+     each, so it strays about (chord/2) tan(phi/4) from the chord. */
+  phi = 0.0;
+  if (found[h] && h != j) {
+    phi += polar_turn(px, py, h, i, j);
+    ++turns;
+  }
+  if (found[k] && k != i) {
+    phi += polar_turn(px, py, i, j, k);
+    ++turns;
+  }
+  phi = (turns > 0) ? phi / turns : M_PI / 2.0;
+  return (chord / 2.0 * tan(lesser(phi, 3.0) / 4.0)
+          > POLAR_SAGITTA * p->pixel);
+}
+
+static size_t polar_refine(Polar *p, double **theta, char **found,
+                           double **rho, double **px, double **py, size_t n)
+/* Adds rays where the polyline through the n rays' points, in order of
+   theta, would not follow the curve closely enough, as described at the
+   top of this file.  The arrays are reallocated.  Returns the new number
+   of rays. */
+{
+  double *mt, *mr, *mx, *my, *mg, *ms, *nt, *nr, *nx, *ny, d;
+  char *mf, *nf;
+  size_t *pair, i, j, k, m, nn;
+
+  for (;;) {
+    /* The directions between pairs that need splitting */
+    mt = (double *) malloc(6 * n * sizeof(double));
+    pair = (size_t *) malloc(n * sizeof(size_t));
+    mf = (char *) malloc(n);
+    CHECK_OOM(mt, "polar_refine");
+    CHECK_OOM(pair, "polar_refine");
+    CHECK_OOM(mf, "polar_refine");
+    mr = mt + n; mx = mr + n; my = mx + n; mg = my + n; ms = mg + n;
+    for (i = m = 0; i < n && n + m < POLAR_MAX_RAYS; i++) {
+      if (!polar_split(p, *theta, *found, *px, *py, n, i)) continue;
+      j = (i + 1) % n;
+      d = (*theta)[j] - (*theta)[i];
+      if (j == 0) d += 2.0 * M_PI;
+      mt[m] = (*theta)[i] + d / 2.0;
+      if ((*found)[i] && (*found)[j]) {
+        mg[m] = ((*rho)[i] + (*rho)[j]) / 2.0;
+        ms[m] = myabs((*rho)[j] - (*rho)[i]);
+      } else {
+        /* Where a branch goes off to infinity, the found neighbor's
+           distance is no guide. */
+        mg[m] = (*found)[i] ? (*rho)[i] : (*rho)[j];
+        ms[m] = POLAR_FIRST_STEP;
+      }
+      pair[m++] = i;
+    }
+    if (m == 0) break;
+    polar_solve(p, mt, mg, ms, m, mf, mr, mx, my);
+
+    /* Merge the new rays into the old. */
+    nt = (double *) malloc(4 * (n + m) * sizeof(double));
+    nf = (char *) malloc(n + m);
+    CHECK_OOM(nt, "polar_refine");
+    CHECK_OOM(nf, "polar_refine");
+    nr = nt + n + m; nx = nr + n + m; ny = nx + n + m;
+    for (i = k = nn = 0; i < n; i++) {
+      nt[nn] = (*theta)[i]; nf[nn] = (*found)[i]; nr[nn] = (*rho)[i];
+      nx[nn] = (*px)[i]; ny[nn++] = (*py)[i];
+      if (k < m && pair[k] == i) {
+        nt[nn] = mt[k]; nf[nn] = mf[k]; nr[nn] = mr[k];
+        nx[nn] = mx[k]; ny[nn++] = my[k];
+        ++k;
+      }
+    }
+    free(mf); free(pair); free(mt);
+    free(*theta); free(*found);
+    /* rho, px, and py share theta's block, as they share the first
+       pass's. */
+    *theta = nt; *rho = nr; *px = nx; *py = ny; *found = nf;
+    n = nn;
+  }
+  free(mf); free(pair); free(mt);
+  return n;
+}
+
+static void polar_output(const double *px, const double *py,
+                         const char *found, size_t n,
+                         ConxPolylineFunc *lfunc, void *lArg)
+/* Calls (*lfunc)() with each run of rays that hit the curve, closing the
+   polyline if they all did. */
+{
+  Pt *pts;
+  size_t i, j, start, m;
+
+  pts = (Pt *) malloc((n + 1) * sizeof(Pt));
+  CHECK_OOM(pts, "polar_output");
+  /* Start just after a miss, if there is one. */
+  for (start = 0; start < n && found[(start + n - 1) % n]; start++)
+    ;
+  if (start == n) {
+    for (i = 0; i < n; i++) {
+      pts[i].x = px[i];
+      pts[i].y = py[i];
+    }
+    pts[n] = pts[0];
+    if (n > 1) (*lfunc)(pts, n + 1, lArg);
+  } else {
+    for (m = 0, j = 0; j < n; j++) {
+      i = (start + j) % n;
+      if (found[i]) {
+        pts[m].x = px[i];
+        pts[m++].y = py[i];
+      }
+      if (!found[i] || j == n - 1) {
+        if (m > 1) (*lfunc)(pts, m, lArg);
+        m = 0;
+      }
+    }
+  }
+  free(pts);
+}
+
+size_t conx_polar(const double *F, ConxModlType modl, ConxBatchMetric *func,
+                  void *fArg, double delta_x, double delta_y,
+                  ConxContinueFunc *keepgoing, void *kArg,
+                  ConxPolylineFunc *lfunc, void *lArg)
+/* Calls (*lfunc)(pts, n, lArg) with polylines through the curve on which
+   the metric of *func is zero, in the modl model.  The curve must be
+   star-shaped about the point F of the hyperboloid: the metric must be
+   negative at F and must not decrease along any geodesic ray from F.
+   It should be infinite or NaN at points too near the boundary to be
+   told apart from it.  delta_x and delta_y are a pixel's sides, as for
+   conx_trace.  We add no rays between the points P and Q of neighboring
+   rays where (*keepgoing)(P, Q, kArg) returns zero, e.g. where the curve
+   between them cannot be on the screen.  A closed curve's polyline ends
+   where it began.
+
+   Returns the number of points at which *func was evaluated.
+*/
+{
+  Polar p;
+  double *theta, *rho, *px, *py, t;
+  char *found;
+  size_t i, n = POLAR_FIRST_RAYS;
+
+  assert(F != NULL); assert(func != NULL); assert(keepgoing != NULL);
+  assert(lfunc != NULL);
+  p.pixel = lesser(delta_x, delta_y);
+  if (!(p.pixel > 0.0)) return 0;
+  p.func = func;
+  p.fArg = fArg;
+  p.keepgoing = keepgoing;
+  p.kArg = kArg;
+  p.modl = modl;
+  p.F[0] = F[0]; p.F[1] = F[1]; p.F[2] = F[2];
+  /* The boost that takes the origin to F takes the X and Y axes to e1 and
+     e2, which are orthonormal and orthogonal to F. */
+  t = 1.0 + F[2];
+  p.e1[0] = 1.0 + F[0] * F[0] / t;
+  p.e1[1] = F[0] * F[1] / t;
+  p.e1[2] = F[0];
+  p.e2[0] = p.e1[1];
+  p.e2[1] = 1.0 + F[1] * F[1] / t;
+  p.e2[2] = F[1];
+  p.evaluations = 1;
+  conxhm_fromh(F, modl, &p.fx, &p.fy);
+  (*func)(&p.fx, &p.fy, &p.f0, 1, fArg);
+  if (!(p.f0 < 0.0)) return p.evaluations;
+
+  theta = (double *) malloc(4 * n * sizeof(double));
+  found = (char *) malloc(n);
+  CHECK_OOM(theta, "conx_polar");
+  CHECK_OOM(found, "conx_polar");
+  rho = theta + n; px = rho + n; py = px + n;
+  for (i = 0; i < n; i++)
+    theta[i] = 2.0 * M_PI * (double) i / (double) n;
+  polar_solve(&p, theta, NULL, NULL, n, found, rho, px, py);
+  n = polar_refine(&p, &theta, &found, &rho, &px, &py, n);
+  polar_output(px, py, found, n, lfunc, lArg);
+  free(found);
+  free(theta);
+  return p.evaluations;
+}
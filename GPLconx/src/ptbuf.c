@@ -0,0 +1,138 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  A growable array of points.  The drawing engines use these to hold
+  onto points that a worker found so that the points can be handed to
+  a ConxPointFunc later, in a well-defined order.
+
+  Also the ConxVertexSink, through which the engines hand points to a
+  canvas many at a time rather than one call apiece.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "viewer.h"
+#include "util.h"
+
+#define PTBUF_INITIAL_SIZE 64
+
+void conx_ptbuf_init(ConxPtBuffer *b)
+{
+  b->pts = NULL;
+  b->n = b->sz = 0;
+}
+
+void conx_ptbuf_free(ConxPtBuffer *b)
+{
+  if (b->pts != NULL) free(b->pts);
+  conx_ptbuf_init(b);
+}
+
+void conx_ptbuf_append(double x, double y, void *bb)
+/* This is a ConxPointFunc so that you can pass a ConxPtBuffer * to any
+   engine that calls a ConxPointFunc. */
+{
+  ConxPtBuffer *b = (ConxPtBuffer *) bb;
+  if (b->n == b->sz) {
+    b->sz = (b->sz == 0) ? PTBUF_INITIAL_SIZE : 2 * b->sz;
+    b->pts = (Pt *) realloc(b->pts, b->sz * sizeof(Pt));
+    CHECK_OOM(b->pts, "conx_ptbuf_append");
+  }
+  b->pts[b->n].x = x;
+  b->pts[b->n].y = y;
+  ++b->n;
+}
+
+void conx_ptbuf_replay(const ConxPtBuffer *b, ConxPointFunc *pfunc, void *pArg)
+/* Calls (*pfunc)(x, y, pArg) for each point in b in the order in which
+   the points were appended. */
+{
+  size_t i;
+  for (i = 0; i < b->n; i++)
+    (*pfunc)(b->pts[i].x, b->pts[i].y, pArg);
+}
+
+void conx_ptbuf_extend(const Pt *pts, size_t n, void *bb)
+/* Appends n points to the ConxPtBuffer *bb.  This is a ConxPolylineFunc
+   so that it can be a ConxVertexSink's flush function. */
+{
+  ConxPtBuffer *b = (ConxPtBuffer *) bb;
+  if (b->n + n > b->sz) {
+    while (b->n + n > b->sz)
+      b->sz = (b->sz == 0) ? PTBUF_INITIAL_SIZE : 2 * b->sz;
+    b->pts = (Pt *) realloc(b->pts, b->sz * sizeof(Pt));
+    CHECK_OOM(b->pts, "conx_ptbuf_extend");
+  }
+  memcpy(b->pts + b->n, pts, n * sizeof(Pt));
+  b->n += n;
+}
+
+void conx_sink_init(ConxVertexSink *s, Pt *pts, size_t sz,
+                    ConxPolylineFunc *flush, void *fArg)
+/* Makes *s an empty sink that holds up to sz points in pts, which must
+   outlive it, and gives them to *flush. */
+{
+  assert(pts != NULL); assert(sz > 0); assert(flush != NULL);
+  s->pts = pts;
+  s->n = 0;
+  s->sz = sz;
+  s->flush = flush;
+  s->fArg = fArg;
+}
+
+void conx_sink_flush(ConxVertexSink *s)
+/* Gives the points in *s, if any, to its flush function and empties it. */
+{
+  if (s->n > 0) (*s->flush)(s->pts, s->n, s->fArg);
+  s->n = 0;
+}
+
+void conx_sink_vertex(double x, double y, void *s)
+/* This is a ConxPointFunc so that you can pass a ConxVertexSink * to any
+   engine that calls a ConxPointFunc.  Flush the sink when the engine is
+   done. */
+{
+  CONX_SINK_VERTEX((ConxVertexSink *) s, x, y);
+}
+
+void conx_sink_ptbuf(ConxVertexSink *s, const ConxPtBuffer *b)
+/* Gives the points of b to *s's flush function, after those already in
+   *s, without copying them into *s. */
+{
+  conx_sink_flush(s);
+  if (b->n > 0) (*s->flush)(b->pts, b->n, s->fArg);
+}
+
+void conx_points_of_batch(const Pt *pts, size_t n, void *adapter)
+/* A ConxVertexSink flush function that calls a ConxPointFunc for each
+   point.  adapter is a ConxPointFuncAdapter *.  This lets the engines that
+   fill a ConxVertexSink serve callers that want one point at a time. */
+{
+  ConxPointFuncAdapter *a = (ConxPointFuncAdapter *) adapter;
+  size_t i;
+  for (i = 0; i < n; i++)
+    (*a->pfunc)(pts[i].x, pts[i].y, a->pArg);
+}
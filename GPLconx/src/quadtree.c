@@ -0,0 +1,242 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  The quadtree method finds the same points that the LONGWAY method does,
+  but it does not evaluate the metric at most of the points that are
+  nowhere near the curve.
+
+  The metrics we draw are Lipschitz with respect to hyperbolic distance:
+  |f(P) - f(Q)| <= K*d(P, Q).  In a model, hyperbolic distance is at most
+  the Euclidean distance times the largest conformal factor along the way,
+  which is 1/(1-r^2) in the Beltrami-Klein disk (the Klein disk is not
+  conformal, but that is its largest stretch), 2/(1-r^2) in the Poincare
+  disk, and 1/y in the Poincare UHP.  So if we know f at one lattice point
+  C of a cell, then every lattice point P of the cell has
+
+    |f(P)| >= |f(C)| - K*lambda*|P - C|
+
+  where lambda is the largest conformal factor over the cell's bounding
+  box.  If that is at least the tolerance for every P, no point of the
+  cell is drawn, and we need not look inside.  Otherwise we split the
+  cell into four and try again, down to small cells whose points we
+  simply evaluate.
+
+  Near the boundary at infinity, lambda blows up and CConxPoint treats
+  points within EQUALITY_TOL of the boundary as being at infinity, so we
+  never reject a cell that comes near the boundary.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "viewer.h"
+#include "util.h"
+
+/* Cells with at most this many lattice points are evaluated point by
+   point. */
+#define QUADTREE_LEAF 16
+
+/* A cell is never rejected if it comes this close to the boundary. */
+#define QUADTREE_BOUNDARY 1.0e-6
+
+/* We only reject a cell if it clears the tolerance by this much, which
+   covers rounding errors and the approximations in distances from
+   lines. */
+#define QUADTREE_MARGIN 1.0e-6
+
+typedef struct Quadtree {
+  const ConxLattice *L;
+  ConxBatchMetric *test;
+  void *testArg;
+  ConxModlType modl;
+  double tlrance, lipschitz;
+  char *hit;                  /* one flag per lattice point */
+  size_t evaluations;
+} Quadtree;
+
+static void quadtree_leaf(Quadtree *q, size_t i0, size_t i1,
+                          size_t j0, size_t j1)
+/* Evaluates the metric at each lattice point of the cell. */
+{
+  double x[QUADTREE_LEAF], y[QUADTREE_LEAF], f[QUADTREE_LEAF];
+  size_t where[QUADTREE_LEAF];
+  size_t i, j, jhi, n = 0;
+  const ConxLattice *L = q->L;
+
+  for (i = i0; i < i1; i++) {
+    jhi = (j1 < L->count[i]) ? j1 : L->count[i];
+    for (j = j0; j < jhi; j++) {
+      where[n] = L->start[i] + j;
+      x[n] = (L->kx != NULL) ? L->kx[where[n]] : L->xs[i];
+      y[n] = (L->ky != NULL) ? L->ky[where[n]] : L->ys[where[n]];
+      ++n;
+    }
+  }
+  if (n == 0) return;
+  (*q->test)(x, y, f, n, q->testArg);
+  q->evaluations += n;
+  for (i = 0; i < n; i++) {
+    if (myabs(f[i]) < q->tlrance)
+      q->hit[where[i]] = 1;
+  }
+}
+
+static int quadtree_rejects(Quadtree *q, size_t i0, size_t i1,
+                            size_t j0, size_t j1, int *empty)
+/* Returns non-zero if no lattice point of the cell can be drawn.  Sets
+   *empty to non-zero if the cell has no lattice points at all. */
+{
+  const ConxLattice *L = q->L;
+  double xlo, xhi, ylo = 0.0, yhi = 0.0, cx, cy, fc, r2, lambda, delta, t;
+  double corners[4][2];
+  size_t i, ic, jc, jhi, kc;
+  int k, any = 0;
+
+  /* The Euclidean bounding box of the cell's lattice points */
+  xlo = L->xs[i0];
+  xhi = L->xs[i1-1];
+  for (i = i0; i < i1; i++) {
+    jhi = (j1 < L->count[i]) ? j1 : L->count[i];
+    if (j0 < jhi) {
+      if (!any || L->ys[L->start[i]+j0] < ylo) ylo = L->ys[L->start[i]+j0];
+      if (!any || L->ys[L->start[i]+jhi-1] > yhi)
+        yhi = L->ys[L->start[i]+jhi-1];
+      any = 1;
+    }
+  }
+  *empty = !any;
+  if (!any) return 1;
+
+  /* The largest conformal factor over the box */
+  corners[0][0] = xlo; corners[0][1] = ylo;
+  corners[1][0] = xlo; corners[1][1] = yhi;
+  corners[2][0] = xhi; corners[2][1] = ylo;
+  corners[3][0] = xhi; corners[3][1] = yhi;
+  if (q->modl == CONX_POINCARE_UHP) {
+    if (ylo <= QUADTREE_BOUNDARY) return 0;
+    lambda = 1.0/ylo;
+  } else {
+    r2 = 0.0;
+    for (k = 0; k < 4; k++) {
+      t = sqr(corners[k][0]) + sqr(corners[k][1]);
+      if (t > r2) r2 = t;
+    }
+    if (r2 >= sqr(1.0 - QUADTREE_BOUNDARY)) return 0;
+    lambda = ((q->modl == CONX_POINCARE_DISK) ? 2.0 : 1.0)/(1.0 - r2);
+  }
+
+  /* A lattice point near the middle of the cell */
+  ic = (i0 + i1)/2;
+  jhi = (j1 < L->count[ic]) ? j1 : L->count[ic];
+  if (j0 >= jhi) return 0;
+  jc = (j0 + j1)/2;
+  if (jc >= jhi) jc = jhi - 1;
+  kc = L->start[ic] + jc;
+  cx = L->xs[ic];
+  cy = L->ys[kc];
+
+  delta = 0.0;
+  for (k = 0; k < 4; k++) {
+    t = sqr(corners[k][0] - cx) + sqr(corners[k][1] - cy);
+    if (t > delta) delta = t;
+  }
+  delta = sqrt(delta);
+
+  if (L->kx != NULL)
+    (*q->test)(L->kx + kc, L->ky + kc, &fc, 1, q->testArg);
+  else
+    (*q->test)(&cx, &cy, &fc, 1, q->testArg);
+  ++q->evaluations;
+  return (myabs(fc) - q->lipschitz*lambda*delta
+          > q->tlrance + QUADTREE_MARGIN);
+}
+
+static void quadtree_cell(Quadtree *q, size_t i0, size_t i1,
+                          size_t j0, size_t j1)
+/* Finds the lattice points to draw among the points in columns i0 through
+   i1-1 and rows j0 through j1-1. */
+{
+  size_t im, jm;
+  int empty;
+
+  if ((i1 - i0) * (j1 - j0) <= QUADTREE_LEAF) {
+    quadtree_leaf(q, i0, i1, j0, j1);
+    return;
+  }
+  if (quadtree_rejects(q, i0, i1, j0, j1, &empty)) return;
+
+  im = (i1 - i0 > 1) ? (i0 + i1)/2 : i1;
+  jm = (j1 - j0 > 1) ? (j0 + j1)/2 : j1;
+  quadtree_cell(q, i0, im, j0, jm);
+  if (jm < j1) quadtree_cell(q, i0, im, jm, j1);
+  if (im < i1) {
+    quadtree_cell(q, im, i1, j0, jm);
+    if (jm < j1) quadtree_cell(q, im, i1, jm, j1);
+  }
+}
+
+size_t conx_longway_quadtree(ConxBatchMetric *test, void *testArg,
+                             double lipschitz, ConxModlType modl,
+                             double tlrance, const ConxLattice *L,
+                             ConxPointFunc *pfunc, void *pArg)
+/* Calls (*pfunc)(x,y,pArg) for exactly the points, and in exactly the
+   order, that conx_lattice_longway would given the same arguments.  L is
+   a lattice in the modl model; *test is given Klein coordinates if L has
+   them.  lipschitz must be such that |f(P) - f(Q)| <= lipschitz*d(P, Q)
+   for any two points P and Q that are not at infinity, where f is *test
+   and d is hyperbolic distance.  If lipschitz is negative, this is just
+   conx_lattice_longway.
+
+   Returns the number of points at which *test was evaluated.
+*/
+{
+  Quadtree q;
+  size_t i, j;
+
+  if (lipschitz < 0.0) {
+    conx_lattice_longway(test, &testArg, 1, tlrance, L, pfunc, pArg);
+    return conx_lattice_size(L);
+  }
+  q.L = L;
+  q.test = test;
+  q.testArg = testArg;
+  q.modl = modl;
+  q.tlrance = tlrance;
+  q.lipschitz = lipschitz;
+  q.evaluations = 0;
+  q.hit = NULL;
+  if (L->ncols > 0 && L->maxcount > 0) {
+    q.hit = (char *) calloc(conx_lattice_size(L), 1);
+    CHECK_OOM(q.hit, "conx_longway_quadtree");
+    quadtree_cell(&q, 0, L->ncols, 0, L->maxcount);
+    for (i = 0; i < L->ncols; i++) {
+      for (j = 0; j < L->count[i]; j++) {
+        if (q.hit[L->start[i]+j])
+          (*pfunc)(L->xs[i], L->ys[L->start[i]+j], pArg);
+      }
+    }
+    free(q.hit);
+  }
+  return q.evaluations;
+}
@@ -0,0 +1,96 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Internal header for the batch (many points at a time) kernels.
+
+  CONX_VEC_WIDTH doubles fit in a ConxVec.  If the compiler targets
+  neither AVX nor SSE2, CONX_VEC_WIDTH is 1 and the V* macros are not
+  defined, so the kernels must have a plain C loop for that case and for
+  the points left over at the end of an array.
+
+  Every kernel must do exactly the same floating-point operations in
+  exactly the same order as its one-point-at-a-time twin.  SSE2 and AVX
+  arithmetic, division, and square roots are correctly rounded, so the
+  two give identical answers.  That is important: a LONGWAY drawing must
+  not depend on which way we computed it.
+
+  CONX_FVEC_WIDTH floats fit in a ConxFVec, for the single-precision
+  (CONX_FAST) kernels, and the FV* macros are their V* macros.  The
+  same rule holds for those kernels: they must match their plain C loops
+  exactly.
+ */
+
+#ifndef CONX_SIMDINT_H
+#define CONX_SIMDINT_H 1
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CONX_VEC_WIDTH 4
+typedef __m256d ConxVec;
+#define VLOAD(p) _mm256_loadu_pd(p)
+#define VSTORE(p, a) _mm256_storeu_pd((p), (a))
+#define VSET1(d) _mm256_set1_pd(d)
+#define VADD(a, b) _mm256_add_pd((a), (b))
+#define VSUB(a, b) _mm256_sub_pd((a), (b))
+#define VMUL(a, b) _mm256_mul_pd((a), (b))
+#define VDIV(a, b) _mm256_div_pd((a), (b))
+#define VSQRT(a) _mm256_sqrt_pd(a)
+#define VABS(a) _mm256_andnot_pd(_mm256_set1_pd(-0.0), (a))
+#define CONX_FVEC_WIDTH 8
+typedef __m256 ConxFVec;
+#define FVLOAD(p) _mm256_loadu_ps(p)
+#define FVSTORE(p, a) _mm256_storeu_ps((p), (a))
+#define FVSET1(d) _mm256_set1_ps(d)
+#define FVADD(a, b) _mm256_add_ps((a), (b))
+#define FVSUB(a, b) _mm256_sub_ps((a), (b))
+#define FVMUL(a, b) _mm256_mul_ps((a), (b))
+#define FVDIV(a, b) _mm256_div_ps((a), (b))
+#define FVSQRT(a) _mm256_sqrt_ps(a)
+#define FVABS(a) _mm256_andnot_ps(_mm256_set1_ps(-0.0f), (a))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CONX_VEC_WIDTH 2
+typedef __m128d ConxVec;
+#define VLOAD(p) _mm_loadu_pd(p)
+#define VSTORE(p, a) _mm_storeu_pd((p), (a))
+#define VSET1(d) _mm_set1_pd(d)
+#define VADD(a, b) _mm_add_pd((a), (b))
+#define VSUB(a, b) _mm_sub_pd((a), (b))
+#define VMUL(a, b) _mm_mul_pd((a), (b))
+#define VDIV(a, b) _mm_div_pd((a), (b))
+#define VSQRT(a) _mm_sqrt_pd(a)
+#define VABS(a) _mm_andnot_pd(_mm_set1_pd(-0.0), (a))
+#define CONX_FVEC_WIDTH 4
+typedef __m128 ConxFVec;
+#define FVLOAD(p) _mm_loadu_ps(p)
+#define FVSTORE(p, a) _mm_storeu_ps((p), (a))
+#define FVSET1(d) _mm_set1_ps(d)
+#define FVADD(a, b) _mm_add_ps((a), (b))
+#define FVSUB(a, b) _mm_sub_ps((a), (b))
+#define FVMUL(a, b) _mm_mul_ps((a), (b))
+#define FVDIV(a, b) _mm_div_ps((a), (b))
+#define FVSQRT(a) _mm_sqrt_ps(a)
+#define FVABS(a) _mm_andnot_ps(_mm_set1_ps(-0.0f), (a))
+#else
+#define CONX_VEC_WIDTH 1
+#define CONX_FVEC_WIDTH 1
+#endif
+
+#endif /* CONX_SIMDINT_H */
@@ -27,7 +27,9 @@
 
 #include "stcanvas.hh"
 #include "stdrawbl.hh"
+#include "stpoint.hh"
 #include "sterror.hh"
+#include "stfloat.hh"
 
 Answerers *CClsCanvas::ansMachs = NULL;
 
@@ -62,6 +64,48 @@ CClsCanvas::oiActionSync(CClsBase **result, CConxClsMessage &o)
   RETURN_THIS(result); // DLC return this???
 }
 
+NF_INLINE CClsBase::ErrType
+CClsCanvas::oiActionTranslateBy(CClsBase **result, CConxClsMessage &o)
+{
+  if (cv == NULL) {
+    RETURN_ERROR_RESULT(result,
+                        "This object instance is not tied to any canvas.");
+  }
+  CClsBase *argv[1]; o.getBoundObjects(argv);
+  ENSURE_KEYWD_TYPE(result, o, argv, 0, CLS_POINT, TRUE);
+  try {
+    cv->translateBy(((CClsPoint *)argv[0])->getValue());
+  } catch (CClsError *ne) {
+    RETURN_NEW_RESULT(result, ne);
+  } catch (int) {
+    RETURN_ERROR_RESULT(result, "cannot translate to a point at infinity");
+  }
+  RETURN_THIS(result);
+}
+
+NF_INLINE CClsBase::ErrType
+CClsCanvas::oiActionRotateBy(CClsBase **result, CConxClsMessage &o)
+{
+  if (cv == NULL) {
+    RETURN_ERROR_RESULT(result,
+                        "This object instance is not tied to any canvas.");
+  }
+  NEED_N_FLOATS(1, fargv, o, result);
+  cv->rotateBy(fargv[0]);
+  RETURN_THIS(result);
+}
+
+NF_INLINE CClsBase::ErrType
+CClsCanvas::oiActionResetView(CClsBase **result, CConxClsMessage &o)
+{
+  if (cv == NULL) {
+    RETURN_ERROR_RESULT(result,
+                        "This object instance is not tied to any canvas.");
+  }
+  cv->resetView();
+  RETURN_THIS(result);
+}
+
 NF_INLINE
 void CClsCanvas::initializeAnsweringMachines()
 {
@@ -73,6 +117,15 @@ void CClsCanvas::initializeAnsweringMachines()
                "Makes the elements on screen correspond to the contents of this array");
     ST_CMETHOD(ansMachs, "new", "instance creation", CLASS, ciAnswererNew,
                "Returns a new canvas that is not connected to a display");
+    ST_CMETHOD(ansMachs, "translateBy:", "viewing",
+               OBJECT, oiAnswererTranslateBy,
+               "Moves the view so that the origin goes to the argument, a Point; a drag moves what was drawn, and the next redraw draws the Drawables afresh");
+    ST_CMETHOD(ansMachs, "rotateBy:", "viewing",
+               OBJECT, oiAnswererRotateBy,
+               "Turns the view counterclockwise about the origin by the argument, in radians; a drag moves what was drawn, and the next redraw draws the Drawables afresh");
+    ST_CMETHOD(ansMachs, "resetView", "viewing",
+               OBJECT, oiAnswererResetView,
+               "Undoes all translateBy: and rotateBy: messages");
   }
 }
 
@@ -67,6 +67,12 @@ protected:
   NEW_OI_ANSWERER(CClsCanvas); // otherwise `Canvas new' will act as `Array new'
   ANSWERER_FOR_ACTION_DEFN_BELOW(CClsCanvas, oiAnswererSync,
                                  oiActionSync, /* non-const */);
+  ANSWERER_FOR_ACTION_DEFN_BELOW(CClsCanvas, oiAnswererTranslateBy,
+                                 oiActionTranslateBy, /* non-const */);
+  ANSWERER_FOR_ACTION_DEFN_BELOW(CClsCanvas, oiAnswererRotateBy,
+                                 oiActionRotateBy, /* non-const */);
+  ANSWERER_FOR_ACTION_DEFN_BELOW(CClsCanvas, oiAnswererResetView,
+                                 oiActionResetView, /* non-const */);
 private:
   static void initializeAnsweringMachines();
 
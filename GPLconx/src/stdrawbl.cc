@@ -125,6 +125,14 @@ void CClsDrawable::affectValue(CConxDwGeomObj &r) const
   r.setColor(color->getColor());
   if (drawingMethod->getValue() == "longway") { // DLC #longway
     r.setDrawingMethod(r.LONGWAY);
+  } else if (drawingMethod->getValue() == "quadtree") {
+    r.setDrawingMethod(r.QUADTREE);
+  } else if (drawingMethod->getValue() == "contour") {
+    r.setDrawingMethod(r.CONTOUR);
+  } else if (drawingMethod->getValue() == "tracer") {
+    r.setDrawingMethod(r.TRACER);
+  } else if (drawingMethod->getValue() == "polar") {
+    r.setDrawingMethod(r.POLAR);
   } else {
     r.setDrawingMethod(r.BRESENHAM);
   }
@@ -186,7 +194,7 @@ void CClsDrawable::initializeAnsweringMachines()
     ansMachs = new Answerers();
     if (ansMachs == NULL) OOM();
     ST_CMETHOD(ansMachs, "new", "instance creation", CLASS, ciAnswererNew,
-               "Returns a new object instance of a drawable object, whose subclasses include points, lines, circles, parabolas, etc.  Use drawingMethod #longway for the safe method and anything else for the Bresenham method.");
+               "Returns a new object instance of a drawable object, whose subclasses include points, lines, circles, parabolas, etc.  Use drawingMethod #longway for the safe method, #quadtree for a faster method that draws the same points as the safe method, #contour to draw connected lines through the curve's interpolated points, #tracer to follow curves with a predictor-corrector, #polar to solve for conics along rays from a focus, and anything else for the Bresenham method.");
 
     ADD_ANS_GETTER("drawWithGarnish", DrawWithGarnish);
     ADD_ANS_GETTER("thickness", Thickness);
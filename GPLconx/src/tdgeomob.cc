@@ -27,14 +27,116 @@
 #endif
 
 #include <assert.h>
+#include <math.h>
 #include <stdlib.h>
+#include <time.h>
 #include <iostream.h>
 #include <strstream.h>
 
 #include "dgeomobj.hh"
+#include "canvas.hh"
+#include "kernels.hh"
+#include "CSArray.hh"
 #include "CString.hh"
 #include "tester.hh"
 
+//////////////////////////////////////////////////////////////////////////////
+// A canvas that remembers the vertices drawn on it in the order in which
+// they were drawn rather than drawing anything.  It also remembers where
+// each LINE_STRIP starts.
+class CConxRecordingCanvas : VIRT public CConxCanvas {
+  CCONX_CLASSNAME("CConxRecordingCanvas")
+public:
+  CConxRecordingCanvas() : bresenhams(0), drawnPrecision(CONX_PRECISE) { }
+  SDID startSD() throw(int) { return 0; }
+  void stopSD() { }
+  void deleteSD(SDID id) { }
+  void deleteAllSD() { }
+  void executeSD(SDID id) { }
+  void beginDraw(DrawingType dt)
+  {
+    recordBegin(dt);
+    drawnPrecision = getMetricPrecision();
+    if (dt == LINE_STRIP) strips.append(numVertices());
+  }
+  void endDraw() { }
+  void drawVertex(double x, double y)
+  {
+    Pt p;
+    p.x = x; p.y = y;
+    vertices.append(*recordVertices(&p, 1));
+  }
+  void drawCircle(double x, double y, double r)
+  {
+    drawArc(x, y, r, 0.0, M_PI * 2.0);
+  }
+  void drawTopSemiCircle(double x, double y, double r) { }
+  void drawArc(double x, double y, double r, double t0, double t1)
+  {
+    Conic c;
+    c.x = x; c.y = y; c.a = c.b = r; c.phi = 0.0;
+    c.t0 = t0; c.t1 = t1;
+    conics.append(c);
+  }
+  void drawEllipse(double x, double y, double a, double b, double phi)
+  {
+    Conic c;
+    c.x = x; c.y = y; c.a = a; c.b = b; c.phi = phi;
+    c.t0 = 0.0; c.t1 = M_PI * 2.0;
+    conics.append(c);
+  }
+  void drawByBresenham(const CConxPoint &lb, const CConxPoint &rb,
+                       DFN *f, const CConxSimpleArtist *sa)
+  {
+    ++bresenhams;
+    drawnPrecision = getMetricPrecision();
+  }
+  void setDrawingColor(const CConxColor &C) { }
+  void setPointSize(double pSize) { }
+  void flushQueue() { }
+  void clear() { vertices.clear(); strips.clear(); conics.clear(); }
+  void initDraw() { }
+
+  size_t numVertices() const { return vertices.size(); }
+  Pt getVertex(size_t i) const { return vertices.get(i); }
+  size_t numStrips() const { return strips.size(); }
+  size_t getStripStart(size_t i) const { return strips.get(i); }
+  size_t numBresenhams() const { return bresenhams; }
+  size_t numConics() const { return conics.size(); }
+  // The metric precision when something was last drawn
+  ConxPrecision getDrawnPrecision() const { return drawnPrecision; }
+  // Returns the point of the i-th arc or ellipse drawn that is the
+  // fraction u of the way along it.
+  Pt getConicPoint(size_t i, double u) const
+  {
+    Conic c = conics.get(i);
+    double t = c.t0 + u * (c.t1 - c.t0), p = c.a * cos(t), q = c.b * sin(t);
+    Pt v;
+    v.x = c.x + p * cos(c.phi) - q * sin(c.phi);
+    v.y = c.y + p * sin(c.phi) + q * cos(c.phi);
+    return v;
+  }
+  int sameVertices(const CConxRecordingCanvas &o) const
+  {
+    if (numVertices() != o.numVertices()) return 0;
+    for (size_t i = 0; i < numVertices(); i++) {
+      Pt a = getVertex(i), b = o.getVertex(i);
+      if (a.x != b.x || a.y != b.y) return 0;
+    }
+    return 1;
+  }
+
+private:
+  struct Conic {
+    double x, y, a, b, phi, t0, t1;
+  };
+  CConxSimpleArray<Pt> vertices;
+  CConxSimpleArray<size_t> strips;
+  CConxSimpleArray<Conic> conics;
+  size_t bresenhams;
+  ConxPrecision drawnPrecision;
+}; // class CConxRecordingCanvas
+
 static int tcolor(void);
 static int tcircle(void);
 static int thypellipse(void);
@@ -43,6 +145,27 @@ static int tparabola(void);
 static int tline(void);
 static int tlineseg(void);
 static int tpoint(void);
+static int tlongway(void);
+static int tdefiningfunctions(void);
+static int tquadtree(void);
+static int tcontour(void);
+static int tzoom(void);
+static int tfieldraster(void);
+static int tatlas(void);
+static int tfused(void);
+static int tfast(void);
+static int tcompare(void);
+static int tprogressive(void);
+static int ttracer(void);
+static int tgradients(void);
+static int tbresmemo(void);
+static int tbresthreads(void);
+static int tbresclosure(void);
+static int tsink(void);
+static int tkernels(void);
+static int tview(void);
+static int tclosedform(void);
+static int tpolar(void);
 
 int tcolor(void)
 {
@@ -203,7 +326,7 @@ int tpoint(void)
   char *s = ostr.str();
 #ifndef NO_IFFY_TESTS
   OUT(s);
-  RET1(CConxString("first all <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015> then kd <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015> and now pd <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015> and now puhp <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015> and now all again <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015>\n") == s);
+  RET1(CConxString("first all <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015, precision=0> then kd <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015, precision=0> and now pd <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015, precision=0> and now puhp <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015, precision=0> and now all again <CConxDwGeomObj object {Point: [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]} color=CConxColor[RGB=(0, 1, 0.3), HSV=(138, 1, 1)], isValid=FALSE, withGarnish=TRUE, drawingMethod=BEST, thickness=1, lwtol=0.0015, precision=0>\n") == s);
 #endif
   delete [] s;
   
@@ -211,6 +334,1832 @@ int tpoint(void)
   return 0;
 }
 
+int tlongway(void)
+// Returns zero if drawing by the LONGWAY method with many threads draws
+// exactly what drawing with one thread does, with each thread's copy of a
+// line-based artist's hoisted metric as well as with a circle's metric.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK);
+  CConxLine L(CConxPoint(-0.3, 0.4, CONX_POINCARE_DISK),
+              CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxCircle circle(f1, 0.8);
+  CConxParabola parabola(f1, L);
+  const CConxSimpleArtist *artists[2] = { &circle, &parabola };
+  for (int a = 0; a < 2; a++) {
+    for (int m = 0; m < CONX_NUM_MODELS; m++) {
+      CConxDwGeomObj c(*artists[a]);
+      c.setDrawingMethod(c.LONGWAY);
+      c.setLongwayTolerance(0.01);
+      c.setGarnishing(FALSE);
+      c.setFieldCaching(FALSE);
+      CConxRecordingCanvas one, many;
+      one.setModel(models[m]);
+      many.setModel(models[m]);
+      if (models[m] == CONX_POINCARE_UHP) {
+        one.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+        many.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+      }
+      many.setNumThreads(4);
+      RET1(many.getNumThreads() == 4);
+      c.drawOn(one);
+      c.drawOn(many);
+      OUT("LONGWAY drew " << one.numVertices() << " points of a "
+          << artists[a]->humanSAType(artists[a]->getSAType()) << " in the "
+          << conx_modelenum2string(models[m]) << "\n");
+      RET1(one.numVertices() > 0);
+      RET1(one.sameVertices(many));
+    }
+  }
+  return 0;
+}
+
+static int sameDefiningFunctions(const CConxSimpleArtist &a)
+// Returns zero if a.definingFunctions() gives exactly what
+// a.definingFunction() does everywhere on a grid in each model, including
+// on and outside of the boundary.
+{
+  const size_t n = 41;
+  double x[n], y[n], f[n];
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint scratch;
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    for (size_t j = 0; j < n; j++) {
+      for (size_t i = 0; i < n; i++) {
+        x[i] = -1.0 + 0.05 * (double) i;
+        y[i] = -1.0 + 0.05 * (double) j;
+      }
+      a.definingFunctions(x, y, n, models[m], f, scratch);
+      for (size_t i = 0; i < n; i++) {
+        double g = a.definingFunction(CConxPoint(x[i], y[i], models[m]));
+        RET1(f[i] == g || (f[i] != f[i] && g != g)); // NaN at a focus
+      }
+    }
+  }
+  return 0;
+}
+
+int tdefiningfunctions(void)
+// Returns zero if the batch versions of the defining functions agree
+// with the one-point-at-a-time versions.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  RET1(sameDefiningFunctions(f1) == 0);
+  RET1(sameDefiningFunctions(CConxCircle(f2, 0.8)) == 0);
+  RET1(sameDefiningFunctions(CConxHypEllipse(f1, f2, 2.0)) == 0);
+  RET1(sameDefiningFunctions(CConxHypEllipse(f1, f2, 0.1)) == 0);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  RET1(sameDefiningFunctions(CConxParabola(f1, L)) == 0);
+  return 0;
+}
+
+static int sameAsLongway(const CConxSimpleArtist &a)
+// Returns zero if drawing a by the QUADTREE method draws exactly what
+// drawing it by the LONGWAY method does in each model.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDwGeomObj lw(a), qt(a);
+    lw.setDrawingMethod(lw.LONGWAY);
+    qt.setDrawingMethod(qt.QUADTREE);
+    lw.setLongwayTolerance(0.01);
+    qt.setLongwayTolerance(0.01);
+    lw.setGarnishing(FALSE);
+    qt.setGarnishing(FALSE);
+    CConxRecordingCanvas one, other;
+    one.setModel(models[m]);
+    other.setModel(models[m]);
+    if (models[m] == CONX_POINCARE_UHP) {
+      one.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+      other.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+    }
+    lw.drawOn(one);
+    qt.drawOn(other);
+    OUT("QUADTREE drew " << other.numVertices() << " points in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    RET1(one.sameVertices(other));
+  }
+  return 0;
+}
+
+struct CountingMetric {
+  const CConxSimpleArtist *a;
+  CConxPoint *X;
+  ConxModlType modl;
+  size_t evaluations;
+};
+
+static void countingMetric(const double *x, const double *y, double *f,
+                           size_t n, void *t)
+{
+  CountingMetric *c = (CountingMetric *) t;
+  c->a->definingFunctions(x, y, n, c->modl, f, *c->X);
+  c->evaluations += n;
+}
+
+static void countingGradient(const double *x, const double *y, double *f,
+                             double *gx, double *gy, size_t n, void *t)
+{
+  CountingMetric *c = (CountingMetric *) t;
+  c->a->definingGradients(x, y, n, c->modl, f, gx, gy, *c->X);
+  c->evaluations += n;
+}
+
+int tquadtree(void)
+// Returns zero if the QUADTREE method draws what the LONGWAY method does
+// while evaluating defining functions much less often.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  RET1(sameAsLongway(f1) == 0);
+  RET1(sameAsLongway(CConxCircle(f1, 0.8)) == 0);
+  RET1(sameAsLongway(L) == 0);
+  RET1(sameAsLongway(CConxEqDistCurve(L, 0.3)) == 0);
+  RET1(sameAsLongway(CConxHypEllipse(f1, f2, 2.0)) == 0);
+  RET1(sameAsLongway(CConxHypEllipse(f1, f2, 0.1)) == 0);
+  RET1(sameAsLongway(CConxParabola(f1, L)) == 0);
+
+  CConxCircle c(f1, 0.8);
+  CConxPoint X;
+  CountingMetric lw, qt;
+  lw.a = qt.a = &c;
+  lw.X = qt.X = &X;
+  lw.modl = qt.modl = CONX_KLEIN_DISK;
+  lw.evaluations = qt.evaluations = 0;
+  ConxPtBuffer lwPts, qtPts;
+  conx_ptbuf_init(&lwPts);
+  conx_ptbuf_init(&qtPts);
+  conx_longway_batch(countingMetric, &lw, CONX_KLEIN_DISK, 0.01,
+                     0.004, 0.004, -1.0, 1.0, -1.0, 1.0,
+                     conx_ptbuf_append, &lwPts);
+  ConxLattice lattice;
+  conx_lattice_build(&lattice, CONX_KLEIN_DISK, 0.004, 0.004,
+                     -1.0, 1.0, -1.0, 1.0);
+  size_t n
+    = conx_longway_quadtree(countingMetric, &qt, c.getLipschitzConstant(),
+                            CONX_KLEIN_DISK, 0.01, &lattice,
+                            conx_ptbuf_append, &qtPts);
+  conx_lattice_free(&lattice);
+  OUT("LONGWAY evaluated " << lw.evaluations << " points, QUADTREE "
+      << qt.evaluations << "\n");
+  int same = (lwPts.n == qtPts.n);
+  for (size_t i = 0; same && i < lwPts.n; i++) {
+    same = (lwPts.pts[i].x == qtPts.pts[i].x
+            && lwPts.pts[i].y == qtPts.pts[i].y);
+  }
+  conx_ptbuf_free(&lwPts);
+  conx_ptbuf_free(&qtPts);
+  RET1(same);
+  RET1(n == qt.evaluations);
+  RET1(qt.evaluations * 4 < lw.evaluations);
+  return 0;
+}
+
+int tcontour(void)
+// Returns zero if the CONTOUR method draws a circle as one closed
+// LINE_STRIP that lies on the circle and has no step longer than a pixel's
+// diagonal, and draws a point, whose defining function is never negative,
+// just as the LONGWAY method does.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxCircle c(CConxPoint(0.1, 0.2, CONX_KLEIN_DISK), 0.8);
+    CConxDwGeomObj lw(c), ct(c);
+    lw.setDrawingMethod(lw.LONGWAY);
+    ct.setDrawingMethod(ct.CONTOUR);
+    lw.setLongwayTolerance(0.01);
+    lw.setGarnishing(FALSE);
+    ct.setGarnishing(FALSE);
+    CConxRecordingCanvas one, other;
+    one.setModel(models[m]);
+    other.setModel(models[m]);
+    if (models[m] == CONX_POINCARE_UHP) {
+      // Big enough to hold the whole circle
+      one.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+      other.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+    }
+    lw.drawOn(one);
+    ct.drawOn(other);
+    OUT("CONTOUR drew " << other.numVertices() << " vertices in "
+        << other.numStrips() << " strips in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    RET1(other.numStrips() == 1);
+    RET1(other.getStripStart(0) == 0);
+    RET1(other.numVertices() > 2);
+    Pt first = other.getVertex(0);
+    Pt last = other.getVertex(other.numVertices() - 1);
+    RET1(first.x == last.x && first.y == last.y);
+    double worst = 0.0;
+    double diagonal = sqrt(sqr(other.getPixelWidth())
+                           + sqr(other.getPixelHeight()));
+    for (size_t i = 0; i < other.numVertices(); i++) {
+      Pt v = other.getVertex(i);
+      double f = myabs(c.definingFunction(CConxPoint(v.x, v.y, models[m])));
+      if (f > worst) worst = f;
+      if (i > 0) {
+        Pt u = other.getVertex(i - 1);
+        RET1(sqrt(sqr(v.x - u.x) + sqr(v.y - u.y)) <= diagonal);
+      }
+    }
+    OUT("The farthest vertex is " << worst << " from the circle\n");
+    RET1(worst < 0.001);
+
+    CConxDwGeomObj plw(c.getCenter()), pct(c.getCenter());
+    plw.setDrawingMethod(plw.LONGWAY);
+    pct.setDrawingMethod(pct.CONTOUR);
+    plw.setGarnishing(FALSE);
+    pct.setGarnishing(FALSE);
+    one.clear();
+    other.clear();
+    plw.drawOn(one);
+    pct.drawOn(other);
+    RET1(other.numStrips() == 0);
+    RET1(one.sameVertices(other));
+  }
+  return 0;
+}
+
+struct WindowMetric {
+  double x_min, x_max, y_min, y_max;
+  size_t evaluations, strays;
+};
+
+static void windowMetric(const double *x, const double *y, double *f,
+                         size_t n, void *t)
+// Counts the points outside of the window or the closed unit disk.
+{
+  WindowMetric *w = (WindowMetric *) t;
+  for (size_t i = 0; i < n; i++) {
+    if (x[i] < w->x_min || x[i] > w->x_max || y[i] < w->y_min
+        || y[i] > w->y_max || sqr(x[i]) + sqr(y[i]) > 1.0 + 1e-12)
+      ++w->strays;
+    f[i] = 1.0;
+  }
+  w->evaluations += n;
+}
+
+static size_t zoomedEvaluations(double x_min, double x_max,
+                                double y_min, double y_max)
+// Returns the number of points the LONGWAY method visits in the Klein disk
+// for the given viz area, or zero if it visits points outside of it.
+{
+  WindowMetric w;
+  w.x_min = x_min; w.x_max = x_max; w.y_min = y_min; w.y_max = y_max;
+  w.evaluations = w.strays = 0;
+  ConxPtBuffer pts;
+  conx_ptbuf_init(&pts);
+  conx_longway_batch(windowMetric, &w, CONX_KLEIN_DISK, 0.01, 0.002, 0.002,
+                     x_min, x_max, y_min, y_max, conx_ptbuf_append, &pts);
+  conx_ptbuf_free(&pts);
+  OUT("LONGWAY visited " << w.evaluations << " points of [" << x_min << ", "
+      << x_max << "]x[" << y_min << ", " << y_max << "] and "
+      << w.strays << " others\n");
+  return (w.strays == 0) ? w.evaluations : 0;
+}
+
+int tzoom(void)
+// Returns zero if the LONGWAY method visits only the points of the viz area
+// that are in the disk, so that zooming in means less work.
+{
+  size_t whole = zoomedEvaluations(-1.03, 1.03, -1.03, 1.03);
+  RET1(whole > 0);
+  size_t part = zoomedEvaluations(0.7, 0.8, 0.5, 0.7);
+  RET1(part > 0);
+  RET1(part <= 51 * 101);
+  RET1(part * 100 < whole);
+  RET1(zoomedEvaluations(0.1, 0.2, 0.97, 1.2) > 0);
+  WindowMetric w;
+  w.x_min = w.y_min = 1.1; w.x_max = w.y_max = 1.2;
+  w.evaluations = w.strays = 0;
+  conx_longway_batch(windowMetric, &w, CONX_KLEIN_DISK, 0.01, 0.002, 0.002,
+                     1.1, 1.2, 1.1, 1.2, NULL, NULL);
+  RET1(w.evaluations == 0);
+  return 0;
+}
+
+static int sameWithRaster(CConxRecordingCanvas &cached,
+                          const CConxSimpleArtist &a, double lwtol)
+// Returns zero if drawing a by the LONGWAY method on cached, whose field
+// rasters we want to use, draws what drawing it without a raster does.
+{
+  CConxDwGeomObj withRaster(a), without(a);
+  withRaster.setDrawingMethod(withRaster.LONGWAY);
+  without.setDrawingMethod(without.LONGWAY);
+  withRaster.setLongwayTolerance(lwtol);
+  without.setLongwayTolerance(lwtol);
+  withRaster.setGarnishing(FALSE);
+  without.setGarnishing(FALSE);
+  without.setFieldCaching(FALSE);
+  CConxRecordingCanvas plain;
+  plain.setModel(cached.getModel());
+  plain.setViewingRectangle(cached.getXmin(), cached.getXmax(),
+                            cached.getYmin(), cached.getYmax());
+  cached.clear();
+  withRaster.drawOn(cached);
+  without.drawOn(plain);
+  RET1(cached.numVertices() > 0);
+  RET1(cached.sameVertices(plain));
+  return 0;
+}
+
+int tfieldraster(void)
+// Returns zero if changing an artist's scalar or tolerance redraws it from
+// the canvas's raster of its field, and if the drawing is just what the
+// LONGWAY method draws.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+    CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+    CConxRecordingCanvas cached;
+    cached.setModel(models[m]);
+    cached.setNumThreads(4);
+    if (models[m] == CONX_POINCARE_UHP)
+      cached.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+
+    RET1(!cached.hasFieldRaster(CConxCircle(f1, 0.8)));
+    RET1(sameWithRaster(cached, CConxCircle(f1, 0.8), 0.01) == 0);
+    RET1(cached.hasFieldRaster(CConxCircle(f1, 0.5)));
+    RET1(sameWithRaster(cached, CConxCircle(f1, 0.5), 0.02) == 0);
+    RET1(!cached.hasFieldRaster(CConxCircle(f2, 0.5)));
+
+    RET1(sameWithRaster(cached, CConxEqDistCurve(L, 0.3), 0.01) == 0);
+    RET1(cached.hasFieldRaster(CConxEqDistCurve(L, 0.4)));
+    RET1(sameWithRaster(cached, CConxEqDistCurve(L, 0.4), 0.01) == 0);
+
+    RET1(sameWithRaster(cached, CConxHypEllipse(f1, f2, 2.0), 0.01) == 0);
+    RET1(cached.hasFieldRaster(CConxHypEllipse(f1, f2, 1.5)));
+    RET1(sameWithRaster(cached, CConxHypEllipse(f1, f2, 1.5), 0.01) == 0);
+    // A hyperbola with the same foci has another field.
+    RET1(!cached.hasFieldRaster(CConxHypEllipse(f1, f2, 0.1)));
+    RET1(sameWithRaster(cached, CConxHypEllipse(f1, f2, 0.1), 0.01) == 0);
+
+    // Moving the viz area means sampling again.
+    cached.setViewingRectangle(cached.getXmin() / 2, cached.getXmax() / 2,
+                               cached.getYmin() / 2, cached.getYmax() / 2);
+    RET1(!cached.hasFieldRaster(CConxCircle(f1, 0.5)));
+    RET1(sameWithRaster(cached, CConxCircle(f1, 0.5), 0.01) == 0);
+  }
+  return 0;
+}
+
+
+int tatlas(void)
+// Returns zero if a canvas's atlas holds the Klein coordinates of the
+// LONGWAY method's points, follows the viz area and model, and lets the
+// LONGWAY method draw what it would without the atlas.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDumbCanvas cv;
+    if (models[m] == CONX_POINCARE_UHP)
+      cv.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+    const ConxLattice *A = &cv.getAtlas(models[m]);
+    RET1(conx_lattice_size(A) > 0);
+    RET1(A->kx != NULL && A->ky != NULL);
+    for (size_t i = 0; i < A->ncols; i += 7) {
+      for (size_t k = A->start[i]; k < A->start[i] + A->count[i]; k += 5) {
+        Pt P = CConxPoint(A->xs[i], A->ys[k], models[m])
+          .getPt(CONX_KLEIN_DISK);
+        RET1(myequals(P.x, A->kx[k], 1e-12));
+        RET1(myequals(P.y, A->ky[k], 1e-12));
+      }
+    }
+    RET1(cv.getAtlas(models[m]).ys == A->ys); // Not built again.
+    double x0 = A->xs[0];
+    cv.setViewingRectangle(cv.getXmin() / 2, cv.getXmax() / 2,
+                           cv.getYmin() / 2, cv.getYmax() / 2);
+    A = &cv.getAtlas(models[m]);
+    RET1(A->xs[0] != x0);
+    RET1(myequals(A->xs[0], cv.getXmin(), cv.getPixelWidth()));
+    size_t before = conx_lattice_size(A);
+    cv.setSize(cv.getWidth() / 2, cv.getHeight() / 2);
+    RET1(conx_lattice_size(&cv.getAtlas(models[m])) * 3 < before);
+  }
+
+  CConxDumbCanvas cv;
+  RET1(cv.getAtlas(CONX_KLEIN_DISK).kx[0]
+       != cv.getAtlas(CONX_POINCARE_DISK).kx[0]);
+
+  // The LONGWAY method, which uses the atlas, draws the points that
+  // conx_longway_batch finds in the model's own coordinates.
+  CConxCircle c(CConxPoint(0.1, 0.2, CONX_KLEIN_DISK), 0.8);
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDwGeomObj d(c);
+    d.setDrawingMethod(d.LONGWAY);
+    d.setLongwayTolerance(0.01);
+    d.setGarnishing(FALSE);
+    d.setFieldCaching(FALSE);
+    CConxRecordingCanvas rc;
+    rc.setModel(models[m]);
+    d.drawOn(rc);
+    CConxPoint X;
+    CountingMetric cm;
+    cm.a = &c;
+    cm.X = &X;
+    cm.modl = models[m];
+    cm.evaluations = 0;
+    ConxPtBuffer pts;
+    conx_ptbuf_init(&pts);
+    conx_longway_batch(countingMetric, &cm, models[m], 0.01,
+                       rc.getPixelWidth(), rc.getPixelHeight(),
+                       rc.getXmin(), rc.getXmax(), rc.getYmin(), rc.getYmax(),
+                       conx_ptbuf_append, &pts);
+    OUT("LONGWAY drew " << rc.numVertices() << " points from the atlas and "
+        << pts.n << " without it in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    int same = (rc.numVertices() == pts.n);
+    for (size_t i = 0; same && i < pts.n; i++) {
+      same = (rc.getVertex(i).x == pts.pts[i].x
+              && rc.getVertex(i).y == pts.pts[i].y);
+    }
+    conx_ptbuf_free(&pts);
+    RET1(rc.numVertices() > 0);
+    RET1(same);
+  }
+  return 0;
+}
+
+
+static void appendLongway(CConxCanvas &cv, const CConxSimpleArtist &a,
+                          double lwtol, Boole caching)
+{
+  CConxDwGeomObj d(a);
+  d.setDrawingMethod(d.LONGWAY);
+  d.setLongwayTolerance(lwtol);
+  d.setFieldCaching(caching);
+  cv.append(&d);
+}
+
+int tfused(void)
+// Returns zero if drawing a canvas's LONGWAY artists in one sweep draws
+// what drawing them one by one does, in the same order.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    for (uint nthreads = 1; nthreads <= 4; nthreads += 3) {
+      CConxRecordingCanvas fused, plain;
+      CConxCanvas *both[2] = { &fused, &plain };
+      for (int k = 0; k < 2; k++) {
+        appendLongway(*both[k], CConxCircle(f1, 0.8), 0.01, FALSE);
+        appendLongway(*both[k], L, 0.01, FALSE);
+        // This one is drawn from a raster rather than fused.
+        appendLongway(*both[k], CConxCircle(f2, 0.5), 0.02, TRUE);
+        appendLongway(*both[k], CConxParabola(f1, L), 0.02, FALSE);
+        appendLongway(*both[k], f2, 0.01, FALSE);
+      }
+      RET1(plain.getLongwayFusing());
+      plain.setLongwayFusing(FALSE);
+      fused.setModel(models[m]);
+      plain.setModel(models[m]);
+      if (models[m] == CONX_POINCARE_UHP) {
+        fused.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+        plain.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+      }
+      fused.setNumThreads(nthreads);
+      fused.masterDraw();
+      plain.masterDraw();
+      OUT("The fused sweep drew " << fused.numVertices() << " points in the "
+          << conx_modelenum2string(models[m]) << "\n");
+      RET1(fused.numVertices() > 0);
+      RET1(fused.sameVertices(plain));
+    }
+  }
+  return 0;
+}
+
+
+static size_t pixelDifferences(const CConxRecordingCanvas &a,
+                               const CConxRecordingCanvas &b)
+// Returns the number of vertices that only one of a and b has.  Both
+// were drawn by the LONGWAY method, so each has its vertices in order.
+{
+  size_t i = 0, j = 0, diff = 0;
+  while (i < a.numVertices() && j < b.numVertices()) {
+    Pt p = a.getVertex(i), q = b.getVertex(j);
+    if (p.x == q.x && p.y == q.y) {
+      ++i; ++j;
+    } else if (p.x < q.x || (p.x == q.x && p.y < q.y)) {
+      ++i; ++diff;
+    } else {
+      ++j; ++diff;
+    }
+  }
+  return diff + (a.numVertices() - i) + (b.numVertices() - j);
+}
+
+static int fastAgrees(const CConxSimpleArtist &a, ConxModlType modl,
+                      double lwtol, ConxPrecision tier = CONX_FAST,
+                      uint nthreads = 1)
+// Returns zero if drawing a with CONX_FAST lights nearly the pixels that
+// CONX_PRECISE does, or if drawing it with CONX_COMPARE lights exactly
+// those pixels.
+{
+  CConxDwGeomObj precise(a), fast(a);
+  precise.setDrawingMethod(precise.LONGWAY);
+  fast.setDrawingMethod(fast.LONGWAY);
+  precise.setLongwayTolerance(lwtol);
+  fast.setLongwayTolerance(lwtol);
+  precise.setGarnishing(FALSE);
+  fast.setGarnishing(FALSE);
+  precise.setFieldCaching(FALSE);
+  fast.setFieldCaching(FALSE);
+  fast.setPrecision(tier);
+  RET1(precise != fast);
+  CConxRecordingCanvas pc, fc;
+  pc.setModel(modl);
+  fc.setModel(modl);
+  fc.setNumThreads(nthreads);
+  if (modl == CONX_POINCARE_UHP) {
+    pc.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+    fc.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
+  }
+  clock_t t0 = clock();
+  precise.drawOn(pc);
+  clock_t t1 = clock();
+  fast.drawOn(fc);
+  clock_t t2 = clock();
+  size_t diff = pixelDifferences(pc, fc);
+  OUT(CConxSimpleArtist::humanSAType(a.getSAType()) << " in the "
+      << conx_modelenum2string(modl) << ": " << diff << " of "
+      << pc.numVertices() << " pixels differ; " << (t1 - t0)
+      << " ticks precise, " << (t2 - t1)
+      << ((tier == CONX_FAST) ? " fast\n" : " comparing\n"));
+  RET1(pc.numVertices() > 0);
+  if (tier == CONX_COMPARE) RET1(diff == 0);
+  RET1(diff * 100 <= pc.numVertices());
+  return 0;
+}
+
+int tfast(void)
+// Returns zero if single-precision evaluation lights all but a few of the
+// pixels that double precision does, and if it keeps rasters of floats.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    RET1(fastAgrees(f1, models[m], 0.01) == 0);
+    RET1(fastAgrees(CConxCircle(f1, 0.8), models[m], 0.01) == 0);
+    RET1(fastAgrees(CConxCircle(f2, 3.0), models[m], 0.05) == 0);
+    RET1(fastAgrees(CConxHypEllipse(f1, f2, 2.0), models[m], 0.01) == 0);
+    RET1(fastAgrees(CConxHypEllipse(f1, f2, 0.1), models[m], 0.01) == 0);
+  }
+
+  // Near the boundary, the fast distances are the precise ones.
+  const size_t n = 5;
+  double xx[n] = { 0.9995, 0.0, -0.7071, 0.3, 0.1 };
+  double yy[n] = { 0.0, -0.9999, 0.7071, 0.4, 0.2 };
+  double d[n], df[n];
+  conxk_dist_batch(0.1, 0.2, xx, yy, d, n);
+  conxk_dist_batchf(0.1, 0.2, xx, yy, df, n);
+  for (size_t i = 0; i < 3; i++) RET1(d[i] == df[i]);
+  RET1(myequals(d[3], df[3], 1e-5));
+  RET1(d[4] == df[4]); // at the point itself
+  float ff[n];
+  conxk_dist_batchff(0.1, 0.2, xx, yy, ff, n);
+  for (size_t i = 0; i < n; i++) RET1(ff[i] == (float) df[i]);
+
+  CConxRecordingCanvas cv;
+  CConxCircle c(f1, 0.8);
+  const CConxCanvas::FieldRaster &r = cv.getFieldRaster(c, CONX_FAST);
+  RET1(r.g == NULL && r.gf != NULL);
+  RET1(!cv.hasFieldRaster(c));
+  RET1(cv.hasFieldRaster(c, CONX_FAST));
+  RET1(cv.getFieldRaster(c).g != NULL);
+
+  // The floats sampled straight into a raster are the fast doubles, rounded.
+  CConxHypEllipse h(f1, f2, 0.1);
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    cv.setModel(models[m]);
+    const CConxSimpleArtist *as[2] = { &c, &h };
+    for (int a = 0; a < 2; a++) {
+      const float *gf = cv.getFieldRaster(*as[a], CONX_FAST).gf;
+      const double *g = cv.getFieldRaster(*as[a]).g;
+      size_t npts = conx_lattice_size(&cv.getAtlas(models[m]));
+      RET1(npts > 0);
+      for (size_t i = 0; i < npts; i++) {
+        if (g[i] >= CCONX_INFINITY) RET1(gf[i] >= (float) CCONX_INFINITY);
+        else RET1(myequals(gf[i], g[i], 1e-5 * (1.0 + g[i])));
+      }
+    }
+  }
+
+  // Curves are drawn at the precision asked for, however they are drawn.
+  CConxDwGeomObj::DrawingMethod methods[2] = {
+    CConxDwGeomObj::BRESENHAM, CConxDwGeomObj::TRACER
+  };
+  CConxPoint f3(-0.3, 0.4, CONX_POINCARE_DISK);
+  for (int k = 0; k < 2; k++) {
+    CConxDwGeomObj d(CConxHypEllipse(f1, f3, 2.0));
+    d.setDrawingMethod(methods[k]);
+    d.setPrecision(CONX_FAST);
+    CConxRecordingCanvas pc;
+    pc.setModel(CONX_KLEIN_DISK);
+    d.drawOn(pc);
+    RET1(pc.numBresenhams() + pc.numStrips() > 0);
+    RET1(pc.getDrawnPrecision() == CONX_FAST);
+    RET1(pc.getMetricPrecision() == CONX_PRECISE);
+  }
+  return 0;
+}
+
+int tcompare(void)
+// Returns zero if comparing cosh-distances lights the pixels that
+// computing distances does, and if the clamped distances are the precise
+// ones clamped.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    for (uint t = 1; t <= 2; t++) {
+      RET1(fastAgrees(f1, models[m], 0.01, CONX_COMPARE, t) == 0);
+      RET1(fastAgrees(CConxCircle(f1, 0.8), models[m], 0.01, CONX_COMPARE,
+                      t) == 0);
+      RET1(fastAgrees(CConxCircle(f2, 3.0), models[m], 0.05, CONX_COMPARE,
+                      t) == 0);
+      RET1(fastAgrees(CConxHypEllipse(f1, f2, 2.0), models[m], 0.01,
+                      CONX_COMPARE, t) == 0);
+      RET1(fastAgrees(CConxHypEllipse(f1, f2, 0.1), models[m], 0.01,
+                      CONX_COMPARE, t) == 0);
+    }
+  }
+
+  const size_t n = 6;
+  double xx[n] = { 0.9995, 0.0, -0.7071, 0.3, 0.1, 0.1000001 };
+  double yy[n] = { 0.0, -0.9999, 0.7071, 0.4, 0.2, 0.2 };
+  double d[n], dc[n], X[n], Y[n], T[n], a[3];
+  double lo = 0.5, hi = 2.0;
+  RET1(f1.getHyperboloid(a));
+  conxhm_toh_batch(CONX_KLEIN_DISK, xx, yy, X, Y, T, n);
+  conxh_dist_batch(a, X, Y, T, d, n);
+  conxh_dist_clamp_batch(a, X, Y, T, dc, n, lo, hi);
+  for (size_t i = 0; i < n; i++) {
+    RET1(dc[i] == ((d[i] < lo) ? lo : ((d[i] > hi) ? hi : d[i])));
+  }
+  conxh_dist_clamp_batch(a, X, Y, T, dc, n, -1.0, CCONX_INFINITY);
+  for (size_t i = 0; i < n; i++) RET1(dc[i] == d[i]);
+
+  // Inside the band, a circle's threshold function is its defining
+  // function; outside, it is just past the tolerance.
+  CConxCircle c(f1, 0.8);
+  CConxPoint Q;
+  double f;
+  c.thresholdFunctions(xx + 3, yy + 3, 1, CONX_KLEIN_DISK, 0.01, &f, Q);
+  RET1(myequals(f, -0.01, 1e-12));
+  c.thresholdFunctions(xx + 3, yy + 3, 1, CONX_KLEIN_DISK, 1.0, &f, Q);
+  RET1(f == c.definingFunction(CConxPoint(xx[3], yy[3], CONX_KLEIN_DISK)));
+  return 0;
+}
+
+
+int tprogressive(void)
+// Returns zero if progressive drawing draws a coarse scene first, refines
+// it one pass per call to what drawing it all at once draws, skips the
+// passes that the time of the last pass says it can afford to, and starts
+// over when the scene changes.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxRecordingCanvas prog, whole;
+  CConxCanvas *both[2] = { &prog, &whole };
+  for (int k = 0; k < 2; k++) {
+    appendLongway(*both[k], CConxCircle(f1, 0.8), 0.01, FALSE);
+    appendLongway(*both[k], CConxParabola(f1, L), 0.02, FALSE);
+  }
+  whole.masterDraw();
+  RET1(!whole.needsRefinement());
+  RET1(whole.getCoarseness() == 1);
+
+  // With no time to spare, each call draws one pass.
+  prog.setFrameBudget(1e-9);
+  RET1(prog.needsRefinement());
+  size_t passes = 0, last = 0;
+  while (prog.needsRefinement()) {
+    prog.masterDraw();
+    ++passes;
+    OUT("Pass " << passes << " at coarseness " << prog.getCoarseness()
+        << " drew " << prog.numVertices() << " points\n");
+    RET1(prog.numVertices() > 0);
+    RET1(passes == 1 || prog.numVertices() > last);
+    last = prog.numVertices();
+    RET1(passes <= 4);
+  }
+  RET1(passes == 4);
+  RET1(prog.getCoarseness() == 1);
+  RET1(prog.sameVertices(whole));
+
+  // Drawing again redraws the finished scene.
+  prog.masterDraw();
+  RET1(!prog.needsRefinement());
+  RET1(prog.sameVertices(whole));
+
+  // A change abandons the old passes.
+  prog.setViewingRectangle(-0.5, 0.5, -0.5, 0.5);
+  RET1(prog.needsRefinement());
+  prog.masterDraw();
+  RET1(prog.getCoarseness() == CCONX_COARSEST);
+  appendLongway(prog, f2, 0.01, FALSE);
+  RET1(prog.needsRefinement());
+
+  // With plenty of time, a timed pass lets the next go to full detail,
+  // but one call still draws only one pass.
+  prog.setFrameBudget(1e6);
+  RET1(prog.needsRefinement());
+  prog.masterDraw();
+  RET1(!prog.needsRefinement());
+  RET1(prog.getCoarseness() == 1);
+  CConxRecordingCanvas fresh;
+  appendLongway(fresh, CConxCircle(f1, 0.8), 0.01, FALSE);
+  fresh.setFrameBudget(1e6);
+  fresh.masterDraw();
+  RET1(fresh.getCoarseness() == CCONX_COARSEST);
+  RET1(fresh.needsRefinement());
+  fresh.masterDraw();
+  RET1(fresh.getCoarseness() == 1);
+  RET1(!fresh.needsRefinement());
+  return 0;
+}
+
+
+static double pixelsOff(const CConxSimpleArtist &a, const CConxCanvas &cv,
+                        Pt v)
+// Returns roughly how many pixels v is from the zero set of a's defining
+// function, by a first-order estimate.
+{
+  double e = 1e-4 * cv.getPixelWidth(), f, fx, fy;
+  ConxModlType modl = cv.getModel();
+  f = a.definingFunction(CConxPoint(v.x, v.y, modl));
+  fx = (a.definingFunction(CConxPoint(v.x + e, v.y, modl)) - f) / e;
+  fy = (a.definingFunction(CConxPoint(v.x, v.y + e, modl)) - f) / e;
+  return myabs(f) / sqrt(sqr(fx) + sqr(fy)) / cv.getPixelWidth();
+}
+
+static int tracesNear(const CConxSimpleArtist &a)
+// Returns zero if drawing a by the TRACER method draws LINE_STRIPs whose
+// vertices lie on a in each model.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDwGeomObj tr(a);
+    tr.setDrawingMethod(tr.TRACER);
+    tr.setGarnishing(FALSE);
+    CConxRecordingCanvas cv;
+    cv.setModel(models[m]);
+    if (models[m] == CONX_POINCARE_UHP)
+      cv.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+    tr.drawOn(cv);
+    RET1(!cv.getCurveTracing());
+    OUT("TRACER drew " << cv.numVertices() << " vertices in "
+        << cv.numStrips() << " strips in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    RET1(cv.numStrips() >= 1);
+    RET1(cv.numVertices() > 2 * cv.numStrips());
+    double worst = 0.0;
+    for (size_t i = 0; i < cv.numVertices(); i++) {
+      Pt v = cv.getVertex(i);
+      if (models[m] != CONX_POINCARE_UHP
+          && sqr(v.x) + sqr(v.y) > sqr(0.95)) continue; // steep there
+      worst = greater(worst, pixelsOff(a, cv, v));
+    }
+    OUT("The worst vertex is " << worst << " pixels off\n");
+    RET1(worst < 0.05);
+  }
+  return 0;
+}
+
+struct TracerCount {
+  ConxPtBuffer pixels;
+};
+
+static int tracerKeepGoing(Pt middle, Pt oldmiddle, void *t)
+{
+  return (sqr(middle.x) + sqr(middle.y) < 1.0
+          && (myabs(middle.x - oldmiddle.x) + myabs(middle.y - oldmiddle.y)
+              > ARBITRARILYSMALL));
+}
+
+static void tracerBresTrace(Pt middle, ConxDirection last,
+                            double dw, double dh,
+                            ConxBatchMetric *func, void *fArg,
+                            ConxBresMemo *memo,
+                            ConxContinueFunc *keepgoing, void *kArg)
+{
+  conx_bres_trace_batch(middle, last, dw, dh, func, fArg, memo,
+                        keepgoing, kArg, conx_ptbuf_append,
+                        &((TracerCount *) kArg)->pixels);
+}
+
+static void tracerLength(const Pt *pts, size_t n, void *t)
+{
+  for (size_t i = 1; i < n; i++)
+    *(double *) t += sqrt(sqr(pts[i].x - pts[i - 1].x)
+                          + sqr(pts[i].y - pts[i - 1].y));
+}
+
+static int comparePixels(const void *a, const void *b)
+{
+  const long *p = (const long *) a, *q = (const long *) b;
+  return (p[0] != q[0]) ? ((p[0] < q[0]) ? -1 : 1)
+    : ((p[1] < q[1]) ? -1 : (p[1] > q[1]));
+}
+
+static size_t distinctPixels(const ConxPtBuffer &b, double pixel)
+// Returns the number of different pixels among b's points.
+{
+  if (b.n == 0) return 0;
+  long *p = new long[2 * b.n];
+  for (size_t i = 0; i < b.n; i++) {
+    p[2 * i] = (long) floor(b.pts[i].x / pixel + 0.5);
+    p[2 * i + 1] = (long) floor(b.pts[i].y / pixel + 0.5);
+  }
+  qsort(p, b.n, 2 * sizeof(long), comparePixels);
+  size_t distinct = 1;
+  for (size_t i = 1; i < b.n; i++)
+    if (comparePixels(&p[2 * i], &p[2 * (i - 1)]) != 0) ++distinct;
+  delete [] p;
+  return distinct;
+}
+
+int ttracer(void)
+// Returns zero if the TRACER method draws hypellipses, parabolas, and
+// equidistant curves along the curves and evaluates their defining
+// functions far less often per pixel than the Bresenham method does.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  RET1(tracesNear(CConxHypEllipse(f1, f2, 2.0)) == 0);
+  RET1(tracesNear(CConxHypEllipse(f1, f2, 0.1)) == 0);
+  RET1(tracesNear(CConxParabola(f1, L)) == 0);
+  RET1(tracesNear(CConxEqDistCurve(L, 0.5)) == 0);
+
+  CConxHypEllipse e(f1, f2, 2.0);
+  CConxPoint lb, rb, X;
+  e.getPointsOn(&lb, &rb);
+  CountingMetric bres, trace;
+  bres.a = trace.a = &e;
+  bres.X = trace.X = &X;
+  bres.modl = trace.modl = CONX_KLEIN_DISK;
+  bres.evaluations = trace.evaluations = 0;
+  double pixel = 2.0 / 400, length = 0.0;
+  TracerCount tc;
+  conx_ptbuf_init(&tc.pixels);
+  conx_bresenham_batch(lb.getPt(CONX_KLEIN_DISK), rb.getPt(CONX_KLEIN_DISK),
+                       countingMetric, &bres, pixel, pixel,
+                       tracerKeepGoing, &tc, tracerBresTrace, NULL);
+  size_t n = conx_trace(lb.getPt(CONX_KLEIN_DISK), rb.getPt(CONX_KLEIN_DISK),
+                        countingGradient, &trace, pixel, pixel,
+                        tracerKeepGoing, NULL, tracerLength, &length);
+  RET1(n == trace.evaluations);
+  size_t distinct = distinctPixels(tc.pixels, pixel);
+  conx_ptbuf_free(&tc.pixels);
+  // Each goes around this ellipse once.
+  double perBres = (double) bres.evaluations / distinct;
+  double perTrace = trace.evaluations / (length / pixel);
+  OUT("Bresenham evaluated " << bres.evaluations << " times for "
+      << distinct << " pixels; TRACER evaluated " << trace.evaluations
+      << " times for " << length / pixel << " pixels of curve\n");
+  RET1(length / pixel > distinct);
+  RET1(perTrace < perBres / 2);
+  return 0;
+}
+
+
+static int sameGradients(const CConxSimpleArtist &a)
+// Returns zero if a.definingGradients() gives what a.definingFunction()
+// does, and the gradient that central differences of it give, wherever on
+// a grid inside each model a's defining function is smooth.
+{
+  const size_t n = 19;
+  const double h = 1e-6;
+  double x[n], y[n], f[n], gx[n], gy[n];
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint scratch;
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    size_t compared = 0, total = 0;
+    for (size_t j = 0; j < n; j++) {
+      for (size_t i = 0; i < n; i++) {
+        x[i] = -0.9 + 0.1 * (double) i;
+        y[i] = (models[m] == CONX_POINCARE_UHP)
+          ? 0.1 + 0.1 * (double) j : -0.9 + 0.1 * (double) j;
+      }
+      a.definingGradients(x, y, n, models[m], f, gx, gy, scratch);
+      for (size_t i = 0; i < n; i++) {
+        if (models[m] != CONX_POINCARE_UHP
+            && sqr(x[i]) + sqr(y[i]) > sqr(0.9)) continue;
+        ++total;
+        double c = a.definingFunction(CConxPoint(x[i], y[i], models[m]));
+        RET1(myabs(f[i] - c) < 1e-6 * (1.0 + myabs(c)));
+        double d[2], g[2] = { gx[i], gy[i] };
+        Boole smooth = TRUE;
+        for (int k = 0; k < 2; k++) {
+          double dx = (k == 0) ? h : 0.0, dy = (k == 0) ? 0.0 : h;
+          double fp = a.definingFunction(CConxPoint(x[i] + dx, y[i] + dy,
+                                                    models[m]));
+          double fm = a.definingFunction(CConxPoint(x[i] - dx, y[i] - dy,
+                                                    models[m]));
+          // Skip kinks, e.g. at a focus or on a line.
+          if (myabs(fp - 2.0 * c + fm) > 1e-4 * h) smooth = FALSE;
+          d[k] = (fp - fm) / (2.0 * h);
+        }
+        if (!smooth) continue;
+        ++compared;
+        for (int k = 0; k < 2; k++)
+          RET1(myabs(g[k] - d[k]) < 1e-4 * (1.0 + myabs(d[k])));
+      }
+    }
+    OUT(a.humanSAType(a.getSAType()) << ": compared gradients at "
+        << compared << " of " << total << " points in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    RET1(compared > total / 2);
+  }
+  return 0;
+}
+
+int tgradients(void)
+// Returns zero if the closed-form gradients of the defining functions
+// agree with numerical ones.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  RET1(sameGradients(f1) == 0);
+  RET1(sameGradients(L) == 0);
+  RET1(sameGradients(CConxCircle(f2, 0.8)) == 0);
+  RET1(sameGradients(CConxHypEllipse(f1, f2, 2.0)) == 0);
+  RET1(sameGradients(CConxHypEllipse(f1, f2, 0.1)) == 0);
+  RET1(sameGradients(CConxParabola(f1, L)) == 0);
+  RET1(sameGradients(CConxEqDistCurve(L, 0.5)) == 0);
+  CConxLine V(CConxPoint(0.3, 0.5, CONX_KLEIN_DISK),
+              CConxPoint(0.3, -0.5, CONX_KLEIN_DISK));
+  RET1(sameGradients(V) == 0);
+  RET1(sameGradients(CConxEqDistCurve(V, 0.3)) == 0);
+  return 0;
+}
+
+
+// What memoCountingTrace needs to count the points the Bresenham method
+// asks about.
+struct MemoCount {
+  ConxBatchMetric *func;
+  void *fArg;
+  size_t requested;
+  ConxPtBuffer pixels;
+};
+
+static void memoRequests(const double *x, const double *y, double *f,
+                         size_t n, void *t)
+{
+  MemoCount *c = (MemoCount *) t;
+  c->requested += n;
+  (*c->func)(x, y, f, n, c->fArg);
+}
+
+static void memoCountingTrace(Pt middle, ConxDirection last,
+                              double dw, double dh,
+                              ConxBatchMetric *func, void *fArg,
+                              ConxBresMemo *memo,
+                              ConxContinueFunc *keepgoing, void *kArg)
+{
+  MemoCount *c = (MemoCount *) kArg;
+  c->func = func;
+  c->fArg = fArg;
+  conx_bres_trace_batch(middle, last, dw, dh, memoRequests, c, NULL,
+                        keepgoing, kArg, conx_ptbuf_append, &c->pixels);
+}
+
+static int memoizes(const CConxSimpleArtist &a, const CConxPoint &lb,
+                    const CConxPoint &rb, size_t *evaluations,
+                    size_t *requested)
+// Returns zero if the Bresenham method's memo accounts for every point it
+// is asked about in tracing a in the Klein disk.
+{
+  CConxPoint X;
+  CountingMetric metric;
+  metric.a = &a;
+  metric.X = &X;
+  metric.modl = CONX_KLEIN_DISK;
+  metric.evaluations = 0;
+  MemoCount c;
+  c.requested = 0;
+  conx_ptbuf_init(&c.pixels);
+  double pixel = 2.0 / 400;
+  Pt LB = lb.getPt(CONX_KLEIN_DISK), RB = rb.getPt(CONX_KLEIN_DISK);
+  ConxBresStats stats;
+  conx_bresenham_batch(LB, RB, countingMetric, &metric, pixel, pixel,
+                       tracerKeepGoing, &c, memoCountingTrace, &stats);
+  size_t hits = stats.hits;
+  size_t branches = (LB.x == RB.x && LB.y == RB.y) ? 1 : 2;
+  OUT(a.humanSAType(a.getSAType()) << ": the memo answered " << hits
+      << " of " << c.requested + NUM_DIRECS * branches << " requests for "
+      << c.pixels.n << " pixels\n");
+  conx_ptbuf_free(&c.pixels);
+  // conx_startpoint asks about the eight neighbors of each start point.
+  RET1(metric.evaluations + hits == c.requested + NUM_DIRECS * branches);
+  RET1(hits > 0);
+  *evaluations = metric.evaluations;
+  *requested = c.requested + NUM_DIRECS * branches;
+  return 0;
+}
+
+int tbresmemo(void)
+// Returns zero if the Bresenham method evaluates the metric at each
+// lattice point at most once per branch.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxPoint lb, rb;
+  size_t evaluations, requested;
+
+  // memoCountingTrace keeps the memo from conx_bres_trace_batch, which
+  // therefore cannot see where a closed curve closes up and traces it all
+  // the way around twice, so the memo should answer about half of the
+  // requests.
+  CConxHypEllipse e(f1, f2, 2.0);
+  e.getPointsOn(&lb, &rb);
+  RET1(memoizes(e, lb, rb, &evaluations, &requested) == 0);
+  RET1(3 * evaluations < 2 * requested);
+
+  CConxParabola p(f1, L);
+  RET1(p.getPointOn(&lb) == 0);
+  RET1(memoizes(p, lb, lb, &evaluations, &requested) == 0);
+  return 0;
+}
+
+
+static int sameThreadedPixels(const CConxSimpleArtist &a, const CConxPoint &lb,
+                              const CConxPoint &rb, Boole closed)
+// Returns zero if tracing a in the Klein disk with several threads draws
+// exactly the pixels, in exactly the order, that tracing it with one
+// does, draws no pixel twice, and evaluates the metric less than twice as
+// often as tracing it with none does.  If a is open, tracing it with none
+// must draw exactly the same pixels too; if a is closed, where the
+// directions meet may differ by a pixel or two.
+{
+  const size_t nthreads = 4;
+  double pixel = 2.0 / 400;
+  Pt LB = lb.getPt(CONX_KLEIN_DISK), RB = rb.getPt(CONX_KLEIN_DISK);
+  CConxPoint X[nthreads];
+  CountingMetric metric[nthreads];
+  void *args[nthreads];
+  for (size_t k = 0; k < nthreads; k++) {
+    metric[k].a = &a;
+    metric[k].X = &X[k];
+    metric[k].modl = CONX_KLEIN_DISK;
+    metric[k].evaluations = 0;
+    args[k] = &metric[k];
+  }
+  TracerCount serial;
+  conx_ptbuf_init(&serial.pixels);
+  conx_bresenham_batch(LB, RB, countingMetric, &metric[0],
+                       pixel, pixel, tracerKeepGoing, &serial,
+                       tracerBresTrace, NULL);
+  size_t serialEvaluations = metric[0].evaluations;
+  size_t serialDistinct = distinctPixels(serial.pixels, pixel);
+  ConxPtBuffer one;
+  conx_ptbuf_init(&one);
+  for (size_t t = 1; t <= nthreads; t *= 2) {
+    ConxPtBuffer threaded;
+    conx_ptbuf_init(&threaded);
+    Pt pts[CONX_SINK_SIZE];
+    ConxVertexSink sink;
+    conx_sink_init(&sink, pts, CONX_SINK_SIZE, conx_ptbuf_extend, &threaded);
+    for (size_t k = 0; k < nthreads; k++)
+      metric[k].evaluations = 0;
+    ConxBresStats stats;
+    conx_bresenham_threaded(LB, RB, countingMetric, args, t, pixel, pixel,
+                            tracerKeepGoing, NULL, &sink, &stats);
+    size_t evaluations = 0;
+    for (size_t k = 0; k < nthreads; k++)
+      evaluations += metric[k].evaluations;
+    OUT(a.humanSAType(a.getSAType()) << ": " << t << " threads drew "
+        << threaded.n << " pixels with " << evaluations << " evaluations; "
+        << "none drew " << serial.pixels.n << " with " << serialEvaluations
+        << "\n");
+    RET1(stats.emitted == threaded.n);
+    RET1(stats.unique == threaded.n);
+    RET1(distinctPixels(threaded, pixel) == threaded.n);
+    RET1(evaluations < 2 * serialEvaluations);
+    const ConxPtBuffer &same = (t == 1) ? serial.pixels : one;
+    if (t == 1 && closed) {
+      RET1(threaded.n + 8 > serialDistinct);
+      RET1(serialDistinct + 8 > threaded.n);
+      conx_ptbuf_extend(threaded.pts, threaded.n, &one);
+    } else {
+      RET1(threaded.n == same.n);
+      for (size_t i = 0; i < threaded.n; i++) {
+        RET1(threaded.pts[i].x == same.pts[i].x);
+        RET1(threaded.pts[i].y == same.pts[i].y);
+      }
+      if (t == 1) conx_ptbuf_extend(threaded.pts, threaded.n, &one);
+    }
+    conx_ptbuf_free(&threaded);
+  }
+  conx_ptbuf_free(&one);
+  conx_ptbuf_free(&serial.pixels);
+  return 0;
+}
+
+int tbresthreads(void)
+// Returns zero if tracing the directions of the branches of conics in
+// different threads draws what tracing them one after another does, but
+// where a closed curve closes up, the directions meet rather than one
+// going all the way around.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxPoint lb, rb;
+
+  CConxHypEllipse e(f1, f2, 2.0), h(f1, f2, 0.1);
+  e.getPointsOn(&lb, &rb);
+  RET1(sameThreadedPixels(e, lb, rb, TRUE) == 0);
+  CConxHypEllipse small(f1, CConxPoint(0.2, 0.1, CONX_KLEIN_DISK), 0.6);
+  small.getPointsOn(&lb, &rb);
+  RET1(sameThreadedPixels(small, lb, rb, TRUE) == 0);
+  h.getPointsOn(&lb, &rb);
+  RET1(sameThreadedPixels(h, lb, rb, FALSE) == 0);
+  CConxParabola p(f1, L);
+  RET1(p.getPointOn(&lb) == 0);
+  RET1(sameThreadedPixels(p, lb, lb, FALSE) == 0);
+  return 0;
+}
+
+static int closesUp(const CConxSimpleArtist &a, const CConxPoint &lb,
+                    const CConxPoint &rb, Boole closed)
+// Returns zero if the Bresenham method draws no pixel of a twice yet draws
+// (nearly, if a is closed) every pixel that it draws when it cannot see
+// where a closes up, and if a is closed, asks about the metric at about
+// half as many points.
+{
+  CConxPoint X;
+  CountingMetric seeing, blind;
+  seeing.a = blind.a = &a;
+  seeing.X = blind.X = &X;
+  seeing.modl = blind.modl = CONX_KLEIN_DISK;
+  seeing.evaluations = blind.evaluations = 0;
+  double pixel = 2.0 / 400;
+  Pt LB = lb.getPt(CONX_KLEIN_DISK), RB = rb.getPt(CONX_KLEIN_DISK);
+  TracerCount tc;
+  conx_ptbuf_init(&tc.pixels);
+  ConxBresStats stats;
+  conx_bresenham_batch(LB, RB, countingMetric, &seeing, pixel, pixel,
+                       tracerKeepGoing, &tc, tracerBresTrace, &stats);
+  size_t distinct = distinctPixels(tc.pixels, pixel);
+  MemoCount c;
+  c.requested = 0;
+  conx_ptbuf_init(&c.pixels);
+  conx_bresenham_batch(LB, RB, countingMetric, &blind, pixel, pixel,
+                       tracerKeepGoing, &c, memoCountingTrace, NULL);
+  size_t branches = (LB.x == RB.x && LB.y == RB.y) ? 1 : 2;
+  size_t requested = seeing.evaluations + stats.hits;
+  size_t blindRequested = c.requested + NUM_DIRECS * branches;
+  size_t blindDistinct = distinctPixels(c.pixels, pixel);
+  OUT(a.humanSAType(a.getSAType()) << ": drew " << stats.emitted
+      << " pixels, " << stats.unique << " distinct, asking about "
+      << requested << " points; " << c.pixels.n << " pixels, "
+      << blindDistinct << " distinct, and " << blindRequested
+      << " points when blind\n");
+  RET1(stats.emitted == tc.pixels.n);
+  RET1(stats.unique == stats.emitted);
+  RET1(distinct == stats.emitted);
+  RET1(requested <= blindRequested);
+  if (closed) {
+    // Where the blind tracer goes around again it may wander a pixel or
+    // two from its first lap.
+    RET1(distinct + 8 > blindDistinct);
+    RET1(5 * requested < 3 * blindRequested);
+  } else {
+    RET1(distinct == blindDistinct);
+  }
+  conx_ptbuf_free(&tc.pixels);
+  conx_ptbuf_free(&c.pixels);
+  return 0;
+}
+
+int tbresclosure(void)
+// Returns zero if the Bresenham method stops tracing a closed curve where
+// it closes up and traces open curves as far as it ever did.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxPoint lb, rb;
+
+  CConxHypEllipse e(f1, f2, 2.0), h(f1, f2, 0.1);
+  e.getPointsOn(&lb, &rb);
+  RET1(closesUp(e, lb, rb, TRUE) == 0);
+  CConxHypEllipse small(f1, CConxPoint(0.2, 0.1, CONX_KLEIN_DISK), 0.6);
+  small.getPointsOn(&lb, &rb);
+  RET1(closesUp(small, lb, rb, TRUE) == 0);
+  h.getPointsOn(&lb, &rb);
+  RET1(closesUp(h, lb, rb, FALSE) == 0);
+  CConxParabola p(f1, L);
+  RET1(p.getPointOn(&lb) == 0);
+  RET1(closesUp(p, lb, lb, FALSE) == 0);
+  return 0;
+}
+
+// What sinkFlush saw
+struct SinkCount {
+  ConxPtBuffer pts;
+  size_t flushes, most;
+};
+
+static void sinkFlush(const Pt *pts, size_t n, void *t)
+{
+  SinkCount *c = (SinkCount *) t;
+  conx_ptbuf_extend(pts, n, &c->pts);
+  ++c->flushes;
+  if (n > c->most) c->most = n;
+}
+
+static int samePoints(const ConxPtBuffer &a, const ConxPtBuffer &b)
+{
+  if (a.n != b.n) return 0;
+  for (size_t i = 0; i < a.n; i++)
+    if (a.pts[i].x != b.pts[i].x || a.pts[i].y != b.pts[i].y) return 0;
+  return 1;
+}
+
+int tsink(void)
+// Returns zero if the engines give a ConxVertexSink, a few points at a
+// time, exactly the points that they give a ConxPointFunc one at a time.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxHypEllipse e(f1, f2, 2.0);
+  CConxPoint X, lb, rb;
+  CountingMetric metric;
+  metric.a = &e;
+  metric.X = &X;
+  metric.modl = CONX_KLEIN_DISK;
+  metric.evaluations = 0;
+  const size_t sz = 7;
+  Pt buf[sz];
+  ConxVertexSink sink;
+  SinkCount c;
+  ConxPtBuffer one;
+
+  // The scanning engine
+  conx_ptbuf_init(&one);
+  conx_longway_batch(countingMetric, &metric, CONX_KLEIN_DISK, 0.01,
+                     0.004, 0.004, -1.0, 1.0, -1.0, 1.0,
+                     conx_ptbuf_append, &one);
+  conx_ptbuf_init(&c.pts);
+  c.flushes = c.most = 0;
+  conx_sink_init(&sink, buf, sz, sinkFlush, &c);
+  conx_longway_sink(countingMetric, &metric, CONX_KLEIN_DISK, 0.01,
+                    0.004, 0.004, -1.0, 1.0, -1.0, 1.0, &sink);
+  OUT("LONGWAY gave a sink " << c.pts.n << " points in " << c.flushes
+      << " flushes\n");
+  RET1(one.n > sz);
+  RET1(samePoints(one, c.pts));
+  RET1(c.flushes == (one.n + sz - 1) / sz);
+  RET1(c.most == sz);
+  RET1(sink.n == 0);
+  conx_ptbuf_free(&one);
+  conx_ptbuf_free(&c.pts);
+
+  // The tracing engine
+  e.getPointsOn(&lb, &rb);
+  Pt LB = lb.getPt(CONX_KLEIN_DISK);
+  double pixel = 2.0 / 400;
+  conx_ptbuf_init(&one);
+  conx_bres_trace_batch(LB, CXD_N, pixel, pixel, countingMetric, &metric,
+                        NULL, tracerKeepGoing, NULL, conx_ptbuf_append, &one);
+  conx_ptbuf_init(&c.pts);
+  c.flushes = c.most = 0;
+  conx_sink_init(&sink, buf, sz, sinkFlush, &c);
+  conx_bres_trace_sink(LB, CXD_N, pixel, pixel, countingMetric, &metric,
+                       NULL, tracerKeepGoing, NULL, &sink);
+  RET1(one.n > sz);
+  RET1(samePoints(one, c.pts));
+  RET1(c.flushes == (one.n + sz - 1) / sz);
+
+  // A buffer of points goes to the flush function as is.
+  c.flushes = 0;
+  conx_sink_vertex(0.5, 0.25, &sink);
+  conx_sink_ptbuf(&sink, &one);
+  RET1(c.flushes == 2);
+  RET1(c.pts.n == 2 * one.n + 1);
+  RET1(c.pts.pts[one.n].x == 0.5 && c.pts.pts[one.n].y == 0.25);
+  conx_ptbuf_free(&one);
+  conx_ptbuf_free(&c.pts);
+
+  // A canvas that takes vertices one at a time still gets them all.
+  CConxRecordingCanvas cv;
+  conx_sink_init(&sink, buf, sz, CConxCanvas::sinkVertices,
+                 (CConxDrawCanvas *) &cv);
+  // CONX_SINK_VERTEX is one statement, even before an else.
+  for (size_t i = 0; i < 3 * sz + 1; i++)
+    if (i % 2 == 0)
+      CONX_SINK_VERTEX(&sink, (double) i, -(double) i);
+    else
+      conx_sink_vertex((double) i, -(double) i, &sink);
+  conx_sink_flush(&sink);
+  RET1(cv.numVertices() == 3 * sz + 1);
+  RET1(cv.getVertex(sz).x == (double) sz);
+  return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Runs a template of kernels.hh with the metric that conxWithArtistMetric()
+// finds: conxLatticeLongway() if L is not NULL, conxBresenham() otherwise.
+class CConxTestKernel {
+public:
+  CConxTestKernel(Pt l, Pt r, double p, const ConxLattice *lat,
+                  ConxVertexSink *s)
+    : LB(l), RB(r), pixel(p), L(lat), sink(s) { }
+  template <class M> void run(M &m)
+  {
+    CConxContinueCall keepgoing(tracerKeepGoing, NULL);
+    CConxSinkCall s(sink);
+    if (L != NULL)
+      conxLatticeLongway(m, 0.01, *L, s);
+    else
+      conxBresenham(LB, RB, pixel, pixel, m, keepgoing, s, &stats);
+  }
+  ConxBresStats stats;
+
+private:
+  Pt LB, RB;
+  double pixel;
+  const ConxLattice *L;
+  ConxVertexSink *sink;
+}; // class CConxTestKernel
+
+// Runs conx_lattice_longway() on three threads, each with its own copy of
+// the metric that conxWithArtistMetric() finds.
+class CConxThreadsKernel {
+public:
+  CConxThreadsKernel(const ConxLattice *lat, ConxPtBuffer *b)
+    : L(lat), buf(b) { }
+  template <class M> void run(M &m)
+  {
+    CConxThreadMetrics< M > ms(m, 3);
+    conx_lattice_longway(ms.call, ms.getArgs(), 3, 0.01, L,
+                         conx_ptbuf_append, buf);
+  }
+
+private:
+  const ConxLattice *L;
+  ConxPtBuffer *buf;
+}; // class CConxThreadsKernel
+
+static int sameKernels(const CConxSimpleArtist &a, const CConxPoint &lb,
+                       const CConxPoint &rb)
+// Returns zero if the templates of kernels.hh draw a exactly as the C
+// functions do, by both the Bresenham and LONGWAY methods.
+{
+  CConxPoint X;
+  CountingMetric metric;
+  metric.a = &a;
+  metric.X = &X;
+  metric.modl = CONX_KLEIN_DISK;
+  metric.evaluations = 0;
+  double pixel = 2.0 / 400;
+  Pt LB = lb.getPt(CONX_KLEIN_DISK), RB = rb.getPt(CONX_KLEIN_DISK);
+  Pt buf[CONX_SINK_SIZE];
+  ConxVertexSink sink;
+  SinkCount c;
+
+  TracerCount tc;
+  conx_ptbuf_init(&tc.pixels);
+  ConxBresStats stats;
+  conx_bresenham_batch(LB, RB, countingMetric, &metric, pixel, pixel,
+                       tracerKeepGoing, &tc, tracerBresTrace, &stats);
+  conx_ptbuf_init(&c.pts);
+  c.flushes = c.most = 0;
+  conx_sink_init(&sink, buf, CONX_SINK_SIZE, sinkFlush, &c);
+  CConxTestKernel bres(LB, RB, pixel, NULL, &sink);
+  RET1(conxWithArtistMetric(a, CONX_KLEIN_DISK, CONX_PRECISE, bres));
+  OUT(a.humanSAType(a.getSAType()) << ": the templates traced "
+      << c.pts.n << " pixels; the C functions, " << tc.pixels.n << "\n");
+  RET1(tc.pixels.n > 100);
+  RET1(samePoints(tc.pixels, c.pts));
+  RET1(bres.stats.hits == stats.hits);
+  RET1(bres.stats.emitted == stats.emitted);
+  RET1(bres.stats.unique == stats.unique);
+  conx_ptbuf_free(&tc.pixels);
+  conx_ptbuf_free(&c.pts);
+
+  // The atlas has Klein coordinates for the Poincare disk's lattice.
+  CConxDumbCanvas cv;
+  const ConxLattice *L = &cv.getAtlas(CONX_POINCARE_DISK);
+  ConxPtBuffer one;
+  void *args[1];
+  args[0] = &metric;
+  conx_ptbuf_init(&one);
+  conx_lattice_longway(countingMetric, args, 1, 0.01, L,
+                       conx_ptbuf_append, &one);
+  conx_ptbuf_init(&c.pts);
+  conx_sink_init(&sink, buf, CONX_SINK_SIZE, sinkFlush, &c);
+  CConxTestKernel longway(LB, RB, pixel, L, &sink);
+  RET1(conxWithArtistMetric(a, CONX_KLEIN_DISK, CONX_PRECISE, longway));
+  RET1(one.n > 100);
+  RET1(samePoints(one, c.pts));
+  conx_ptbuf_free(&c.pts);
+  conx_ptbuf_init(&c.pts);
+  CConxThreadsKernel threads(L, &c.pts);
+  RET1(conxWithArtistMetric(a, CONX_KLEIN_DISK, CONX_PRECISE, threads));
+  RET1(samePoints(one, c.pts));
+  conx_ptbuf_free(&one);
+  conx_ptbuf_free(&c.pts);
+  return 0;
+}
+
+// Evaluates the metric that conxWithArtistMetric() finds at n points.
+class CConxValueKernel {
+public:
+  CConxValueKernel(const double *xs, const double *ys, double *fs, size_t m)
+    : x(xs), y(ys), f(fs), n(m) { }
+  template <class M> void run(M &m) { m(x, y, f, n); }
+
+private:
+  const double *x, *y;
+  double *f;
+  size_t n;
+}; // class CConxValueKernel
+
+static int sameValues(const CConxSimpleArtist &a)
+// Returns zero if a's metric, as conxWithArtistMetric() finds it for each
+// model, gives exactly what a's definingFunction() does, even at and
+// beyond infinity.
+{
+  const size_t n = 48;
+  double x[n], y[n], f[n];
+  size_t i;
+  for (i = 0; i < n; i++) {
+    x[i] = -1.05 + 0.045 * (double) i;
+    y[i] = 0.9 - 0.04 * (double) i;
+  }
+  y[0] = 0.0;
+  y[1] = -0.5;
+  CConxPoint X;
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    ConxModlType modl = (ConxModlType) m;
+    CConxValueKernel k(x, y, f, n);
+    RET1(conxWithArtistMetric(a, modl, CONX_PRECISE, k));
+    for (i = 0; i < n; i++) {
+      X.setPoint(x[i], y[i], modl);
+      RET1(f[i] == a.definingFunction(X));
+    }
+  }
+  return 0;
+}
+
+int tkernels(void)
+// Returns zero if the templates of kernels.hh, with each artist's metric
+// inlined, draw what the C functions that call the metric through a
+// pointer draw.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxPoint lb, rb;
+
+  CConxHypEllipse e(f1, f2, 2.0), h(f1, f2, 0.1);
+  e.getPointsOn(&lb, &rb);
+  RET1(sameKernels(e, lb, rb) == 0);
+  h.getPointsOn(&lb, &rb);
+  RET1(sameKernels(h, lb, rb) == 0);
+  CConxParabola p(f1, L);
+  RET1(p.getPointOn(&lb) == 0);
+  RET1(sameKernels(p, lb, lb) == 0);
+  CConxEqDistCurve q(L, 0.3);
+  q.getPointsOn(&lb, &rb, -1.0, 1.0);
+  RET1(sameKernels(q, lb, rb) == 0);
+
+  // Lines, equidistant curves, and parabolas have metrics specialized for
+  // each model.
+  RET1(sameValues(L) == 0);
+  RET1(sameValues(q) == 0);
+  RET1(sameValues(p) == 0);
+  RET1(sameValues(CConxParabola(CConxPoint(1.0, 0.0, CONX_KLEIN_DISK), L))
+       == 0);
+  return 0;
+}
+
+static int drawsClosedForm(const CConxSimpleArtist &a, size_t nconics)
+// Returns zero if the BRESENHAM method draws a as nconics arcs or ellipses
+// in each model, with no evaluations of a's defining function, and if
+// those curves lie on a.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  CConxPoint X;
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDwGeomObj d(a);
+    d.setDrawingMethod(d.BRESENHAM);
+    d.setGarnishing(FALSE);
+    CConxRecordingCanvas cv;
+    cv.setModel(models[m]);
+    if (models[m] == CONX_POINCARE_UHP)
+      cv.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+    d.drawOn(cv);
+    RET1(cv.numBresenhams() == 0);
+    RET1(cv.numVertices() == 0);
+    RET1(cv.numConics() == ((models[m] == CONX_KLEIN_DISK) ? 1 : nconics));
+    double worst = 0.0;
+    size_t inside = 0;
+    for (size_t i = 0; i < cv.numConics(); i++) {
+      for (int k = 1; k < 64; k++) {
+        Pt v = cv.getConicPoint(i, k / 64.0);
+        X.setPoint(v.x, v.y, models[m]);
+        if (X.isAtInfinity(0.01)) continue;
+        worst = greater(worst, myabs(a.definingFunction(X)));
+        ++inside;
+      }
+    }
+    OUT(CConxSimpleArtist::humanSAType(a.getSAType()) << " in the "
+        << conx_modelenum2string(models[m]) << ": " << cv.numConics()
+        << " curves, " << inside << " points, worst " << worst << "\n");
+    RET1(inside > 16);
+    RET1(worst < 1e-9);
+  }
+  return 0;
+}
+
+int tclosedform(void)
+// Returns zero if circles and equidistant curves are drawn by their
+// Euclidean centers and radii, or axes, rather than by their metrics.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxPoint o(0.0, 0.0, CONX_KLEIN_DISK);
+  RET1(drawsClosedForm(CConxCircle(f1, 0.8), 1) == 0);
+  RET1(drawsClosedForm(CConxCircle(f2, 3.0), 1) == 0);
+  RET1(drawsClosedForm(CConxCircle(o, 0.5), 1) == 0);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxLine D(o, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxLine V(CConxPoint(0.5, 1.0, CONX_POINCARE_UHP),
+              CConxPoint(0.5, 2.0, CONX_POINCARE_UHP));
+  RET1(drawsClosedForm(CConxEqDistCurve(L, 0.5), 2) == 0);
+  RET1(drawsClosedForm(CConxEqDistCurve(L, 0.0), 1) == 0);
+  RET1(drawsClosedForm(CConxEqDistCurve(D, 0.3), 2) == 0);
+
+  // A line through the UHP's ideal point at infinity has rays for its
+  // equidistant curves there.
+  CConxDwGeomObj d(CConxEqDistCurve(V, 0.3));
+  d.setDrawingMethod(d.BRESENHAM);
+  d.setGarnishing(FALSE);
+  CConxRecordingCanvas cv;
+  cv.setModel(CONX_POINCARE_UHP);
+  cv.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+  d.drawOn(cv);
+  RET1(cv.numConics() == 0);
+  RET1(cv.numVertices() == 4);
+  CConxPoint X;
+  for (size_t i = 0; i < 4; i++) {
+    Pt v = cv.getVertex(i);
+    if (i % 2 == 0) {
+      RET1(myequals(v.y, 0.0, EQUALITY_TOL));
+    } else {
+      X.setPoint(v.x, v.y, CONX_POINCARE_UHP);
+      RET1(myequals(V.distanceFrom(X), 0.3, 1e-9));
+    }
+  }
+  return 0;
+}
+
+int tview(void)
+// Returns zero if moving a canvas's view first moves what it drew without
+// drawing the artists again, and then draws the artists moved by the view,
+// which brings into sight what the old view clipped off.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.1, CONX_KLEIN_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  CConxRecordingCanvas cv, fresh, moved;
+  CConxRecordingCanvas *all[3] = { &cv, &fresh, &moved };
+  for (int k = 0; k < 3; k++) {
+    all[k]->setModel(CONX_POINCARE_DISK);
+    all[k]->setSize(40, 40);
+  }
+  CConxCircle c(f1, 0.8);
+  CConxParabola p(f1, L);
+  for (int k = 0; k < 2; k++) {
+    appendLongway(*all[k], c, 0.01, FALSE);
+    CConxDwGeomObj d(p);
+    d.setDrawingMethod(d.BRESENHAM);
+    all[k]->append(&d);
+  }
+  cv.masterDraw();
+  size_t bres = cv.numBresenhams(), i;
+  RET1(bres > 0);
+  RET1(cv.numVertices() > 0);
+  CConxSimpleArray<Pt> before;
+  for (i = 0; i < cv.numVertices(); i++) before.append(cv.getVertex(i));
+
+  cv.translateBy(CConxPoint(0.2, 0.1, CONX_POINCARE_DISK));
+  cv.rotateBy(0.5);
+  cv.masterDraw();
+  RET1(cv.numBresenhams() == bres);
+  RET1(cv.numVertices() == before.size());
+  ConxIsometry g = cv.getView();
+  for (i = 0; i < before.size(); i++) {
+    Pt q = before.get(i), r = cv.getVertex(i);
+    conx_isom_apply_pts(&g, CONX_POINCARE_DISK, &q, &q, 1);
+    RET1(q.x == r.x && q.y == r.y);
+  }
+
+  // The next call draws the artists as the view moves them, just as a
+  // canvas whose artists were moved to begin with draws them.
+  cv.masterDraw();
+  RET1(cv.numBresenhams() > bres);
+  fresh.setView(g);
+  fresh.masterDraw();
+  RET1(fresh.sameVertices(cv));
+  c.moveBy(g);
+  p.moveBy(g);
+  Pt o = { 0.0, 0.0 }, go = o;
+  conx_isom_apply_pts(&g, CONX_POINCARE_DISK, &go, &go, 1);
+  RET1(myequals(c.getCenter().distanceFrom(CConxPoint(go, CONX_POINCARE_DISK)),
+                f1.distanceFrom(CConxPoint(o, CONX_POINCARE_DISK)), 1e-9));
+  RET1(c.getRadius() == 0.8);
+  appendLongway(moved, c, 0.01, FALSE);
+  CConxDwGeomObj d(p);
+  d.setDrawingMethod(d.BRESENHAM);
+  moved.append(&d);
+  moved.masterDraw();
+  RET1(moved.sameVertices(cv));
+
+  int threw = 0;
+  try {
+    cv.translateBy(CConxPoint(1.0, 0.0, CONX_POINCARE_DISK));
+  } catch (int) {
+    threw = 1;
+  }
+  RET1(threw);
+
+  // Going back moves the scene back, and then draws what we drew first.
+  cv.resetView();
+  cv.masterDraw();
+  RET1(cv.numVertices() == fresh.numVertices());
+  cv.masterDraw();
+  RET1(cv.numVertices() == before.size());
+  for (i = 0; i < before.size(); i++) {
+    Pt q = before.get(i), r = cv.getVertex(i);
+    RET1(q.x == r.x && q.y == r.y);
+  }
+
+  // A change to the scene draws the artists again.
+  bres = cv.numBresenhams();
+  cv.setViewingRectangle(-0.5, 0.5, -0.5, 0.5);
+  cv.masterDraw();
+  RET1(cv.numBresenhams() > bres);
+
+  // What a zoomed view clipped off comes into sight once it is panned to.
+  CConxRecordingCanvas zoomed;
+  zoomed.setModel(CONX_POINCARE_DISK);
+  zoomed.setSize(40, 40);
+  zoomed.setViewingRectangle(-0.2, 0.2, -0.2, 0.2);
+  appendLongway(zoomed, CConxCircle(CConxPoint(0.6, 0.0, CONX_KLEIN_DISK),
+                                    0.1), 0.05, FALSE);
+  zoomed.masterDraw();
+  size_t none = zoomed.numVertices();
+  zoomed.translateBy(CConxPoint(-0.6, 0.0, CONX_KLEIN_DISK));
+  zoomed.masterDraw();
+  RET1(zoomed.numVertices() == none);
+  zoomed.masterDraw();
+  OUT("Panning a zoomed view brought " << zoomed.numVertices() - none
+      << " points into sight\n");
+  RET1(zoomed.numVertices() > none);
+  return 0;
+}
+
+
+static int polarsNear(const CConxSimpleArtist &a, Boole closed)
+// Returns zero if drawing a by the POLAR method draws, in each model,
+// LINE_STRIPs whose vertices lie on a, and if closed is TRUE, one strip
+// that ends where it began.
+{
+  ConxModlType models[CONX_NUM_MODELS] = {
+    CONX_KLEIN_DISK, CONX_POINCARE_DISK, CONX_POINCARE_UHP
+  };
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    CConxDwGeomObj d(a);
+    d.setDrawingMethod(d.POLAR);
+    d.setGarnishing(FALSE);
+    CConxRecordingCanvas cv;
+    cv.setModel(models[m]);
+    if (models[m] == CONX_POINCARE_UHP)
+      cv.setViewingRectangle(-3.0, 3.0, 0.0, 6.0);
+    d.drawOn(cv);
+    OUT("POLAR drew " << cv.numVertices() << " vertices in "
+        << cv.numStrips() << " strips in the "
+        << conx_modelenum2string(models[m]) << "\n");
+    RET1(cv.numBresenhams() == 0);
+    RET1(cv.numStrips() >= 1);
+    RET1(cv.numVertices() > 2 * cv.numStrips());
+    if (closed) {
+      RET1(cv.numStrips() == 1);
+      Pt first = cv.getVertex(0), last = cv.getVertex(cv.numVertices() - 1);
+      RET1(first.x == last.x && first.y == last.y);
+    }
+    double worst = 0.0;
+    for (size_t i = 0; i < cv.numVertices(); i++)
+      worst = greater(worst, pixelsOff(a, cv, cv.getVertex(i)));
+    OUT("The worst vertex is " << worst << " pixels off\n");
+    RET1(worst < 0.001);
+  }
+  return 0;
+}
+
+static int polarKeepGoing(Pt p, Pt q, void *t)
+{
+  return (sqr(p.x) + sqr(p.y) < 1.0 || sqr(q.x) + sqr(q.y) < 1.0);
+}
+
+int tpolar(void)
+// Returns zero if the POLAR method draws hypellipses and parabolas along
+// the curves, and an ellipse with fewer evaluations of its defining
+// function than the Bresenham method takes.
+{
+  CConxPoint f1(0.1, 0.2, CONX_KLEIN_DISK), f2(-0.3, 0.4, CONX_POINCARE_DISK);
+  CConxLine L(f2, CConxPoint(0.5, 0.5, CONX_KLEIN_DISK));
+  RET1(polarsNear(CConxHypEllipse(f1, f2, 2.0), TRUE) == 0);
+  RET1(polarsNear(CConxHypEllipse(f1, f2, 0.1), FALSE) == 0);
+  RET1(polarsNear(CConxParabola(f1, L), FALSE) == 0);
+
+  // Artists that are not star-shaped are drawn as for BRESENHAM.
+  CConxDwGeomObj d(CConxEqDistCurve(L, 0.5));
+  d.setDrawingMethod(d.POLAR);
+  d.setGarnishing(FALSE);
+  CConxRecordingCanvas cv;
+  d.drawOn(cv);
+  RET1(cv.numConics() == 1);
+
+  CConxHypEllipse e(f1, f2, 2.0);
+  CConxPoint lb, rb, X;
+  e.getPointsOn(&lb, &rb);
+  CountingMetric bres, polar;
+  bres.a = polar.a = &e;
+  bres.X = polar.X = &X;
+  bres.modl = polar.modl = CONX_KLEIN_DISK;
+  bres.evaluations = polar.evaluations = 0;
+  double pixel = 2.0 / 400, length = 0.0, h[3];
+  TracerCount tc;
+  conx_ptbuf_init(&tc.pixels);
+  conx_bresenham_batch(lb.getPt(CONX_KLEIN_DISK), rb.getPt(CONX_KLEIN_DISK),
+                       countingMetric, &bres, pixel, pixel,
+                       tracerKeepGoing, &tc, tracerBresTrace, NULL);
+  conx_ptbuf_free(&tc.pixels);
+  RET1(f1.getHyperboloid(h));
+  size_t n = conx_polar(h, CONX_KLEIN_DISK, countingMetric, &polar,
+                        pixel, pixel, polarKeepGoing, NULL,
+                        tracerLength, &length);
+  RET1(n == polar.evaluations);
+  RET1(length > 0.0);
+  OUT("Bresenham evaluated " << bres.evaluations << " times; POLAR "
+      << polar.evaluations << " times\n");
+  RET1(polar.evaluations < bres.evaluations / 2);
+
+  // Zoomed in, we refine only what is on the canvas.
+  CConxDwGeomObj p(CConxHypEllipse(f1, f2, 0.1));
+  p.setDrawingMethod(p.POLAR);
+  p.setGarnishing(FALSE);
+  p.setPrecision(CONX_FAST);
+  CConxRecordingCanvas whole, zoomed;
+  whole.setModel(CONX_KLEIN_DISK);
+  p.drawOn(whole);
+  RET1(whole.getDrawnPrecision() == CONX_FAST);
+  RET1(whole.getMetricPrecision() == CONX_PRECISE);
+  RET1(whole.numVertices() > 0);
+  Pt c = whole.getVertex(whole.numVertices() / 2);
+  zoomed.setModel(CONX_KLEIN_DISK);
+  zoomed.setViewingRectangle(c.x - 0.05, c.x + 0.05, c.y - 0.05, c.y + 0.05);
+  p.drawOn(zoomed);
+  size_t inside = 0;
+  for (size_t i = 0; i < zoomed.numVertices(); i++) {
+    Pt v = zoomed.getVertex(i);
+    if (myabs(v.x - c.x) < 0.05 && myabs(v.y - c.y) < 0.05) ++inside;
+  }
+  OUT("Zoomed in, POLAR drew " << zoomed.numVertices() << " vertices, "
+      << inside << " on the canvas; zoomed out, " << whole.numVertices()
+      << "\n");
+  RET1(inside > 2);
+  RET1(zoomed.numVertices() < 4 * inside + 2 * whole.numVertices());
+  return 0;
+}
 
 int main(int argc, char **argv)
 {
@@ -236,5 +2185,47 @@ int main(int argc, char **argv)
   THERE_ARE_ZERO_OBJECTS();
   TEST(tpoint() == 0);
   THERE_ARE_ZERO_OBJECTS();
+  TEST(tlongway() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tdefiningfunctions() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tquadtree() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tcontour() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tzoom() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tfieldraster() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tatlas() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tfused() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tfast() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tcompare() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tprogressive() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(ttracer() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tgradients() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tbresmemo() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tbresthreads() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tbresclosure() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tsink() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tkernels() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tview() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tclosedform() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tpolar() == 0);
+  THERE_ARE_ZERO_OBJECTS();
   return GOOD_TEST_EXIT_CODE;
 }
@@ -45,6 +45,8 @@ static int tparabola(void);
 static int tline(void);
 static int tlineseg(void);
 static int tpoint(void);
+static int tisometry(void);
+static int tconverters(void);
 
 int tcolor(void)
 {
@@ -181,7 +183,37 @@ int tline(void)
          << (ptE1.isAtInfinity(EQUALITY_TOL) ? "" : " NOT")
          << " at infinity (tol=EQUALITY_TOL).\n";
   }
-  // DLC fill this in.
+
+  // Distances from a line are in closed form in every model.  From the
+  // origin to the Klein disk's line x=m, the distance is atanh(m).
+  CConxLine V(CConxPoint(0.3, 0.5, CONX_KLEIN_DISK),
+              CConxPoint(0.3, -0.5, CONX_KLEIN_DISK));
+  CConxPoint O(0.0, 0.0, CONX_KLEIN_DISK);
+  RET1(myequals(V.distanceFrom(O), 0.5 * log(1.3 / 0.7), 1e-12));
+  const CConxLine *lines[2] = { &L1, &V };
+  CConxPoint pts[3] = {
+    CConxPoint(0.1, 0.6, CONX_KLEIN_DISK),
+    CConxPoint(-0.5, 0.2, CONX_POINCARE_DISK),
+    CConxPoint(0.8, -0.55, CONX_KLEIN_DISK)
+  };
+  for (int i = 0; i < 2; i++) {
+    const CConxLine &L = *lines[i];
+    for (int j = 0; j < 3; j++) {
+      double d = L.distanceFrom(pts[j]);
+      RET1(d > 0.0);
+      RET1(myequals(conxp_distFromarX(L.getPUHP_A(), L.getPUHP_R(),
+                                      pts[j].getPt(CONX_POINCARE_UHP), 0.0),
+                    d, 1e-9));
+      RET1(myequals(conxpd_distFromcX(L.getPD_Cx(), L.getPD_Cy(),
+                                      pts[j].getPt(CONX_POINCARE_DISK), 0.0),
+                    d, 1e-9));
+      // The foot of the perpendicular is on L, d away.
+      CConxLine P;
+      L.getPerpendicular(P, pts[j]);
+      RET1(myequals(P.getB().distanceFrom(pts[j]), d, 1e-9));
+      RET1(L.distanceFrom(P.getB()) < 1e-9);
+    }
+  }
   return 0;
 }
 
@@ -206,8 +238,138 @@ int tpoint(void)
   RET1(CConxString("first all [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)] then kd kd(0.3, 0.4) and now pd pd(0.16077, 0.214359) and now puhp puhp(0.5, 1.44338) and now all again [puhp(0.5, 1.44338), kd(0.3, 0.4), pd(0.16077, 0.214359)]\n") == s);
 #endif
   delete [] s;
-  
-  // DLC fill this in.
+
+  // Each model is a projection of the same point of the hyperboloid.
+  double h[3], g[3];
+  RET1(p1.getHyperboloid(h));
+  RET1(myequals(sqr(h[2]) - sqr(h[0]) - sqr(h[1]), 1.0, 1e-12));
+  for (int m = 0; m < CONX_NUM_MODELS; m++) {
+    ConxModlType modl = (ConxModlType) m;
+    CConxPoint q(p1.getPt(modl), modl);
+    RET1(q.getHyperboloid(g));
+    for (int k = 0; k < 3; k++) RET1(myequals(g[k], h[k], 1e-12));
+    for (int n = 0; n < CONX_NUM_MODELS; n++) {
+      ConxModlType to = (ConxModlType) n;
+      RET1(myequals(q.getX(to), p1.getX(to), 1e-12));
+      RET1(myequals(q.getY(to), p1.getY(to), 1e-12));
+    }
+  }
+  RET1(!CConxPoint(0.0, 1.0, CONX_POINCARE_DISK).getHyperboloid(h));
+
+  // Near the boundary, the Poincare disk's coordinates keep the distance
+  // that going through the Klein disk would lose.
+  CConxPoint O(0.0, 0.0, CONX_POINCARE_DISK);
+  CConxPoint P(1.0 - 1e-7, 0.0, CONX_POINCARE_DISK);
+  RET1(myequals(P.distanceFrom(O, 0.0), log((2.0 - 1e-7) / 1e-7), 1e-8));
+  RET1(P.distanceFrom(P, 0.0) == 0.0);
+  return 0;
+}
+
+int tisometry(void)
+// Returns zero if isometries move points the same way in every model,
+// keep distances, and compose and invert as they should.
+{
+  ConxIsometry t, r, tr, inv;
+  RET1(conx_isom_translation(&t, 0.3, -0.2));
+  RET1(!conx_isom_translation(&t, 0.6, 0.8));
+  conx_isom_rotation(&r, M_PI / 2.0);
+  conx_isom_compose(&t, &r, &tr);
+  conx_isom_inverse(&tr, &inv);
+
+  // The translation takes the origin to (0.3, -0.2); the rotation turns.
+  Pt o = { 0.0, 0.0 }, q = { 0.5, 0.0 };
+  conx_isom_apply_pts(&t, CONX_POINCARE_DISK, &o, &o, 1);
+  RET1(myequals(o.x, 0.3, 1e-15) && myequals(o.y, -0.2, 1e-15));
+  conx_isom_apply_pts(&r, CONX_POINCARE_DISK, &q, &q, 1);
+  RET1(myequals(q.x, 0.0, 1e-15) && myequals(q.y, 0.5, 1e-15));
+
+  CConxPoint pts[3] = {
+    CConxPoint(0.1, 0.6, CONX_KLEIN_DISK),
+    CConxPoint(-0.5, 0.2, CONX_POINCARE_DISK),
+    CConxPoint(0.8, -0.55, CONX_KLEIN_DISK)
+  };
+  Pt moved[3][CONX_NUM_MODELS];
+  for (int i = 0; i < 3; i++) {
+    for (int m = 0; m < CONX_NUM_MODELS; m++) {
+      ConxModlType modl = (ConxModlType) m;
+      Pt P = pts[i].getPt(modl), Q = P, R;
+      conx_isom_apply_pts(&r, modl, &Q, &Q, 1);
+      conx_isom_apply_pts(&t, modl, &Q, &Q, 1);
+      conx_isom_apply_pts(&tr, modl, &P, &R, 1);
+      RET1(myequals(Q.x, R.x, 1e-12) && myequals(Q.y, R.y, 1e-12));
+      moved[i][m] = R;
+      conx_isom_apply_pts(&inv, modl, &R, &R, 1);
+      RET1(myequals(R.x, P.x, 1e-12) && myequals(R.y, P.y, 1e-12));
+    }
+    // Every model agrees on where the point went.
+    CConxPoint K(moved[i][CONX_KLEIN_DISK], CONX_KLEIN_DISK);
+    for (int m = 0; m < CONX_NUM_MODELS; m++)
+      RET1(K.distanceFrom(CConxPoint(moved[i][m], (ConxModlType) m), 0.0)
+           < 1e-9);
+    for (int j = 0; j < i; j++) {
+      for (int m = 0; m < CONX_NUM_MODELS; m++) {
+        ConxModlType modl = (ConxModlType) m;
+        RET1(myequals(CConxPoint(moved[i][m], modl)
+                      .distanceFrom(CConxPoint(moved[j][m], modl)),
+                      pts[i].distanceFrom(pts[j]), 1e-9));
+      }
+    }
+  }
+
+  // The Lorentz matrix keeps the hyperboloid's Minkowski product.
+  double M[9], a[3], b[3], h[3];
+  conx_isom_lorentz(&tr, M);
+  RET1(pts[0].getHyperboloid(h));
+  for (int k = 0; k < 3; k++)
+    a[k] = M[3*k]*h[0] + M[3*k+1]*h[1] + M[3*k+2]*h[2];
+  RET1(myequals(sqr(a[2]) - sqr(a[0]) - sqr(a[1]), 1.0, 1e-12));
+  RET1(CConxPoint(moved[0][CONX_KLEIN_DISK], CONX_KLEIN_DISK)
+       .getHyperboloid(b));
+  for (int k = 0; k < 3; k++) RET1(myequals(a[k], b[k], 1e-12));
+  return 0;
+}
+
+typedef void (ConverterFunc)(double, double, double *, double *);
+typedef void (BatchConverterFunc)(const double *, const double *, double *,
+                                  double *, size_t);
+
+int tconverters(void)
+// Returns zero if each batch model converter gives exactly what its
+// one-point-at-a-time twin does, in place or not, for any number of
+// points left over after the vector loop.
+{
+  ConverterFunc *one[6] = {
+    conxhm_ptok, conxhm_pdtok, conxhm_ktop,
+    conxhm_ktopd, conxhm_pdtop, conxhm_ptopd
+  };
+  BatchConverterFunc *batch[6] = {
+    conxhm_ptok_batch, conxhm_pdtok_batch, conxhm_ktop_batch,
+    conxhm_ktopd_batch, conxhm_pdtop_batch, conxhm_ptopd_batch
+  };
+  // The UHP converters get points of the UHP and the others of a disk.
+  Boole fromUHP[6] = { TRUE, FALSE, FALSE, FALSE, FALSE, TRUE };
+#define NCONV 37
+  double x[NCONV], y[NCONV], u[NCONV], v[NCONV], a, b;
+  for (int k = 0; k < 6; k++) {
+    for (size_t n = 0; n <= NCONV; n += (n < 9) ? 1 : 7) {
+      for (size_t i = 0; i < n; i++) {
+        // Points spiralling out toward the boundary
+        double r = 0.999 * (i + 1) / (double) NCONV, t = 2.4 * i;
+        x[i] = r * cos(t);
+        y[i] = r * sin(t);
+        if (fromUHP[k]) conxhm_pdtop(x[i], y[i], x + i, y + i);
+      }
+      batch[k](x, y, u, v, n);
+      for (size_t i = 0; i < n; i++) {
+        (*one[k])(x[i], y[i], &a, &b);
+        RET1(u[i] == a && v[i] == b);
+      }
+      batch[k](x, y, x, y, n);
+      for (size_t i = 0; i < n; i++)
+        RET1(x[i] == u[i] && y[i] == v[i]);
+    }
+  }
+#undef NCONV
   return 0;
 }
 
@@ -234,5 +396,9 @@ int main(int argc, char **argv)
   THERE_ARE_ZERO_OBJECTS();
   TEST(tpoint() == 0);
   THERE_ARE_ZERO_OBJECTS();
+  TEST(tisometry() == 0);
+  THERE_ARE_ZERO_OBJECTS();
+  TEST(tconverters() == 0);
+  THERE_ARE_ZERO_OBJECTS();
   return GOOD_TEST_EXIT_CODE;
 }
@@ -52,6 +52,10 @@
 
 Boole CConxToglObj::debugMode = FALSE;
 
+// The seconds, by the wall clock, that a redisplay should spend drawing
+// one pass before it shows what it has and lets Tk run.
+#define TCONX_FRAME_BUDGET 0.1
+
 static CConxGLCanvas pdCanvas, puhpCanvas, kdCanvas;
 static CConxClsMetaParser mp(&kdCanvas, &pdCanvas, &puhpCanvas);
 
@@ -66,6 +70,12 @@ void initCanvases()
   puhpCanvas.setViewingRectangle(-1.0, 1.0, 0.0, 2.0);
   pdCanvas.setViewingRectangle(-1.03, 1.03, -1.03, 1.03);
   kdCanvas.setViewingRectangle(-1.03, 1.03, -1.03, 1.03);
+  pdCanvas.setNumThreads(conx_num_processors());
+  kdCanvas.setNumThreads(conx_num_processors());
+  puhpCanvas.setNumThreads(conx_num_processors());
+  pdCanvas.setFrameBudget(TCONX_FRAME_BUDGET);
+  kdCanvas.setFrameBudget(TCONX_FRAME_BUDGET);
+  puhpCanvas.setFrameBudget(TCONX_FRAME_BUDGET);
   
   CConxPoint focus1(0.5, 0.75, CONX_POINCARE_UHP);
   CConxPoint focus2(0.2, 0.75, CONX_POINCARE_UHP);
@@ -167,6 +177,10 @@ void CConxToglObj::displayCallBack(struct Togl *togl)
   Togl_SwapBuffers(togl);
 #endif
 
+  // Let Tk handle events before we draw the next, finer, pass.  If the
+  // scene changes meanwhile, the canvas starts over coarsely.
+  if (cnvs->needsRefinement()) Togl_PostRedisplay(togl);
+
   LOGGG0(LOGG_FULL, "\n@end display_callback\n");
 }
 
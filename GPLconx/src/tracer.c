@@ -0,0 +1,224 @@
+/*
+    GPLconx -- visualize 2-D hyperbolic geometry.
+    Copyright (C) 1996-2001  David L. Chandler
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+*/
+
+/*
+  Curve tracing by continuation.  Where the Bresenham method walks from
+  pixel to pixel, trying the three pixels ahead of it, we step along the
+  curve's tangent (the predictor) and then use Newton's method to get
+  back onto the zero set of the metric (the corrector).  Steps are as
+  long as a few pixels where the curve is nearly straight and as short
+  as a fraction of a pixel where it bends, so smooth curves take far
+  fewer evaluations of the metric.  We emit polylines, not pixels.
+
+  The metric must be signed, i.e. negative on one side of the curve and
+  positive on the other, and smooth near the curve.  We are given its
+  gradient along with its value, so each Newton iteration evaluates it
+  once.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "viewer.h"
+#include "util.h"
+
+/* Step lengths, in pixels */
+#define TRACE_FIRST_STEP 1.0
+#define TRACE_MIN_STEP 0.25
+#define TRACE_MAX_STEP 4.0
+
+/* A corrected point is on the curve if Newton's last correction moved it
+   less than this many pixels. */
+#define TRACE_CONVERGED 0.01
+
+/* Newton iterations per step */
+#define TRACE_MAX_NEWTON 4
+
+/* The cosine of the most that the tangent may turn in one step */
+#define TRACE_MAX_TURN 0.995
+
+/* Steps per direction per branch, like conx_bres_trace_batch's limit */
+#define TRACE_MAX_STEPS 15000
+
+typedef struct Tracer {
+  ConxBatchGradient *func;
+  void *fArg;
+  ConxContinueFunc *keepgoing;
+  void *kArg;
+  double pixel;              /* the smaller of a pixel's sides */
+  size_t evaluations;
+} Tracer;
+
+static void trace_eval(Tracer *t, Pt P, double *f, double *gx, double *gy)
+/* Sets *f to the metric at P and (*gx, *gy) to its gradient there. */
+{
+  (*t->func)(&P.x, &P.y, f, gx, gy, 1, t->fArg);
+  ++t->evaluations;
+}
+
+static int trace_correct(Tracer *t, Pt *Q, double *gx, double *gy)
+/* Moves *Q onto the curve by Newton's method, leaving the gradient at the
+   last point evaluated in (*gx, *gy).  Returns nonzero on success. */
+{
+  double f, g2, c;
+  int k;
+
+  for (k = 0; k < TRACE_MAX_NEWTON; k++) {
+    trace_eval(t, *Q, &f, gx, gy);
+    g2 = sqr(*gx) + sqr(*gy);
+    if (!(g2 > 0.0) || f != f) return 0;
+    c = f / g2;
+    Q->x -= c * *gx;
+    Q->y -= c * *gy;
+    if (myabs(c) * sqrt(g2) < TRACE_CONVERGED * t->pixel) return 1;
+  }
+  return 0;
+}
+
+static int trace_tangent(double gx, double gy, double tx, double ty,
+                         double *ux, double *uy)
+/* Sets (*ux, *uy) to the unit tangent perpendicular to (gx, gy) that
+   points the same way as (tx, ty).  Returns zero if the gradient
+   vanishes. */
+{
+  double g = sqrt(sqr(gx) + sqr(gy));
+
+  if (!(g > 0.0)) return 0;
+  *ux = -gy / g;
+  *uy = gx / g;
+  if (*ux * tx + *uy * ty < 0.0) {
+    *ux = -*ux;
+    *uy = -*uy;
+  }
+  return 1;
+}
+
+static int trace_direction(Tracer *t, Pt start, double tx, double ty,
+                           ConxPtBuffer *out)
+/* Appends to *out the points of the curve reached by stepping from start,
+   which is on the curve, with initial unit tangent (tx, ty).  Returns
+   nonzero if the curve closed up, in which case start is the last point
+   appended. */
+{
+  Pt P = start, Q;
+  double h = TRACE_FIRST_STEP * t->pixel, travelled = 0.0;
+  double gx, gy, ux, uy, moved;
+  size_t steps;
+
+  for (steps = 0; steps < TRACE_MAX_STEPS; steps++) {
+    Q.x = P.x + h * tx;
+    Q.y = P.y + h * ty;
+    if (!trace_correct(t, &Q, &gx, &gy)
+        || !trace_tangent(gx, gy, tx, ty, &ux, &uy)) {
+      if (h > TRACE_MIN_STEP * t->pixel) {
+        h /= 2;
+        continue;
+      }
+      return 0;
+    }
+    if ((ux * tx + uy * ty < TRACE_MAX_TURN
+         || sqrt(sqr(Q.x - P.x - h * tx) + sqr(Q.y - P.y - h * ty)) > h / 2)
+        && h > TRACE_MIN_STEP * t->pixel) {
+      /* The curve bends too sharply or we jumped to another part of it.
+         At the shortest step, we go on regardless. */
+      h /= 2;
+      continue;
+    }
+    if (!(*t->keepgoing)(Q, P, t->kArg)) return 0;
+    moved = sqrt(sqr(Q.x - P.x) + sqr(Q.y - P.y));
+    travelled += moved;
+    if (travelled > 4.0 * h
+        && sqrt(sqr(Q.x - start.x) + sqr(Q.y - start.y)) < moved) {
+      conx_ptbuf_append(start.x, start.y, out);
+      return 1;
+    }
+    conx_ptbuf_append(Q.x, Q.y, out);
+    P = Q;
+    tx = ux;
+    ty = uy;
+    if (h < TRACE_MAX_STEP * t->pixel) h *= 1.5;
+  }
+  return 0;
+}
+
+static void trace_branch(Tracer *t, Pt seed,
+                         ConxPolylineFunc *lfunc, void *lArg)
+/* Traces the branch of the curve through (or near) seed both ways. */
+{
+  ConxPtBuffer ahead, behind;
+  Pt *pts;
+  double gx, gy, ux, uy;
+  size_t i, n;
+
+  if (!trace_correct(t, &seed, &gx, &gy)) return;
+  if (!trace_tangent(gx, gy, -gy, gx, &ux, &uy)) return;
+  conx_ptbuf_init(&ahead);
+  conx_ptbuf_init(&behind);
+  if (!trace_direction(t, seed, ux, uy, &ahead))
+    (void) trace_direction(t, seed, -ux, -uy, &behind);
+
+  /* behind, reversed, then seed, then ahead */
+  n = behind.n + 1 + ahead.n;
+  pts = (Pt *) malloc(n * sizeof(Pt));
+  CHECK_OOM(pts, "trace_branch");
+  for (i = 0; i < behind.n; i++)
+    pts[i] = behind.pts[behind.n - 1 - i];
+  pts[behind.n] = seed;
+  for (i = 0; i < ahead.n; i++)
+    pts[behind.n + 1 + i] = ahead.pts[i];
+  if (n > 1) (*lfunc)(pts, n, lArg);
+  free(pts);
+  conx_ptbuf_free(&ahead);
+  conx_ptbuf_free(&behind);
+}
+
+size_t conx_trace(Pt LB, Pt RB, ConxBatchGradient *func, void *fArg,
+                  double delta_x, double delta_y,
+                  ConxContinueFunc *keepgoing, void *kArg,
+                  ConxPolylineFunc *lfunc, void *lArg)
+/* Calls (*lfunc)(pts, n, lArg) with a polyline through each branch of the
+   curve on which the metric of *func is zero.  As with
+   conx_bresenham_batch, LB and RB are points on (or near) the left and
+   right branches, the same point iff the curve has one branch, and we stop
+   following a branch where (*keepgoing)(new, old, kArg) returns zero.  A
+   closed branch's polyline ends where it began.
+
+   Returns the number of points at which *func was evaluated.
+*/
+{
+  Tracer t;
+
+  assert(func != NULL); assert(keepgoing != NULL); assert(lfunc != NULL);
+  t.func = func;
+  t.fArg = fArg;
+  t.keepgoing = keepgoing;
+  t.kArg = kArg;
+  t.pixel = lesser(delta_x, delta_y);
+  t.evaluations = 0;
+  if (!(t.pixel > 0.0)) return 0;
+  trace_branch(&t, LB, lfunc, lArg);
+  if (LB.x != RB.x || LB.y != RB.y)
+    trace_branch(&t, RB, lfunc, lArg);
+  return t.evaluations;
+}
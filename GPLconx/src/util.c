@@ -174,3 +174,13 @@ int conx_file_exists(const char *fn)
   */
 }
 
+int conx_num_processors(void)
+/* Returns the number of processors that are online, or 1 if we cannot
+   tell. */
+{
+#if defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n > 0) return (int) n;
+#endif
+  return 1;
+}
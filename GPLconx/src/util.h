@@ -142,6 +142,7 @@ int conx_prefix_streq(const char *whole, const char *maybe, size_t n,
     { (void) fprintf(stderr, "\n\n\nConx: Fatal Error `%s'\n", st); abort(); }
 
 int conx_file_exists(const char *fn);
+int conx_num_processors(void);
 
 #ifdef __cplusplus
 }
@@ -105,9 +105,35 @@ void conxhm_ktopAB(Pt, Pt *);
 void conxhm_ptokAB(Pt, Pt *);
 double conxk_distAB(Pt, Pt);
 double conxk_dist(double x, double y, double xx, double yy);
+void conxk_dist_batch(double x, double y, const double *xx,
+                      const double *yy, double *d, size_t n);
+void conxk_dist_batchf(double x, double y, const double *xx,
+                       const double *yy, double *d, size_t n);
+void conxk_dist_batchff(double x, double y, const double *xx,
+                        const double *yy, float *d, size_t n);
 double conxpd_distAB(Pt A, Pt B);
 void conxk_getPtNearXonmb(Pt X, double m, double b, Pt *A, double computol);
 double conxk_distFrommbX(double m, double b, Pt X, double computol);
+double conxk_distmb(double m, double b, double x, double y);
+void conxk_dist_grad(double ax, double ay, double x, double y,
+                     double *d, double *gx, double *gy);
+void conxk_distmb_grad(double m, double b, double x, double y,
+                       double *d, double *gx, double *gy);
+int conxhm_toh(ConxModlType modl, double x, double y, double *h);
+void conxhm_fromh(const double *h, ConxModlType modl, double *x, double *y);
+void conxhm_toh_batch(ConxModlType modl, const double *x, const double *y,
+                      double *X, double *Y, double *T, size_t n);
+double conxh_dist(const double *a, const double *b);
+void conxh_dist_batch(const double *a, const double *X, const double *Y,
+                      const double *T, double *d, size_t n);
+void conxh_dist_clamp_batch(const double *a, const double *X,
+                            const double *Y, const double *T, double *d,
+                            size_t n, double lo, double hi);
+int conxh_pole(const double *a, const double *b, double *n);
+int conxk_polemb(double m, double b, double *n);
+double conxh_distline(const double *n, const double *h);
+int conxhm_tok_jacobian(ConxModlType modl, double x, double y,
+                        double *kx, double *ky, double J[4]);
 /*void getendptsCr(Pt C, double r, Pt *enda, Pt *endb); doesn't work DLC */
 double conxpd_distFromcX(double cx, double cy, Pt X, double computol);
 double conxp_distFromarX(double a, double r, Pt X, double computol);
@@ -115,6 +141,18 @@ void conxhm_ktop(double px, double py, double *kx, double *ky);
 void conxhm_ptok(double kx, double ky, double *px, double *py);
 void conxhm_ktopd(double u, double v, double *x, double *y);
 void conxhm_pdtok(double x, double y, double *u, double *v);
+void conxhm_ptok_batch(const double *x, const double *y, double *u,
+                       double *v, size_t n);
+void conxhm_pdtok_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n);
+void conxhm_ktop_batch(const double *x, const double *y, double *u,
+                       double *v, size_t n);
+void conxhm_ktopd_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n);
+void conxhm_pdtop_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n);
+void conxhm_ptopd_batch(const double *x, const double *y, double *u,
+                        double *v, size_t n);
 void conxhm_pdtop(double x, double y, double *u, double *v);
 void conxhm_pdtopAB(Pt P, Pt *K);
 void conxhm_ktopdAB(Pt P, Pt *K);
@@ -144,18 +182,173 @@ void conxhm_p_getEQstarted(Pt *LB, Pt *RB, double line_a, double line_r,
 double conxpd_getr(double cx, double cy);
 /* end of hypmath.c */
 void conx_bres_trace(Pt middle, ConxDirection last, double dw, double dh,
-                     ConxMetric *func, void *fArg, ConxContinueFunc *keepgoing,
-                     void *kArg, ConxPointFunc *pfunc, void *pArg);
+                     ConxMetric *func, void *fArg, ConxBresMemo *memo,
+                     ConxContinueFunc *keepgoing, void *kArg,
+                     ConxPointFunc *pfunc, void *pArg);
 void conx_bresenham(Pt LB, Pt RB, ConxMetric *func,
                     void *fArg, double delta_x, double delta_y,
                     ConxContinueFunc *keepgoing, void *kArg,
-                    ConxBresTraceFunc *bres_trace);
+                    ConxBresTraceFunc *bres_trace, ConxBresStats *stats);
+void conx_bres_trace_batch(Pt middle, ConxDirection last,
+                           double dw, double dh,
+                           ConxBatchMetric *func, void *fArg,
+                           ConxBresMemo *memo,
+                           ConxContinueFunc *keepgoing, void *kArg,
+                           ConxPointFunc *pfunc, void *pArg);
+void conx_bres_trace_sink(Pt middle, ConxDirection last,
+                          double dw, double dh,
+                          ConxBatchMetric *func, void *fArg,
+                          ConxBresMemo *memo,
+                          ConxContinueFunc *keepgoing, void *kArg,
+                          ConxVertexSink *sink);
+void conx_bresenham_batch(Pt LB, Pt RB, ConxBatchMetric *func,
+                          void *fArg, double delta_x, double delta_y,
+                          ConxContinueFunc *keepgoing, void *kArg,
+                          ConxBatchBresTraceFunc *bres_trace,
+                          ConxBresStats *stats);
+void conx_bresenham_threaded(Pt LB, Pt RB, ConxBatchMetric *func,
+                             void **fArgs, size_t nthreads,
+                             double delta_x, double delta_y,
+                             ConxContinueFunc *keepgoing, void *kArg,
+                             ConxVertexSink *sink, ConxBresStats *stats);
 /* end of bres2.c */
 void conx_longway(ConxMetric *test, void *fArg, ConxModlType modl,
                   double tlrance, double delta_x, double delta_y,
                   double x_min, double x_max, double y_min, double y_max,
                   ConxPointFunc *pfunc, void *pArg);
+void conx_longway_batch(ConxBatchMetric *test, void *testArg,
+                        ConxModlType modl, double tlrance,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max,
+                        ConxPointFunc *pfunc, void *pArg);
+void conx_longway_sink(ConxBatchMetric *test, void *testArg,
+                       ConxModlType modl, double tlrance,
+                       double delta_x, double delta_y,
+                       double x_min, double x_max,
+                       double y_min, double y_max,
+                       ConxVertexSink *sink);
+void conx_longway_tiled(ConxBatchMetric *test, void **testArgs,
+                        size_t nthreads, ConxModlType modl, double tlrance,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max,
+                        ConxPointFunc *pfunc, void *pArg);
 /* end of longways.c */
+typedef struct ConxPtBuffer {
+  Pt *pts;
+  size_t n, sz; /* n points are in use; there is room for sz. */
+} ConxPtBuffer;
+void conx_ptbuf_init(ConxPtBuffer *b);
+void conx_ptbuf_free(ConxPtBuffer *b);
+void conx_ptbuf_append(double x, double y, void *b);
+void conx_ptbuf_replay(const ConxPtBuffer *b, ConxPointFunc *pfunc,
+                       void *pArg);
+void conx_ptbuf_extend(const Pt *pts, size_t n, void *b);
+void conx_sink_init(ConxVertexSink *s, Pt *pts, size_t sz,
+                    ConxPolylineFunc *flush, void *fArg);
+void conx_sink_flush(ConxVertexSink *s);
+void conx_sink_vertex(double x, double y, void *s);
+void conx_sink_ptbuf(ConxVertexSink *s, const ConxPtBuffer *b);
+typedef struct ConxPointFuncAdapter {
+  ConxPointFunc *pfunc;
+  void *pArg;
+} ConxPointFuncAdapter;
+void conx_points_of_batch(const Pt *pts, size_t n, void *adapter);
+/* Appends (x, y) to the ConxVertexSink *s; this is conx_sink_vertex
+   without the function call. */
+#define CONX_SINK_VERTEX(s, px, py) \
+  do { \
+    if ((s)->n == (s)->sz) conx_sink_flush(s); \
+    (s)->pts[(s)->n].x = (px); \
+    (s)->pts[(s)->n++].y = (py); \
+  } while (0)
+/* The size of the buffer that engines taking a ConxPointFunc give the
+   ConxVertexSink through which they call it */
+#define CONX_SINK_SIZE 256
+/* end of ptbuf.c */
+typedef struct ConxMetricAdapter {
+  ConxMetric *func;
+  void *fArg;
+} ConxMetricAdapter;
+void conx_batch_of_metric(const double *x, const double *y, double *f,
+                          size_t n, void *adapter);
+/* end of metric.c */
+#define CONX_LATTICE_COORD(origin, delta, k) \
+  ((origin) + (delta) * (double) (k))
+size_t conx_lattice_columns(ConxModlType modl, double delta_x,
+                            double x_min, double x_max, size_t *i0);
+size_t conx_lattice_column(ConxModlType modl, double x, double delta_y,
+                           double y_min, double y_max, size_t *j0);
+typedef struct ConxLattice {
+  size_t ncols, maxcount;
+  double *xs;      /* xs[i] is the abscissa of column i */
+  size_t *start;   /* ys[start[i]] through ys[start[i]+count[i]-1] are */
+  size_t *count;   /* the ordinates of column i, from bottom to top */
+  double *ys;
+  double *kx, *ky; /* if not NULL, (kx[k], ky[k]) is (xs[i], ys[k]) in the
+                      Klein disk; see conx_lattice_klein */
+} ConxLattice;
+void conx_lattice_build(ConxLattice *L, ConxModlType modl,
+                        double delta_x, double delta_y,
+                        double x_min, double x_max,
+                        double y_min, double y_max);
+void conx_lattice_free(ConxLattice *L);
+size_t conx_lattice_size(const ConxLattice *L);
+void conx_lattice_klein(ConxLattice *L, ConxModlType modl);
+void conx_lattice_sample(ConxBatchMetric *field, void **fieldArgs,
+                         size_t nthreads, const ConxLattice *L, double *g);
+void conx_lattice_samplef(ConxBatchMetricF *field, void **fieldArgs,
+                          size_t nthreads, const ConxLattice *L, float *g);
+void conx_lattice_longway(ConxBatchMetric *test, void **testArgs,
+                          size_t nthreads, double tlrance,
+                          const ConxLattice *L,
+                          ConxPointFunc *pfunc, void *pArg);
+void conx_lattice_longway_sink(ConxBatchMetric *test, void **testArgs,
+                               size_t nthreads, double tlrance,
+                               const ConxLattice *L, ConxVertexSink *sink);
+void conx_lattice_longway_fused(ConxBatchMetric *test, void **testArgs,
+                                size_t ntests, size_t nthreads,
+                                const double *tlrances, const ConxLattice *L,
+                                char **hits);
+/* end of lattice.c */
+size_t conx_longway_quadtree(ConxBatchMetric *test, void *testArg,
+                             double lipschitz, ConxModlType modl,
+                             double tlrance, const ConxLattice *L,
+                             ConxPointFunc *pfunc, void *pArg);
+/* end of quadtree.c */
+void conx_contour(ConxBatchMetric *test, ConxBatchGradient *grad,
+                  void *testArg, ConxModlType modl,
+                  double delta_x, double delta_y,
+                  double x_min, double x_max, double y_min, double y_max,
+                  ConxPolylineFunc *lfunc, void *lArg);
+/* end of contour.c */
+size_t conx_trace(Pt LB, Pt RB, ConxBatchGradient *func, void *fArg,
+                  double delta_x, double delta_y,
+                  ConxContinueFunc *keepgoing, void *kArg,
+                  ConxPolylineFunc *lfunc, void *lArg);
+/* end of tracer.c */
+typedef struct ConxIsometry {
+  /* z -> (a z + b) / (conj(b) z + conj(a)) on the Poincare disk, where
+     a = ar + i ai, b = br + i bi, and |a|^2 - |b|^2 = 1 */
+  double ar, ai, br, bi;
+} ConxIsometry;
+void conx_isom_identity(ConxIsometry *g);
+void conx_isom_rotation(ConxIsometry *g, double theta);
+int conx_isom_translation(ConxIsometry *g, double px, double py);
+void conx_isom_compose(const ConxIsometry *g, const ConxIsometry *h,
+                       ConxIsometry *gh);
+void conx_isom_inverse(const ConxIsometry *g, ConxIsometry *gi);
+int conx_isom_is_identity(const ConxIsometry *g);
+void conx_isom_lorentz(const ConxIsometry *g, double M[9]);
+void conx_isom_apply_pts(const ConxIsometry *g, ConxModlType modl,
+                         const Pt *in, Pt *out, size_t n);
+/* end of isometry.c */
+size_t conx_polar(const double *F, ConxModlType modl, ConxBatchMetric *func,
+                  void *fArg, double delta_x, double delta_y,
+                  ConxContinueFunc *keepgoing, void *kArg,
+                  ConxPolylineFunc *lfunc, void *lArg);
+/* end of polar.c */
 
 
 void conxk_graphmb(double m, double b);
@@ -171,6 +364,10 @@ void conx_draw_arc(double x, double y, double r, double theta_1,
                    double theta_2, double tstp,
                    ConxPoint2DConverterFunc *converter,
                    ConxPointFunc *pfunc, void *pArg);
+void conx_draw_arc_sink(double x, double y, double r, double theta_1,
+                        double theta_2, double tstp,
+                        ConxPoint2DConverterFunc *converter,
+                        ConxVertexSink *sink);
 /* end of lines.c */
 #define FLUSH()  /* do nothing, wait until display(model) */
 